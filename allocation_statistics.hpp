@@ -0,0 +1,451 @@
+#ifndef ALLOCATION_STATISTICS_HPP
+#define ALLOCATION_STATISTICS_HPP
+
+#include <utility.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <type_traits>
+
+namespace tr::data_structures {
+
+class AllocationStatistics {
+    // A record of the allocations made through a `StatisticsAllocator`
+    // or `StatisticsResource`: bytes currently live, the high-water
+    // mark, allocation counts and a histogram of request sizes.
+    //
+    // Bucket `i` of the histogram counts requests of [2^i, 2^(i+1))
+    // bytes (bucket 0 also counts empty requests).
+    //
+    // This is not synchronised; share one between threads only
+    // behind external locking.
+
+public: // Types
+    using size_type = std::size_t;
+    using Histogram = std::array<size_type, std::numeric_limits<size_type>::digits>;
+
+public: // Construction
+    constexpr AllocationStatistics() noexcept;
+
+public: // Accessors
+    [[nodiscard]] constexpr size_type live_bytes() const noexcept;
+    [[nodiscard]] constexpr size_type peak_bytes() const noexcept;
+    [[nodiscard]] constexpr size_type num_allocations() const noexcept;
+    [[nodiscard]] constexpr size_type num_deallocations() const noexcept;
+    [[nodiscard]] constexpr size_type num_expansions() const noexcept;
+    [[nodiscard]] constexpr const Histogram& size_histogram() const noexcept;
+
+public: // Modifiers
+    void record_allocation(size_type numBytes) noexcept;
+    void record_deallocation(size_type numBytes) noexcept;
+    void record_expansion(size_type oldBytes, size_type newBytes) noexcept;
+
+    // Forget everything recorded so far, other than the live bytes.
+    void reset() noexcept;
+
+private: // Members
+    size_type   d_liveBytes;
+    size_type   d_peakBytes;
+    size_type   d_numAllocations;
+    size_type   d_numDeallocations;
+    size_type   d_numExpansions;
+    Histogram   d_sizeHistogram;
+};
+
+template <typename T, typename Allocator = std::allocator<T>>
+class StatisticsAllocator {
+    // An allocator adaptor which forwards to `Allocator` and records
+    // every allocation and deallocation in an `AllocationStatistics`.
+    // Copies and rebound copies record into the same statistics.
+    // `try_expand` is available if `Allocator` provides it.
+
+public: // Types
+    using value_type = T;
+    using size_type = typename std::allocator_traits<Allocator>::size_type;
+    using difference_type = typename std::allocator_traits<Allocator>::difference_type;
+
+    using propagate_on_container_copy_assignment =
+        typename std::allocator_traits<Allocator>::propagate_on_container_copy_assignment;
+    using propagate_on_container_move_assignment =
+        typename std::allocator_traits<Allocator>::propagate_on_container_move_assignment;
+    using propagate_on_container_swap =
+        typename std::allocator_traits<Allocator>::propagate_on_container_swap;
+    using is_always_equal = std::false_type;
+
+    template <typename U>
+    struct rebind {
+        using other = StatisticsAllocator<U,
+            typename std::allocator_traits<Allocator>::template rebind_alloc<U>>;
+    };
+
+    static constexpr bool is_monotonic = is_monotonic_v<Allocator>;
+
+public: // Construction
+    explicit StatisticsAllocator(AllocationStatistics* statistics,
+        const Allocator& alloc = Allocator{}) noexcept;
+    StatisticsAllocator(const StatisticsAllocator& other) noexcept;
+    template <typename U, typename OtherAllocator>
+    StatisticsAllocator(const StatisticsAllocator<U, OtherAllocator>& other) noexcept;
+
+public: // Assignment
+    StatisticsAllocator& operator=(const StatisticsAllocator& other) noexcept;
+
+public: // Allocation
+    [[nodiscard]] T* allocate(size_type n);
+    void deallocate(T* p, size_type n);
+
+    template <typename A = Allocator, typename = std::enable_if_t<has_try_expand_v<A>>>
+    [[nodiscard]] bool try_expand(T* p, size_type oldN, size_type newN);
+
+    template <typename U, typename... Args>
+    void construct(U* p, Args&&... args);
+    template <typename U>
+    void destroy(U* p);
+
+    [[nodiscard]] StatisticsAllocator select_on_container_copy_construction() const;
+
+public: // Capacity
+    [[nodiscard]] size_type max_size() const noexcept;
+
+public: // Accessors
+    [[nodiscard]] AllocationStatistics* statistics() const noexcept;
+    [[nodiscard]] const Allocator& underlying_allocator() const noexcept;
+
+private: // Members
+    Allocator               d_allocator;
+    AllocationStatistics*   d_statistics;
+};
+
+template <typename Upstream = std::pmr::memory_resource>
+class StatisticsResource : public std::pmr::memory_resource {
+    // A memory resource which forwards to an upstream resource (such
+    // as a `LocalBufferedResource`) and records every allocation and
+    // deallocation in its own `AllocationStatistics`.
+    //
+    // `Upstream` is the type of that resource. Naming it, rather than
+    // leaving it as a `std::pmr::memory_resource`, makes `try_expand`
+    // available if `Upstream` provides it, so that wrapping a resource
+    // doesn't turn growth in place into reallocation. The expansions
+    // are recorded like those of a `StatisticsAllocator`.
+
+public: // Types
+    using size_type = std::size_t;
+
+public: // Construction
+    explicit StatisticsResource(Upstream* upstream = std::pmr::new_delete_resource()) noexcept;
+    StatisticsResource(const StatisticsResource&) = delete;
+
+public: // Assignment
+    StatisticsResource& operator=(const StatisticsResource&) = delete;
+
+public: // Allocation
+    template <typename U = Upstream, typename = std::enable_if_t<has_resource_try_expand_v<U>>>
+    [[nodiscard]] bool try_expand(void* position, size_type oldBytes, size_type newBytes) noexcept;
+
+public: // Capacity
+    [[nodiscard]] size_type max_size() const noexcept;
+
+public: // Accessors
+    [[nodiscard]] const AllocationStatistics& statistics() const noexcept;
+    [[nodiscard]] AllocationStatistics& statistics() noexcept;
+    [[nodiscard]] Upstream* upstream_resource() const noexcept;
+
+private: // memory_resource interface
+    void* do_allocate(size_type numBytes, size_type alignment) override;
+    void do_deallocate(void* position, size_type numBytes, size_type alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+private: // Members
+    AllocationStatistics        d_statistics;
+    Upstream*                   d_upstream;
+};
+
+// =================================================================
+// INLINE DEFINITIONS
+// =================================================================
+// AllocationStatistics
+// Construction
+inline constexpr AllocationStatistics::AllocationStatistics() noexcept
+    : d_liveBytes(0u)
+    , d_peakBytes(0u)
+    , d_numAllocations(0u)
+    , d_numDeallocations(0u)
+    , d_numExpansions(0u)
+    , d_sizeHistogram{}
+{}
+
+// Accessors
+inline constexpr AllocationStatistics::size_type AllocationStatistics::live_bytes() const noexcept
+{
+    return this->d_liveBytes;
+}
+
+inline constexpr AllocationStatistics::size_type AllocationStatistics::peak_bytes() const noexcept
+{
+    return this->d_peakBytes;
+}
+
+inline constexpr AllocationStatistics::size_type AllocationStatistics::num_allocations()
+    const noexcept
+{
+    return this->d_numAllocations;
+}
+
+inline constexpr AllocationStatistics::size_type AllocationStatistics::num_deallocations()
+    const noexcept
+{
+    return this->d_numDeallocations;
+}
+
+inline constexpr AllocationStatistics::size_type AllocationStatistics::num_expansions()
+    const noexcept
+{
+    return this->d_numExpansions;
+}
+
+inline constexpr const AllocationStatistics::Histogram& AllocationStatistics::size_histogram()
+    const noexcept
+{
+    return this->d_sizeHistogram;
+}
+
+// Modifiers
+inline void AllocationStatistics::record_allocation(size_type numBytes) noexcept
+{
+    this->d_liveBytes += numBytes;
+    this->d_peakBytes = std::max(this->d_peakBytes, this->d_liveBytes);
+    ++this->d_numAllocations;
+
+    const size_type bucket = (numBytes == 0u) ? 0u
+        : std::numeric_limits<std::uint64_t>::digits - 1u - count_leading_zeros(numBytes);
+    ++this->d_sizeHistogram[bucket];
+}
+
+inline void AllocationStatistics::record_deallocation(size_type numBytes) noexcept
+{
+    assert(numBytes <= this->d_liveBytes);
+    this->d_liveBytes -= numBytes;
+    ++this->d_numDeallocations;
+}
+
+inline void AllocationStatistics::record_expansion(size_type oldBytes,
+    size_type newBytes) noexcept
+{
+    assert(oldBytes <= this->d_liveBytes);
+    this->d_liveBytes = this->d_liveBytes - oldBytes + newBytes;
+    this->d_peakBytes = std::max(this->d_peakBytes, this->d_liveBytes);
+    ++this->d_numExpansions;
+}
+
+inline void AllocationStatistics::reset() noexcept
+{
+    this->d_peakBytes = this->d_liveBytes;
+    this->d_numAllocations = 0u;
+    this->d_numDeallocations = 0u;
+    this->d_numExpansions = 0u;
+    this->d_sizeHistogram = {};
+}
+
+// StatisticsAllocator
+// Comparison
+template <typename T, typename A, typename U, typename B>
+inline bool operator==(const StatisticsAllocator<T, A>& lhs,
+    const StatisticsAllocator<U, B>& rhs) noexcept
+{
+    return lhs.statistics() == rhs.statistics()
+        && lhs.underlying_allocator() == rhs.underlying_allocator();
+}
+
+template <typename T, typename A, typename U, typename B>
+inline bool operator!=(const StatisticsAllocator<T, A>& lhs,
+    const StatisticsAllocator<U, B>& rhs) noexcept
+{
+    return !(lhs == rhs);
+}
+
+// Construction
+template <typename T, typename Allocator>
+inline StatisticsAllocator<T, Allocator>::StatisticsAllocator(AllocationStatistics* statistics,
+    const Allocator& alloc) noexcept
+    : d_allocator(alloc)
+    , d_statistics(statistics)
+{
+    assert(statistics);
+}
+
+template <typename T, typename Allocator>
+inline StatisticsAllocator<T, Allocator>::StatisticsAllocator(
+    const StatisticsAllocator& other) noexcept
+    : d_allocator(other.d_allocator)
+    , d_statistics(other.d_statistics)
+{}
+
+template <typename T, typename Allocator>
+template <typename U, typename OtherAllocator>
+inline StatisticsAllocator<T, Allocator>::StatisticsAllocator(
+    const StatisticsAllocator<U, OtherAllocator>& other) noexcept
+    : d_allocator(other.underlying_allocator())
+    , d_statistics(other.statistics())
+{}
+
+// Assignment
+template <typename T, typename Allocator>
+inline StatisticsAllocator<T, Allocator>& StatisticsAllocator<T, Allocator>::operator=(
+    const StatisticsAllocator& other) noexcept
+{
+    this->d_allocator = other.d_allocator;
+    this->d_statistics = other.d_statistics;
+    return *this;
+}
+
+// Allocation
+template <typename T, typename Allocator>
+inline T* StatisticsAllocator<T, Allocator>::allocate(size_type n)
+{
+    T* p = std::allocator_traits<Allocator>::allocate(this->d_allocator, n);
+    this->d_statistics->record_allocation(sizeof(T) * n);
+    return p;
+}
+
+template <typename T, typename Allocator>
+inline void StatisticsAllocator<T, Allocator>::deallocate(T* p, size_type n)
+{
+    std::allocator_traits<Allocator>::deallocate(this->d_allocator, p, n);
+    this->d_statistics->record_deallocation(sizeof(T) * n);
+}
+
+template <typename T, typename Allocator>
+template <typename, typename>
+inline bool StatisticsAllocator<T, Allocator>::try_expand(T* p, size_type oldN, size_type newN)
+{
+    if (!this->d_allocator.try_expand(p, oldN, newN)) return false;
+    this->d_statistics->record_expansion(sizeof(T) * oldN, sizeof(T) * newN);
+    return true;
+}
+
+template <typename T, typename Allocator>
+template <typename U, typename... Args>
+inline void StatisticsAllocator<T, Allocator>::construct(U* p, Args&&... args)
+{
+    std::allocator_traits<Allocator>::construct(this->d_allocator, p,
+        std::forward<Args>(args)...);
+}
+
+template <typename T, typename Allocator>
+template <typename U>
+inline void StatisticsAllocator<T, Allocator>::destroy(U* p)
+{
+    std::allocator_traits<Allocator>::destroy(this->d_allocator, p);
+}
+
+template <typename T, typename Allocator>
+inline StatisticsAllocator<T, Allocator>
+    StatisticsAllocator<T, Allocator>::select_on_container_copy_construction() const
+{
+    return StatisticsAllocator{this->d_statistics,
+        std::allocator_traits<Allocator>::select_on_container_copy_construction(
+            this->d_allocator)};
+}
+
+// Capacity
+template <typename T, typename Allocator>
+inline typename StatisticsAllocator<T, Allocator>::size_type
+    StatisticsAllocator<T, Allocator>::max_size() const noexcept
+{
+    return std::allocator_traits<Allocator>::max_size(this->d_allocator);
+}
+
+// Accessors
+template <typename T, typename Allocator>
+inline AllocationStatistics* StatisticsAllocator<T, Allocator>::statistics() const noexcept
+{
+    return this->d_statistics;
+}
+
+template <typename T, typename Allocator>
+inline const Allocator& StatisticsAllocator<T, Allocator>::underlying_allocator() const noexcept
+{
+    return this->d_allocator;
+}
+
+// StatisticsResource
+// Construction
+template <typename Upstream>
+inline StatisticsResource<Upstream>::StatisticsResource(Upstream* upstream) noexcept
+    : d_statistics()
+    , d_upstream(upstream)
+{
+    assert(upstream);
+}
+
+// Allocation
+template <typename Upstream>
+template <typename, typename>
+inline bool StatisticsResource<Upstream>::try_expand(void* position, size_type oldBytes,
+    size_type newBytes) noexcept
+{
+    if (!this->d_upstream->try_expand(position, oldBytes, newBytes)) return false;
+    this->d_statistics.record_expansion(oldBytes, newBytes);
+    return true;
+}
+
+// Capacity
+template <typename Upstream>
+inline typename StatisticsResource<Upstream>::size_type
+    StatisticsResource<Upstream>::max_size() const noexcept
+{
+    return std::numeric_limits<size_type>::max();
+}
+
+// Accessors
+template <typename Upstream>
+inline const AllocationStatistics& StatisticsResource<Upstream>::statistics() const noexcept
+{
+    return this->d_statistics;
+}
+
+template <typename Upstream>
+inline AllocationStatistics& StatisticsResource<Upstream>::statistics() noexcept
+{
+    return this->d_statistics;
+}
+
+template <typename Upstream>
+inline Upstream* StatisticsResource<Upstream>::upstream_resource() const noexcept
+{
+    return this->d_upstream;
+}
+
+// memory_resource interface
+template <typename Upstream>
+inline void* StatisticsResource<Upstream>::do_allocate(size_type numBytes, size_type alignment)
+{
+    void* position = this->d_upstream->allocate(numBytes, alignment);
+    this->d_statistics.record_allocation(numBytes);
+    return position;
+}
+
+template <typename Upstream>
+inline void StatisticsResource<Upstream>::do_deallocate(void* position, size_type numBytes,
+    size_type alignment)
+{
+    this->d_upstream->deallocate(position, numBytes, alignment);
+    this->d_statistics.record_deallocation(numBytes);
+}
+
+template <typename Upstream>
+inline bool StatisticsResource<Upstream>::do_is_equal(
+    const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
+
+} // close namespace tr::data_structures
+
+#endif // ALLOCATION_STATISTICS_HPP
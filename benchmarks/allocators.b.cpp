@@ -0,0 +1,648 @@
+// Benchmarks comparing `LocalBufferedResource` (and the repository's
+// other resources) with `std::allocator`, `monotonic_buffer_resource`
+// and `unsynchronized_pool_resource`.
+//
+// Each allocation pattern is a fixed script of allocations and frees
+// over `NUM_SLOTS` slots, which is run once per iteration:
+// - lifo: fixed-size blocks freed in reverse order
+// - fifo: fixed-size blocks freed in the order they were allocated
+// - random_sizes: mostly small, some large blocks freed in random order
+// - mixed_alignments: as above, with alignments from 8 to 256 bytes
+// - churn: a full set of slots, repeatedly freeing a random one and
+//   refilling it with a different size, which fragments free space
+//
+// In cross_thread, one thread allocates batches of blocks and another
+// frees them. Resources which aren't thread-safe are used behind a
+// mutex there, which is what sharing them would take.
+//
+// Throughput is reported as `items_per_second`, with one item per
+// allocation or free. Once the timed iterations are done, the
+// pattern is rerun with every operation timed on its own. Those times
+// are reported as the `p50_ns` ... `max_ns` counters, after
+// subtracting the cost of reading the clock.
+//
+// Monotonic resources get their memory back at the end of every
+// script run, and the time taken is included.
+//
+// The inline_vector benchmarks build, edit and destroy a vector of
+// strings using each allocator.
+//
+// Run with `--benchmark_format=json` or `--benchmark_out=<file>` for
+// JSON output.
+
+#include <inline_vector.hpp>
+#include <local_buffered_allocator.hpp>
+#include <local_buffered_resource.hpp>
+#include <monotonic_arena_resource.hpp>
+#include <thread_caching_pool_resource.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <numeric>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace tr;
+
+namespace {
+
+constexpr std::size_t NUM_SLOTS = 1024u;
+constexpr std::size_t FIXED_BYTES = 64u;
+constexpr std::size_t LOCAL_CAPACITY = std::size_t{512u} << 10u;
+constexpr std::size_t LATENCY_SAMPLES = 200000u;
+
+// Cross-thread batches are drained and the source's round ended this
+// often, so that monotonic resources don't grow without bound.
+constexpr std::size_t BATCHES_PER_ROUND = 64u;
+
+using Clock = std::chrono::steady_clock;
+
+// Allocation sources
+// ------------------
+// `std::allocator`, which is what containers use by default.
+// Over-aligned requests go to the aligned `operator new`, as they
+// would with `std::allocator<T>` for an over-aligned `T`.
+struct StdAllocatorSource {
+    static constexpr bool THREAD_SAFE = true;
+
+    void* allocate(std::size_t numBytes, std::size_t alignment)
+    {
+        if (alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+        {
+            return this->d_allocator.allocate(numBytes);
+        }
+        return ::operator new(numBytes, std::align_val_t{alignment});
+    }
+
+    void deallocate(void* position, std::size_t numBytes, std::size_t alignment)
+    {
+        if (alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+        {
+            this->d_allocator.deallocate(static_cast<std::byte*>(position), numBytes);
+            return;
+        }
+        ::operator delete(position, std::align_val_t{alignment});
+    }
+
+    void end_round() noexcept {}
+
+    template <typename T>
+    std::allocator<T> get_allocator() const noexcept { return {}; }
+
+    std::allocator<std::byte> d_allocator;
+};
+
+// Any memory resource. The resource lives on the heap, so that even
+// the largest local buffer doesn't end up on the stack.
+template <typename Resource>
+struct ResourceSource {
+    static constexpr bool THREAD_SAFE = false;
+
+    ResourceSource() : d_resource(std::make_unique<Resource>()) {}
+
+    void* allocate(std::size_t numBytes, std::size_t alignment)
+    {
+        return this->d_resource->allocate(numBytes, alignment);
+    }
+
+    void deallocate(void* position, std::size_t numBytes, std::size_t alignment)
+    {
+        this->d_resource->deallocate(position, numBytes, alignment);
+    }
+
+    void end_round() noexcept {}
+
+    template <typename T>
+    data_structures::LocalBufferedAllocator<T, Resource> get_allocator() const noexcept
+    {
+        return {this->d_resource.get()};
+    }
+
+    std::unique_ptr<Resource> d_resource;
+};
+
+// A `monotonic_buffer_resource` given an initial buffer the same size
+// as `LocalBufferedSource`'s, which is how it would be set up to
+// replace it.
+struct BufferedMonotonicResource : std::pmr::monotonic_buffer_resource {
+    BufferedMonotonicResource()
+        : std::pmr::monotonic_buffer_resource(d_buffer, sizeof(d_buffer))
+    {}
+
+    alignas(std::max_align_t) std::byte d_buffer[LOCAL_CAPACITY];
+};
+
+struct MonotonicBufferSource : ResourceSource<BufferedMonotonicResource> {
+    void end_round() noexcept { this->d_resource->release(); }
+
+    template <typename T>
+    std::pmr::polymorphic_allocator<T> get_allocator() const noexcept
+    {
+        return this->d_resource.get();
+    }
+};
+
+struct UnsynchronizedPoolSource : ResourceSource<std::pmr::unsynchronized_pool_resource> {
+    template <typename T>
+    std::pmr::polymorphic_allocator<T> get_allocator() const noexcept
+    {
+        return this->d_resource.get();
+    }
+};
+
+using LocalBufferedSource =
+    ResourceSource<data_structures::LocalBufferedResource<LOCAL_CAPACITY>>;
+
+struct MonotonicArenaSource : ResourceSource<data_structures::MonotonicArenaResource> {
+    void end_round() noexcept { this->d_resource->release(); }
+};
+
+struct ThreadCachingPoolSource : ResourceSource<data_structures::ThreadCachingPoolResource> {
+    static constexpr bool THREAD_SAFE = true;
+};
+
+// Shares a source which isn't thread-safe by taking a lock around it.
+template <typename Source>
+struct LockedSource {
+    static constexpr bool THREAD_SAFE = true;
+
+    void* allocate(std::size_t numBytes, std::size_t alignment)
+    {
+        std::lock_guard<std::mutex> lock{this->d_mutex};
+        return this->d_source.allocate(numBytes, alignment);
+    }
+
+    void deallocate(void* position, std::size_t numBytes, std::size_t alignment)
+    {
+        std::lock_guard<std::mutex> lock{this->d_mutex};
+        this->d_source.deallocate(position, numBytes, alignment);
+    }
+
+    void end_round() noexcept
+    {
+        std::lock_guard<std::mutex> lock{this->d_mutex};
+        this->d_source.end_round();
+    }
+
+    Source      d_source;
+    std::mutex  d_mutex;
+};
+
+// Scripts
+// -------
+struct Operation {
+    std::uint32_t   d_slot;
+    std::uint32_t   d_bytes;
+    std::uint32_t   d_alignment;
+    bool            d_allocate;
+};
+
+using Script = std::vector<Operation>;
+
+// Mostly small blocks, with a tail of larger ones.
+std::uint32_t random_size(std::mt19937& random)
+{
+    const std::uint32_t kind = random() % 100u;
+    if (kind < 80u) return 8u + random() % 121u;
+    if (kind < 98u) return 128u + random() % 897u;
+    return 1024u + random() % 7169u;
+}
+
+std::uint32_t random_alignment(std::mt19937& random)
+{
+    return std::uint32_t{8u} << (random() % 6u);
+}
+
+// Allocate every slot with the given sizes, then free them in `order`.
+Script allocate_then_free(const std::vector<Operation>& blocks,
+    const std::vector<std::uint32_t>& order)
+{
+    Script script = blocks;
+    for (std::uint32_t slot : order)
+    {
+        Operation operation = blocks[slot];
+        operation.d_allocate = false;
+        script.push_back(operation);
+    }
+    return script;
+}
+
+std::vector<Operation> fixed_blocks()
+{
+    std::vector<Operation> blocks;
+    for (std::uint32_t slot = 0u; slot < NUM_SLOTS; ++slot)
+    {
+        blocks.push_back({slot, FIXED_BYTES, alignof(std::max_align_t), true});
+    }
+    return blocks;
+}
+
+std::vector<Operation> random_blocks(std::mt19937& random, bool mixAlignments)
+{
+    std::vector<Operation> blocks;
+    for (std::uint32_t slot = 0u; slot < NUM_SLOTS; ++slot)
+    {
+        const std::uint32_t alignment = mixAlignments ?
+            random_alignment(random) : alignof(std::max_align_t);
+        blocks.push_back({slot, random_size(random), alignment, true});
+    }
+    return blocks;
+}
+
+std::vector<std::uint32_t> slot_order(std::mt19937* shuffle, bool reverse)
+{
+    std::vector<std::uint32_t> order(NUM_SLOTS);
+    std::iota(order.begin(), order.end(), 0u);
+    if (reverse) std::reverse(order.begin(), order.end());
+    if (shuffle) std::shuffle(order.begin(), order.end(), *shuffle);
+    return order;
+}
+
+Script lifo_script()
+{
+    return allocate_then_free(fixed_blocks(), slot_order(nullptr, true));
+}
+
+Script fifo_script()
+{
+    return allocate_then_free(fixed_blocks(), slot_order(nullptr, false));
+}
+
+Script random_sizes_script()
+{
+    std::mt19937 random{1u};
+    return allocate_then_free(random_blocks(random, false), slot_order(&random, false));
+}
+
+Script mixed_alignments_script()
+{
+    std::mt19937 random{2u};
+    return allocate_then_free(random_blocks(random, true), slot_order(&random, false));
+}
+
+Script churn_script()
+{
+    std::mt19937 random{3u};
+    std::vector<Operation> live = random_blocks(random, false);
+    Script script = live;
+    for (std::size_t i = 0u; i < 4u * NUM_SLOTS; ++i)
+    {
+        Operation& block = live[random() % NUM_SLOTS];
+        script.push_back({block.d_slot, block.d_bytes, block.d_alignment, false});
+        block.d_bytes = random_size(random);
+        script.push_back(block);
+    }
+    for (const Operation& block : live)
+    {
+        script.push_back({block.d_slot, block.d_bytes, block.d_alignment, false});
+    }
+    return script;
+}
+
+// Latencies
+// ---------
+// The smallest gap seen between two reads of the clock.
+std::int64_t clock_overhead()
+{
+    static const std::int64_t overhead = [] {
+        std::int64_t least = std::numeric_limits<std::int64_t>::max();
+        for (int i = 0; i < 1000; ++i)
+        {
+            const Clock::time_point start = Clock::now();
+            least = std::min<std::int64_t>(least, (Clock::now() - start).count());
+        }
+        return least;
+    }();
+    return overhead;
+}
+
+template <typename Function>
+void record_latency(std::vector<std::int64_t>& latencies, Function function)
+{
+    const Clock::time_point start = Clock::now();
+    function();
+    const Clock::time_point end = Clock::now();
+    latencies.push_back(std::max<std::int64_t>(0,
+        std::chrono::nanoseconds{end - start}.count() - clock_overhead()));
+}
+
+void report_latencies(benchmark::State& state, std::vector<std::int64_t>& latencies)
+{
+    if (latencies.empty()) return;
+
+    std::sort(latencies.begin(), latencies.end());
+    const auto percentile = [&latencies](double fraction) {
+        const std::size_t index = static_cast<std::size_t>(fraction * (latencies.size() - 1u));
+        return static_cast<double>(latencies[index]);
+    };
+    state.counters["p50_ns"] = percentile(0.5);
+    state.counters["p90_ns"] = percentile(0.9);
+    state.counters["p99_ns"] = percentile(0.99);
+    state.counters["p999_ns"] = percentile(0.999);
+    state.counters["max_ns"] = static_cast<double>(latencies.back());
+}
+
+// Patterns
+// --------
+template <bool Timed, typename Source>
+void run_script(Source& source, const Script& script, std::vector<void*>& slots,
+    std::vector<std::int64_t>& latencies)
+{
+    for (const Operation& operation : script)
+    {
+        void*& slot = slots[operation.d_slot];
+        const auto apply = [&] {
+            if (operation.d_allocate)
+            {
+                slot = source.allocate(operation.d_bytes, operation.d_alignment);
+            }
+            else
+            {
+                source.deallocate(slot, operation.d_bytes, operation.d_alignment);
+            }
+        };
+
+        if constexpr (Timed)
+        {
+            record_latency(latencies, apply);
+        }
+        else
+        {
+            apply();
+            benchmark::DoNotOptimize(slot);
+        }
+    }
+    source.end_round();
+}
+
+template <typename Source>
+void pattern(benchmark::State& state, Script (*make_script)())
+{
+    const Script script = make_script();
+    std::vector<void*> slots(NUM_SLOTS);
+    std::vector<std::int64_t> latencies;
+    Source source;
+
+    for (auto _ : state)
+    {
+        run_script<false>(source, script, slots, latencies);
+    }
+    state.SetItemsProcessed(state.iterations() * script.size());
+
+    latencies.reserve(LATENCY_SAMPLES + script.size());
+    while (latencies.size() < LATENCY_SAMPLES)
+    {
+        run_script<true>(source, script, slots, latencies);
+    }
+    report_latencies(state, latencies);
+}
+
+// Frees, on a thread of its own, the batches of blocks handed to it.
+// Batches alternate between two buffers: batch `n` is only filled
+// once batch `n - 2` has been freed.
+template <typename Source>
+class CrossThreadFreer {
+public:
+    CrossThreadFreer(Source& source, const std::vector<std::uint32_t>& sizes)
+        : d_source(source)
+        , d_sizes(sizes)
+        , d_batches{std::vector<void*>(sizes.size()), std::vector<void*>(sizes.size())}
+        , d_timed{false, false}
+        , d_freeLatencies()
+        , d_published(0u)
+        , d_freed(0u)
+        , d_stop(false)
+        , d_thread([this] { this->free_batches(); })
+    {}
+
+    ~CrossThreadFreer()
+    {
+        this->d_stop.store(true, std::memory_order_release);
+        this->d_thread.join();
+    }
+
+    // Allocate the next batch and hand it over to be freed.
+    template <bool Timed>
+    void send_batch(std::vector<std::int64_t>& latencies)
+    {
+        const std::size_t batch = this->d_published.load(std::memory_order_relaxed) + 1u;
+        while (this->d_freed.load(std::memory_order_acquire) + 2u < batch)
+        {
+            std::this_thread::yield();
+        }
+
+        std::vector<void*>& blocks = this->d_batches[batch % 2u];
+        for (std::size_t i = 0u; i < blocks.size(); ++i)
+        {
+            const auto allocate = [&] {
+                blocks[i] = this->d_source.allocate(this->d_sizes[i], alignof(std::max_align_t));
+            };
+            if constexpr (Timed) record_latency(latencies, allocate);
+            else allocate();
+        }
+        this->d_timed[batch % 2u] = Timed;
+        this->d_published.store(batch, std::memory_order_release);
+
+        if (batch % BATCHES_PER_ROUND == 0u)
+        {
+            this->wait_until_freed();
+            this->d_source.end_round();
+        }
+    }
+
+    void wait_until_freed()
+    {
+        while (this->d_freed.load(std::memory_order_acquire)
+            != this->d_published.load(std::memory_order_relaxed))
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    // The free latencies recorded so far. Only read after `wait_until_freed`.
+    std::vector<std::int64_t>& free_latencies() noexcept { return this->d_freeLatencies; }
+
+private:
+    void free_batches()
+    {
+        for (std::size_t batch = 1u; ; ++batch)
+        {
+            while (this->d_published.load(std::memory_order_acquire) < batch)
+            {
+                if (this->d_stop.load(std::memory_order_acquire)) return;
+                std::this_thread::yield();
+            }
+
+            const bool timed = this->d_timed[batch % 2u];
+            std::vector<void*>& blocks = this->d_batches[batch % 2u];
+            for (std::size_t i = 0u; i < blocks.size(); ++i)
+            {
+                const auto deallocate = [&] {
+                    this->d_source.deallocate(blocks[i], this->d_sizes[i],
+                        alignof(std::max_align_t));
+                };
+                if (timed) record_latency(this->d_freeLatencies, deallocate);
+                else deallocate();
+            }
+            this->d_freed.store(batch, std::memory_order_release);
+        }
+    }
+
+    Source&                             d_source;
+    const std::vector<std::uint32_t>&   d_sizes;
+    std::vector<void*>                  d_batches[2];
+    bool                                d_timed[2];     // Whether to time freeing each batch
+    std::vector<std::int64_t>           d_freeLatencies;
+    std::atomic<std::size_t>            d_published;
+    std::atomic<std::size_t>            d_freed;
+    std::atomic<bool>                   d_stop;
+    std::thread                         d_thread;
+};
+
+template <typename Source>
+void cross_thread(benchmark::State& state)
+{
+    std::mt19937 random{4u};
+    std::vector<std::uint32_t> sizes(NUM_SLOTS);
+    std::generate(sizes.begin(), sizes.end(), [&random] { return random_size(random); });
+
+    Source source;
+    std::vector<std::int64_t> latencies;
+    {
+        CrossThreadFreer<Source> freer{source, sizes};
+        for (auto _ : state)
+        {
+            freer.template send_batch<false>(latencies);
+        }
+        freer.wait_until_freed();
+        state.SetItemsProcessed(state.iterations() * 2u * NUM_SLOTS);
+
+        latencies.reserve(LATENCY_SAMPLES / 2u + NUM_SLOTS);
+        while (latencies.size() < LATENCY_SAMPLES / 2u)
+        {
+            freer.template send_batch<true>(latencies);
+        }
+        freer.wait_until_freed();
+
+        const std::vector<std::int64_t>& freeLatencies = freer.free_latencies();
+        latencies.insert(latencies.end(), freeLatencies.begin(), freeLatencies.end());
+    }
+    source.end_round();
+    report_latencies(state, latencies);
+}
+
+// inline_vector
+// -------------
+// Push a few hundred short strings, then erase and insert in the middle.
+template <typename Source>
+void inline_vector_workload(benchmark::State& state)
+{
+    constexpr std::size_t NUM_RANGES = 256u;
+    constexpr std::size_t NUM_EDITS = 64u;
+
+    std::mt19937 random{5u};
+    std::string text(4096u, ' ');
+    std::generate(text.begin(), text.end(), [&random] { return 'a' + random() % 26u; });
+
+    struct Edit { std::size_t d_offset, d_length, d_position; };
+    std::vector<Edit> edits(NUM_RANGES + 2u * NUM_EDITS);
+    for (std::size_t i = 0u; i < edits.size(); ++i)
+    {
+        const std::size_t length = 1u + random() % 64u;
+        edits[i] = {random() % (text.size() - length), length,
+            random() % (NUM_RANGES - NUM_EDITS)};
+    }
+
+    Source source;
+    using Vector = data_structures::inline_vector<char,
+        decltype(source.template get_allocator<char>())>;
+
+    for (auto _ : state)
+    {
+        {
+            Vector vec{source.template get_allocator<char>()};
+            const Edit* edit = edits.data();
+            for (std::size_t i = 0u; i < NUM_RANGES; ++i, ++edit)
+            {
+                vec.push_back_range({text.data() + edit->d_offset, edit->d_length});
+            }
+            for (std::size_t i = 0u; i < NUM_EDITS; ++i, ++edit)
+            {
+                vec.erase_range(vec.begin() + edit->d_position);
+            }
+            for (std::size_t i = 0u; i < NUM_EDITS; ++i, ++edit)
+            {
+                vec.insert_range(vec.begin() + edit->d_position,
+                    {text.data() + edit->d_offset, edit->d_length});
+            }
+            benchmark::DoNotOptimize(vec);
+        }
+        source.end_round();
+    }
+    state.SetItemsProcessed(state.iterations() * (NUM_RANGES + 2u * NUM_EDITS));
+}
+
+// Registration
+// ------------
+template <typename Source>
+void register_source(const std::string& name)
+{
+    const std::pair<const char*, Script (*)()> patterns[] = {
+        {"lifo", lifo_script},
+        {"fifo", fifo_script},
+        {"random_sizes", random_sizes_script},
+        {"mixed_alignments", mixed_alignments_script},
+        {"churn", churn_script},
+    };
+    for (const auto& [patternName, makeScript] : patterns)
+    {
+        benchmark::RegisterBenchmark((std::string{patternName} + "/" + name).c_str(),
+            [makeScript = makeScript](benchmark::State& state) {
+                pattern<Source>(state, makeScript);
+            })->Unit(benchmark::kMicrosecond);
+    }
+
+    if constexpr (Source::THREAD_SAFE)
+    {
+        benchmark::RegisterBenchmark(("cross_thread/" + name).c_str(),
+            cross_thread<Source>)->Unit(benchmark::kMicrosecond)->UseRealTime();
+    }
+    else
+    {
+        benchmark::RegisterBenchmark(("cross_thread/" + name + "_locked").c_str(),
+            cross_thread<LockedSource<Source>>)->Unit(benchmark::kMicrosecond)->UseRealTime();
+    }
+
+    benchmark::RegisterBenchmark(("inline_vector/" + name).c_str(),
+        inline_vector_workload<Source>)->Unit(benchmark::kMicrosecond);
+}
+
+} // close anonymous namespace
+
+int main(int argc, char** argv)
+{
+    register_source<StdAllocatorSource>("std_allocator");
+    register_source<MonotonicBufferSource>("monotonic_buffer_resource");
+    register_source<UnsynchronizedPoolSource>("unsynchronized_pool_resource");
+    register_source<LocalBufferedSource>("local_buffered_resource");
+    register_source<MonotonicArenaSource>("monotonic_arena_resource");
+    register_source<ThreadCachingPoolSource>("thread_caching_pool_resource");
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
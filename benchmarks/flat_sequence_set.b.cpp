@@ -0,0 +1,392 @@
+// Benchmarks comparing `flat_sequence_set<char>` with the usual ways of
+// keeping a set of strings: `std::set`, `std::unordered_set` and a
+// sorted `std::vector`.
+//
+// Each container is measured on bulk construction, one-at-a-time
+// insertion, point lookups which hit and which miss, ordered iteration
+// and memory per key, from 1K keys up to `--max_keys` (1M by default,
+// 100M is supported given the memory). Inserting one at a time into the
+// sorted containers is quadratic, so it stops at `--max_insert_keys`.
+//
+// The keys are random lowercase strings whose lengths follow a
+// log-normal distribution (median 20, clamped to [8, 200]), much like
+// identifiers, paths or URLs. Each ends with a fixed-width base-36
+// index, which keeps them unique and lets misses be generated that are
+// guaranteed not to be in the set.
+//
+// Run with `--benchmark_format=json` or `--benchmark_out=<file>` to get
+// JSON which can be compared across runs (for example with Google
+// Benchmark's `compare.py`).
+
+#include <allocation_statistics.hpp>
+#include <flat_sequence_set.hpp>
+#include <inline_vector.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory_resource>
+#include <random>
+#include <set>
+#include <string>
+#include <type_traits>
+#include <unordered_set>
+#include <vector>
+
+using namespace tr;
+
+namespace {
+
+using Keys = std::vector<std::string>;
+
+constexpr std::size_t MIN_KEYS = 1000u;
+constexpr std::size_t SUFFIX_DIGITS = 6u;
+constexpr std::size_t LOOKUP_BATCH = 4096u;
+
+std::size_t g_maxKeys = 1000000u;
+std::size_t g_maxInsertKeys = 100000u;
+
+std::string make_key(std::mt19937_64& random, std::size_t index)
+{
+    std::lognormal_distribution<double> length{std::log(20.0), 0.6};
+    std::uniform_int_distribution<int> letter{'a', 'z'};
+
+    const std::size_t numBytes = std::clamp<std::size_t>(
+        static_cast<std::size_t>(length(random)), 8u, 200u);
+    std::string key(numBytes, ' ');
+    std::generate_n(key.begin(), numBytes - SUFFIX_DIGITS,
+        [&] { return static_cast<char>(letter(random)); });
+    for (std::size_t i = 0u; i < SUFFIX_DIGITS; ++i, index /= 36u)
+    {
+        key[numBytes - 1u - i] = "0123456789abcdefghijklmnopqrstuvwxyz"[index % 36u];
+    }
+    return key;
+}
+
+// The keys to put in the sets, in random order, made once per size.
+const Keys& present_keys(std::size_t numKeys)
+{
+    static std::map<std::size_t, Keys> cache;
+    Keys& keys = cache[numKeys];
+    if (keys.empty())
+    {
+        std::mt19937_64 random{numKeys};
+        keys.reserve(numKeys);
+        for (std::size_t i = 0u; i < numKeys; ++i)
+        {
+            keys.push_back(make_key(random, i));
+        }
+    }
+    return keys;
+}
+
+// Keys which are not in the set of `numKeys` keys, in random order.
+const Keys& absent_keys(std::size_t numKeys)
+{
+    static std::map<std::size_t, Keys> cache;
+    Keys& keys = cache[numKeys];
+    if (keys.empty())
+    {
+        const std::size_t numLookups = std::min(numKeys, std::size_t{1u} << 20u);
+        std::mt19937_64 random{~numKeys};
+        keys.reserve(numLookups);
+        for (std::size_t i = 0u; i < numLookups; ++i)
+        {
+            keys.push_back(make_key(random, numKeys + i));
+        }
+    }
+    return keys;
+}
+
+data_structures::span<const char> as_span(const std::string& key)
+{
+    return {key.data(), key.size()};
+}
+
+// The same operations on each container. `Pmr` swaps in the
+// polymorphic allocator, so that memory use can be recorded.
+template <bool Pmr>
+struct StdSet {
+    using string = std::conditional_t<Pmr, std::pmr::string, std::string>;
+    using type = std::conditional_t<Pmr, std::pmr::set<string>, std::set<string>>;
+
+    template <typename... Alloc>
+    static type build(const Keys& keys, const Alloc&... alloc)
+    {
+        type set{alloc...};
+        for (const std::string& key : keys) set.emplace(key);
+        return set;
+    }
+
+    static void insert(type& set, const std::string& key) { set.emplace(key); }
+
+    static bool contains(const type& set, const std::string& key)
+    {
+        return set.find(key) != set.end();
+    }
+};
+
+template <bool Pmr>
+struct StdUnorderedSet {
+    using string = std::conditional_t<Pmr, std::pmr::string, std::string>;
+    using type = std::conditional_t<Pmr, std::pmr::unordered_set<string>,
+        std::unordered_set<string>>;
+
+    template <typename... Alloc>
+    static type build(const Keys& keys, const Alloc&... alloc)
+    {
+        type set{alloc...};
+        set.reserve(keys.size());
+        for (const std::string& key : keys) set.emplace(key);
+        return set;
+    }
+
+    static void insert(type& set, const std::string& key) { set.emplace(key); }
+
+    static bool contains(const type& set, const std::string& key)
+    {
+        return set.find(key) != set.end();
+    }
+};
+
+template <bool Pmr>
+struct SortedVector {
+    using string = std::conditional_t<Pmr, std::pmr::string, std::string>;
+    using type = std::conditional_t<Pmr, std::pmr::vector<string>, std::vector<string>>;
+
+    template <typename... Alloc>
+    static type build(const Keys& keys, const Alloc&... alloc)
+    {
+        type vec{alloc...};
+        vec.reserve(keys.size());
+        for (const std::string& key : keys) vec.emplace_back(key);
+        std::sort(vec.begin(), vec.end());
+        return vec;
+    }
+
+    static void insert(type& vec, const std::string& key)
+    {
+        vec.insert(std::lower_bound(vec.begin(), vec.end(), key), key);
+    }
+
+    static bool contains(const type& vec, const std::string& key)
+    {
+        return std::binary_search(vec.begin(), vec.end(), key);
+    }
+};
+
+template <bool Pmr>
+struct FlatSequenceSet {
+    using type = std::conditional_t<Pmr, data_structures::pmr::flat_sequence_set<char>,
+        data_structures::flat_sequence_set<char>>;
+    using vector = std::conditional_t<Pmr, data_structures::pmr::inline_vector<char>,
+        data_structures::inline_vector<char>>;
+
+    // Gather the keys unsorted, then let the set sort them once.
+    template <typename... Alloc>
+    static type build(const Keys& keys, const Alloc&... alloc)
+    {
+        vector vec{alloc...};
+        vec.reserve_ranges(keys.size());
+        for (const std::string& key : keys) vec.push_back_range(as_span(key));
+        return type{{}, vec, alloc...};
+    }
+
+    static void insert(type& set, const std::string& key) { set.insert_range(as_span(key)); }
+
+    static bool contains(const type& set, const std::string& key)
+    {
+        return set.find(as_span(key)) != set.end();
+    }
+};
+
+template <template <bool> typename Container>
+void bulk_construction(benchmark::State& state)
+{
+    const Keys& keys = present_keys(state.range(0));
+    for (auto _ : state)
+    {
+        auto container = Container<false>::build(keys);
+        benchmark::DoNotOptimize(container);
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+template <template <bool> typename Container>
+void insert_one_at_a_time(benchmark::State& state)
+{
+    const Keys& keys = present_keys(state.range(0));
+    for (auto _ : state)
+    {
+        typename Container<false>::type container;
+        for (const std::string& key : keys)
+        {
+            Container<false>::insert(container, key);
+        }
+        benchmark::DoNotOptimize(container);
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+template <template <bool> typename Container>
+void lookup(benchmark::State& state, bool hit)
+{
+    const std::size_t numKeys = state.range(0);
+    const auto container = Container<false>::build(present_keys(numKeys));
+
+    const Keys& lookups = hit ? present_keys(numKeys) : absent_keys(numKeys);
+    std::size_t next = 0u;
+    std::size_t numFound = 0u;
+    for (auto _ : state)
+    {
+        numFound += Container<false>::contains(container, lookups[next]);
+        if (++next == lookups.size()) next = 0u;
+    }
+    benchmark::DoNotOptimize(numFound);
+    state.SetItemsProcessed(state.iterations());
+}
+
+// `find_batch` only exists on `flat_sequence_set`, so this has no rivals.
+void flat_sequence_set_find_batch(benchmark::State& state, bool hit)
+{
+    const std::size_t numKeys = state.range(0);
+    const auto set = FlatSequenceSet<false>::build(present_keys(numKeys));
+
+    const Keys& lookups = hit ? present_keys(numKeys) : absent_keys(numKeys);
+    std::vector<data_structures::span<const char>> keys;
+    keys.reserve(lookups.size());
+    std::transform(lookups.begin(), lookups.end(), std::back_inserter(keys), as_span);
+
+    using Iterator = FlatSequenceSet<false>::type::const_iterator;
+    std::vector<Iterator> found(LOOKUP_BATCH);
+    std::size_t next = 0u;
+    for (auto _ : state)
+    {
+        const std::size_t count = std::min(LOOKUP_BATCH, keys.size() - next);
+        set.find_batch({keys.data() + next, count}, {found.data(), count});
+        benchmark::DoNotOptimize(found.data());
+        next = (next + count == keys.size()) ? 0u : next + count;
+        state.SetItemsProcessed(state.items_processed() + count);
+    }
+}
+
+template <template <bool> typename Container>
+void ordered_iteration(benchmark::State& state)
+{
+    const auto container = Container<false>::build(present_keys(state.range(0)));
+
+    for (auto _ : state)
+    {
+        std::size_t numBytes = 0u;
+        for (const auto& key : container)
+        {
+            numBytes += key.size() + static_cast<unsigned char>(key[0u]);
+        }
+        benchmark::DoNotOptimize(numBytes);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Build the container once and report what it holds onto, next to the
+// bytes in the keys themselves. This is registered with one iteration.
+template <template <bool> typename Container>
+void memory_per_key(benchmark::State& state)
+{
+    const Keys& keys = present_keys(state.range(0));
+    std::size_t keyBytes = 0u;
+    for (const std::string& key : keys) keyBytes += key.size();
+
+    data_structures::StatisticsResource<> resource;
+    for (auto _ : state)
+    {
+        const auto container = Container<true>::build(keys, &resource);
+        benchmark::DoNotOptimize(container);
+
+        const data_structures::AllocationStatistics& statistics = resource.statistics();
+        const double numKeys = static_cast<double>(keys.size());
+        state.counters["key_bytes_per_key"] = keyBytes / numKeys;
+        state.counters["bytes_per_key"] = statistics.live_bytes() / numKeys;
+        state.counters["peak_bytes_per_key"] = statistics.peak_bytes() / numKeys;
+        state.counters["allocations_per_key"] = statistics.num_allocations() / numKeys;
+    }
+}
+
+template <typename Function>
+void register_sizes(const std::string& name, std::size_t maxKeys, Function function)
+{
+    benchmark::internal::Benchmark* benchmark =
+        benchmark::RegisterBenchmark(name.c_str(), function);
+    for (std::size_t numKeys = MIN_KEYS; numKeys <= maxKeys; numKeys *= 10u)
+    {
+        benchmark->Arg(static_cast<std::int64_t>(numKeys));
+    }
+    benchmark->Unit(benchmark::kMicrosecond);
+}
+
+template <template <bool> typename Container>
+void register_container(const std::string& name)
+{
+    register_sizes("bulk_construction/" + name, g_maxKeys, bulk_construction<Container>);
+    register_sizes("insert_one_at_a_time/" + name, g_maxInsertKeys,
+        insert_one_at_a_time<Container>);
+    register_sizes("lookup_hit/" + name, g_maxKeys, [](benchmark::State& state) {
+        lookup<Container>(state, true);
+    });
+    register_sizes("lookup_miss/" + name, g_maxKeys, [](benchmark::State& state) {
+        lookup<Container>(state, false);
+    });
+    register_sizes("ordered_iteration/" + name, g_maxKeys, ordered_iteration<Container>);
+
+    benchmark::internal::Benchmark* memory =
+        benchmark::RegisterBenchmark(("memory_per_key/" + name).c_str(),
+        memory_per_key<Container>);
+    for (std::size_t numKeys = MIN_KEYS; numKeys <= g_maxKeys; numKeys *= 10u)
+    {
+        memory->Arg(static_cast<std::int64_t>(numKeys));
+    }
+    memory->Iterations(1);
+}
+
+// Take `--name=value` out of the arguments, leaving the rest for Google Benchmark.
+void parse_size_flag(int& argc, char** argv, const char* name, std::size_t& value)
+{
+    const std::size_t length = std::strlen(name);
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strncmp(argv[i], name, length) == 0 && argv[i][length] == '=')
+        {
+            value = std::strtoull(argv[i] + length + 1, nullptr, 10);
+            std::copy(argv + i + 1, argv + argc, argv + i);
+            --argc;
+            return;
+        }
+    }
+}
+
+} // close anonymous namespace
+
+int main(int argc, char** argv)
+{
+    parse_size_flag(argc, argv, "--max_keys", g_maxKeys);
+    parse_size_flag(argc, argv, "--max_insert_keys", g_maxInsertKeys);
+
+    register_container<StdSet>("std_set");
+    register_container<StdUnorderedSet>("std_unordered_set");
+    register_container<SortedVector>("sorted_vector");
+    register_container<FlatSequenceSet>("flat_sequence_set");
+    register_sizes("lookup_hit/flat_sequence_set_find_batch", g_maxKeys,
+        [](benchmark::State& state) { flat_sequence_set_find_batch(state, true); });
+    register_sizes("lookup_miss/flat_sequence_set_find_batch", g_maxKeys,
+        [](benchmark::State& state) { flat_sequence_set_find_batch(state, false); });
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,375 @@
+#ifndef CONCURRENT_INLINE_VECTOR_HPP
+#define CONCURRENT_INLINE_VECTOR_HPP
+
+#include <span.hpp>
+#include <utility.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+
+namespace tr::data_structures {
+
+template <typename T, typename Allocator = std::allocator<T>>
+class concurrent_inline_vector : private Allocator
+{
+    // An append-only `inline_vector` which any number of threads can
+    // push ranges onto at once, while others read it, without locking.
+    //
+    // The elements and the blocks describing the ranges both live in
+    // segments which double in size, so nothing is ever relocated. A
+    // writer claims room for its elements with a compare-and-swap and
+    // a slot for its block with a `fetch_add`, copies its range in and
+    // publishes the slot. Readers visit the published slots in the
+    // order they were claimed, skipping any which are still being
+    // written.
+    //
+    // A range which would straddle two element segments is claimed
+    // from the start of the first later segment large enough to hold
+    // it, wasting only the rest of the partly used one. Segments are
+    // allocated by whichever writer needs them first, so the allocator
+    // must be thread-safe.
+
+public: // Types
+    using value_type = span<const T>;
+    using size_type = typename std::allocator_traits<Allocator>::size_type;
+    using allocator_type = Allocator;
+
+public: // Constructors
+    concurrent_inline_vector() noexcept(std::is_nothrow_default_constructible_v<Allocator>);
+    explicit concurrent_inline_vector(const Allocator& alloc) noexcept;
+    concurrent_inline_vector(const concurrent_inline_vector&) = delete;
+    ~concurrent_inline_vector();
+
+public: // Assignment
+    concurrent_inline_vector& operator=(const concurrent_inline_vector&) = delete;
+
+public: // Allocator
+    [[nodiscard]] allocator_type get_allocator() const noexcept;
+
+public: // Capacity
+    [[nodiscard]] bool empty() const noexcept;
+
+    // This returns the number of ranges which have been, or are
+    // being, appended.
+    [[nodiscard]] size_type num_ranges() const noexcept;
+
+    // This returns how much memory the segments hold. Only published
+    // ranges and their slots count as in use: the rest of every
+    // allocated segment, including room skipped by ranges which would
+    // have straddled two segments and room claimed by writers which
+    // haven't published yet, is slack. With writers active this is
+    // only a snapshot.
+    [[nodiscard]] MemoryUsage memory_usage() const noexcept;
+
+public: // Element Access
+    // Call `function` with each published range, as a `span<const T>`,
+    // in the order their slots were claimed.
+    template <typename Function>
+    void for_each_range(Function function) const;
+
+public: // Modifiers
+    // Append a copy of `range`, returning the index of its slot.
+    size_type push_back_range(span<const T> range);
+
+private: // Private Types
+    template <typename U>
+    using ReboundAlloc = typename std::allocator_traits<Allocator>::template rebind_alloc<U>;
+
+    struct Slot {
+        span<T>             d_range;
+        std::atomic<bool>   d_published;
+    };
+
+private: // Helper variables
+    static constexpr size_type FIRST_SEGMENT_SIZE = 64u;
+    static constexpr size_type NUM_SEGMENTS = 40u;
+    static constexpr size_type CACHE_LINE_SIZE = 64u;
+
+private: // Helpers
+    // Segment `k` holds `FIRST_SEGMENT_SIZE << k` entries, so the
+    // segment of any index can be found from its leading zeros.
+    [[nodiscard]] static size_type segment_of(size_type index) noexcept;
+    [[nodiscard]] static size_type segment_begin(size_type segment) noexcept;
+    [[nodiscard]] static size_type segment_size(size_type segment) noexcept;
+
+    // Return segment `segment` of `segments`, allocating it first if
+    // no other thread has yet.
+    template <typename U>
+    [[nodiscard]] U* acquire_segment(std::atomic<U*>* segments, size_type segment);
+
+    template <typename U>
+    void release_segment(U* segment, size_type segmentIndex) noexcept;
+
+    void destroy_range(span<T> range) noexcept;
+
+private: // Members
+    std::atomic<T*>                                 d_elementSegments[NUM_SEGMENTS];
+    std::atomic<Slot*>                              d_slotSegments[NUM_SEGMENTS];
+    alignas(CACHE_LINE_SIZE) std::atomic<size_type> d_numElements;
+    alignas(CACHE_LINE_SIZE) std::atomic<size_type> d_numSlots;
+};
+
+// =================================================================
+// INLINE DEFINITIONS
+// =================================================================
+
+// Constructors
+template <typename T, typename Allocator>
+inline concurrent_inline_vector<T, Allocator>::concurrent_inline_vector()
+    noexcept(std::is_nothrow_default_constructible_v<Allocator>)
+    : concurrent_inline_vector(Allocator{})
+{}
+
+template <typename T, typename Allocator>
+inline concurrent_inline_vector<T, Allocator>::concurrent_inline_vector(
+    const Allocator& alloc) noexcept
+    : Allocator(alloc)
+    , d_numElements(0u)
+    , d_numSlots(0u)
+{
+    for (size_type segment = 0u; segment < NUM_SEGMENTS; ++segment)
+    {
+        this->d_elementSegments[segment].store(nullptr, std::memory_order_relaxed);
+        this->d_slotSegments[segment].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+template <typename T, typename Allocator>
+inline concurrent_inline_vector<T, Allocator>::~concurrent_inline_vector()
+{
+    const size_type numSlots = this->d_numSlots.load(std::memory_order_acquire);
+    for (size_type segment = 0u; segment < NUM_SEGMENTS; ++segment)
+    {
+        Slot* slots = this->d_slotSegments[segment].load(std::memory_order_acquire);
+        if (!slots) continue;
+
+        const size_type numUsed = std::min(segment_size(segment),
+            numSlots - std::min(numSlots, segment_begin(segment)));
+        std::for_each(slots, slots + numUsed, [this](Slot& slot) noexcept {
+            if (slot.d_published.load(std::memory_order_acquire))
+            {
+                this->destroy_range(slot.d_range);
+            }
+        });
+        this->release_segment(slots, segment);
+    }
+
+    for (size_type segment = 0u; segment < NUM_SEGMENTS; ++segment)
+    {
+        if (T* elements = this->d_elementSegments[segment].load(std::memory_order_acquire))
+        {
+            this->release_segment(elements, segment);
+        }
+    }
+}
+
+// Allocator
+template <typename T, typename Allocator>
+inline typename concurrent_inline_vector<T, Allocator>::allocator_type
+    concurrent_inline_vector<T, Allocator>::get_allocator() const noexcept
+{
+    return *this;
+}
+
+// Capacity
+template <typename T, typename Allocator>
+inline bool concurrent_inline_vector<T, Allocator>::empty() const noexcept
+{
+    return this->num_ranges() == 0u;
+}
+
+template <typename T, typename Allocator>
+inline typename concurrent_inline_vector<T, Allocator>::size_type
+    concurrent_inline_vector<T, Allocator>::num_ranges() const noexcept
+{
+    return this->d_numSlots.load(std::memory_order_acquire);
+}
+
+template <typename T, typename Allocator>
+inline MemoryUsage concurrent_inline_vector<T, Allocator>::memory_usage() const noexcept
+{
+    size_type numElements = 0u;
+    size_type numPublished = 0u;
+    this->for_each_range([&numElements, &numPublished](span<const T> range) noexcept {
+        numElements += range.length();
+        ++numPublished;
+    });
+
+    size_type elementCapacity = 0u;
+    size_type slotCapacity = 0u;
+    for (size_type segment = 0u; segment < NUM_SEGMENTS; ++segment)
+    {
+        if (this->d_elementSegments[segment].load(std::memory_order_acquire))
+        {
+            elementCapacity += segment_size(segment);
+        }
+        if (this->d_slotSegments[segment].load(std::memory_order_acquire))
+        {
+            slotCapacity += segment_size(segment);
+        }
+    }
+
+    return {
+        sizeof(T) * numElements,
+        sizeof(T) * (elementCapacity - numElements),
+        sizeof(Slot) * numPublished,
+        sizeof(Slot) * (slotCapacity - numPublished)
+    };
+}
+
+// Element Access
+template <typename T, typename Allocator>
+template <typename Function>
+inline void concurrent_inline_vector<T, Allocator>::for_each_range(Function function) const
+{
+    const size_type numSlots = this->d_numSlots.load(std::memory_order_acquire);
+    for (size_type segment = 0u; segment < NUM_SEGMENTS; ++segment)
+    {
+        const size_type first = segment_begin(segment);
+        if (first >= numSlots) break;
+
+        // A writer has claimed a slot here but not yet allocated
+        // the segment, so there is nothing published in it.
+        const Slot* slots = this->d_slotSegments[segment].load(std::memory_order_acquire);
+        if (!slots) continue;
+
+        const size_type numUsed = std::min(segment_size(segment), numSlots - first);
+        for (const Slot* slot = slots; slot != slots + numUsed; ++slot)
+        {
+            if (slot->d_published.load(std::memory_order_acquire))
+            {
+                function(span<const T>{slot->d_range});
+            }
+        }
+    }
+}
+
+// Modifiers
+template <typename T, typename Allocator>
+inline typename concurrent_inline_vector<T, Allocator>::size_type
+    concurrent_inline_vector<T, Allocator>::push_back_range(span<const T> range)
+{
+    const size_type length = range.length();
+
+    span<T> block;
+    if (length != 0u)
+    {
+        size_type claimed = this->d_numElements.load(std::memory_order_relaxed);
+        size_type first;
+        size_type segment;
+        do {
+            first = claimed;
+            segment = segment_of(first);
+            while (segment < NUM_SEGMENTS
+                && first + length > segment_begin(segment) + segment_size(segment))
+            {
+                first = segment_begin(++segment);
+            }
+            if (segment >= NUM_SEGMENTS)
+            {
+                throw std::length_error{"concurrent_inline_vector is full"};
+            }
+        } while (!this->d_numElements.compare_exchange_weak(claimed, first + length,
+            std::memory_order_relaxed));
+
+        T* elements = this->acquire_segment(this->d_elementSegments, segment)
+            + (first - segment_begin(segment));
+        safe_uninitialized_copy(range.begin(), range.end(), elements,
+            static_cast<Allocator&>(*this));
+        block = span<T>{elements, length};
+    }
+
+    const size_type index = this->d_numSlots.fetch_add(1u, std::memory_order_relaxed);
+    const size_type segment = segment_of(index);
+
+    Slot* slots;
+    try {
+        slots = this->acquire_segment(this->d_slotSegments, segment);
+    }
+    catch (...)
+    {
+        this->destroy_range(block);
+        throw;
+    }
+
+    Slot& slot = slots[index - segment_begin(segment)];
+    slot.d_range = block;
+    slot.d_published.store(true, std::memory_order_release);
+    return index;
+}
+
+// Helpers
+template <typename T, typename Allocator>
+inline typename concurrent_inline_vector<T, Allocator>::size_type
+    concurrent_inline_vector<T, Allocator>::segment_of(size_type index) noexcept
+{
+    return 63 - count_leading_zeros(index / FIRST_SEGMENT_SIZE + 1u);
+}
+
+template <typename T, typename Allocator>
+inline typename concurrent_inline_vector<T, Allocator>::size_type
+    concurrent_inline_vector<T, Allocator>::segment_begin(size_type segment) noexcept
+{
+    return FIRST_SEGMENT_SIZE * ((size_type{1u} << segment) - 1u);
+}
+
+template <typename T, typename Allocator>
+inline typename concurrent_inline_vector<T, Allocator>::size_type
+    concurrent_inline_vector<T, Allocator>::segment_size(size_type segment) noexcept
+{
+    return FIRST_SEGMENT_SIZE << segment;
+}
+
+template <typename T, typename Allocator>
+template <typename U>
+inline U* concurrent_inline_vector<T, Allocator>::acquire_segment(
+    std::atomic<U*>* segments, size_type segment)
+{
+    U* current = segments[segment].load(std::memory_order_acquire);
+    if (current) return current;
+
+    ReboundAlloc<U> alloc(*this);
+    U* fresh = std::allocator_traits<ReboundAlloc<U>>::allocate(alloc, segment_size(segment));
+    if constexpr (std::is_same_v<U, Slot>)
+    {
+        std::uninitialized_value_construct_n(fresh, segment_size(segment));
+    }
+
+    if (segments[segment].compare_exchange_strong(current, fresh, std::memory_order_acq_rel,
+        std::memory_order_acquire))
+    {
+        return fresh;
+    }
+
+    // Another thread allocated the segment first.
+    this->release_segment(fresh, segment);
+    return current;
+}
+
+template <typename T, typename Allocator>
+template <typename U>
+inline void concurrent_inline_vector<T, Allocator>::release_segment(U* segment,
+    size_type segmentIndex) noexcept
+{
+    static_assert(std::is_trivially_destructible_v<Slot>);
+
+    ReboundAlloc<U> alloc(*this);
+    std::allocator_traits<ReboundAlloc<U>>::deallocate(alloc, segment,
+        segment_size(segmentIndex));
+}
+
+template <typename T, typename Allocator>
+inline void concurrent_inline_vector<T, Allocator>::destroy_range(span<T> range) noexcept
+{
+    std::for_each(range.begin(), range.end(), [this](T& obj) noexcept {
+        std::allocator_traits<Allocator>::destroy(*this, std::addressof(obj));
+    });
+}
+
+} // close namespace tr::data_structures
+
+#endif // CONCURRENT_INLINE_VECTOR_HPP
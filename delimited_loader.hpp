@@ -0,0 +1,211 @@
+#ifndef DELIMITED_LOADER_HPP
+#define DELIMITED_LOADER_HPP
+
+#include <span.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <system_error>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+// Loading delimited files (one record per line, or NUL-separated
+// records) into a container of ranges such as `inline_vector<char>`.
+//
+// The file is read a large chunk at a time into one reused buffer,
+// the delimiters are found with `memchr`, and each record is appended
+// straight from the buffer, so there is no allocation per record.
+
+namespace tr::data_structures {
+
+struct DelimitedLoadOptions {
+    char            d_delimiter = '\n';
+
+    // How much to read at a time. The buffer grows past this only to
+    // fit a record which is longer than it.
+    std::size_t     d_chunkBytes = std::size_t{1u} << 20u;
+
+    // With `load_delimited_batches`, how many elements the container
+    // may hold before it is handed on and cleared.
+    std::size_t     d_batchBytes = std::size_t{64u} << 20u;
+};
+
+class DelimitedReader {
+    // Splits the contents of a file descriptor into records.
+    //
+    // A record which is cut off by the end of a chunk is moved to the
+    // front of the buffer and the next chunk is read in after it, so
+    // only that partial record is ever copied. The last record doesn't
+    // need a delimiter after it, matching `std::getline`.
+
+public: // Types
+    using size_type = std::size_t;
+
+public: // Construction
+    explicit DelimitedReader(int fd, const DelimitedLoadOptions& options = {});
+
+public: // Reading
+    // Read the next chunk, calling `function` with a `span<const char>`
+    // for every record completed by it. The spans are only valid until
+    // the next read. This returns `false` once the input is exhausted,
+    // and throws `std::system_error` if reading fails.
+    template <typename Function>
+    bool read_chunk(Function function);
+
+private: // Members
+    std::vector<char>   d_buffer;
+    size_type           d_carried;      // Bytes of a partial record at the front
+    int                 d_fd;
+    char                d_delimiter;
+    bool                d_finished;
+};
+
+// Append every record read from `fd` to `ranges`, returning how many
+// were read.
+template <typename Ranges>
+std::size_t load_delimited(int fd, Ranges& ranges, const DelimitedLoadOptions& options = {});
+
+// As above, but opening the file at `path` first.
+template <typename Ranges>
+std::size_t load_delimited(const char* path, Ranges& ranges,
+    const DelimitedLoadOptions& options = {});
+
+// Append the records read from `fd` to `ranges`, calling `consume(ranges)`
+// and then clearing it whenever it holds at least `d_batchBytes`
+// elements, and once more at the end if there is anything left. This
+// keeps the memory used to roughly one batch plus one chunk, as the
+// container's capacity is reused between batches.
+template <typename Ranges, typename Consume>
+std::size_t load_delimited_batches(int fd, Ranges& ranges, Consume consume,
+    const DelimitedLoadOptions& options = {});
+
+// =================================================================
+// INLINE DEFINITIONS
+// =================================================================
+// DelimitedReader
+inline DelimitedReader::DelimitedReader(int fd, const DelimitedLoadOptions& options)
+    : d_buffer(std::max<size_type>(options.d_chunkBytes, 1u))
+    , d_carried(0u)
+    , d_fd(fd)
+    , d_delimiter(options.d_delimiter)
+    , d_finished(false)
+{}
+
+template <typename Function>
+inline bool DelimitedReader::read_chunk(Function function)
+{
+    if (this->d_finished) return false;
+
+    // A record filling the whole buffer needs more room to finish.
+    if (this->d_carried == this->d_buffer.size())
+    {
+        this->d_buffer.resize(this->d_buffer.size() * 2u);
+    }
+
+    ssize_t numRead;
+    do {
+        numRead = ::read(this->d_fd, this->d_buffer.data() + this->d_carried,
+            this->d_buffer.size() - this->d_carried);
+    } while (numRead < 0 && errno == EINTR);
+
+    if (numRead < 0)
+    {
+        throw std::system_error{errno, std::generic_category(), "read"};
+    }
+
+    const char* first = this->d_buffer.data();
+    const char* last = first + this->d_carried + numRead;
+    const char* position = this->d_buffer.data() + this->d_carried;
+    while (const char* delimiter = static_cast<const char*>(
+        std::memchr(position, this->d_delimiter, last - position)))
+    {
+        function(span<const char>{first, delimiter});
+        first = delimiter + 1;
+        position = first;
+    }
+
+    if (numRead == 0)
+    {
+        if (first != last)
+        {
+            function(span<const char>{first, last});
+        }
+        this->d_finished = true;
+        return false;
+    }
+
+    this->d_carried = last - first;
+    std::memmove(this->d_buffer.data(), first, this->d_carried);
+    return true;
+}
+
+// Loading
+template <typename Ranges>
+inline std::size_t load_delimited(int fd, Ranges& ranges, const DelimitedLoadOptions& options)
+{
+    DelimitedReader reader{fd, options};
+    std::size_t numRecords = 0u;
+    const auto append = [&ranges, &numRecords](span<const char> record) {
+        ranges.push_back_range(record);
+        ++numRecords;
+    };
+
+    while (reader.read_chunk(append)) {}
+    return numRecords;
+}
+
+template <typename Ranges>
+inline std::size_t load_delimited(const char* path, Ranges& ranges,
+    const DelimitedLoadOptions& options)
+{
+    const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        throw std::system_error{errno, std::generic_category(), path};
+    }
+
+    try {
+        const std::size_t numRecords = load_delimited(fd, ranges, options);
+        ::close(fd);
+        return numRecords;
+    }
+    catch (...)
+    {
+        ::close(fd);
+        throw;
+    }
+}
+
+template <typename Ranges, typename Consume>
+inline std::size_t load_delimited_batches(int fd, Ranges& ranges, Consume consume,
+    const DelimitedLoadOptions& options)
+{
+    DelimitedReader reader{fd, options};
+    std::size_t numRecords = 0u;
+    const auto append = [&](span<const char> record) {
+        ranges.push_back_range(record);
+        ++numRecords;
+        if (ranges.size() >= options.d_batchBytes)
+        {
+            consume(ranges);
+            ranges.clear();
+        }
+    };
+
+    while (reader.read_chunk(append)) {}
+
+    if (ranges.num_ranges() > 0u)
+    {
+        consume(ranges);
+        ranges.clear();
+    }
+    return numRecords;
+}
+
+} // close namespace tr::data_structures
+
+#endif // DELIMITED_LOADER_HPP
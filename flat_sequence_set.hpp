@@ -5,12 +5,15 @@
 #include "utility.hpp"
 
 #include <algorithm>
+#include <cassert>
+#include <functional>
+#include <memory_resource>
 #include <type_traits>
 
 namespace tr::data_structures {
 
 template <typename Type, 
-          typename Compare = std::less<span<Type>>,
+          typename Compare = std::less<>,
           typename Container = inline_vector<Type>>
 class flat_sequence_set : private Container, private Compare {
     // This is a container adaptor that takes sequences of 
@@ -32,6 +35,8 @@ public: // Types
     using allocator_type = typename Container::allocator_type;
     using size_type = typename Container::size_type;
 
+    using key_type = span<std::add_const_t<Type>>;
+
 public: // Constructors
     flat_sequence_set(const Compare& compare = {}, const Container& cont = {});
 
@@ -50,7 +55,6 @@ public: // Constructors
 
 
 public: // Accessors
-    reference operator[](size_type index) noexcept;
     using Container::operator[];
     using Container::at;
     using Container::front;
@@ -70,6 +74,7 @@ public: // Capacity
     using Container::size;
     using Container::num_ranges;
     using Container::empty;
+    using Container::memory_usage;
 
 public: // Iteration
     using Container::begin;
@@ -84,12 +89,27 @@ public: // Iteration
     using Container::rend;
     using Container::crend;
 
+public: // Lookup
+    [[nodiscard]] const_iterator find(key_type key) const;
+
+    // Look up every key in `keys`, writing where each was found (or
+    // `end()`) to the same index in `out`. The searches are run in
+    // groups which step through the set together, prefetching their
+    // next probes, so that their cache misses overlap rather than
+    // each search waiting on its own.
+    void find_batch(span<const key_type> keys, span<const_iterator> out) const;
+
 public: // Modifiers:
     using Container::clear;
     using Container::erase_range;
 
     void insert_range(span<std::add_const_t<Type>> range);
 
+private: // Helper variables
+    // Enough searches to keep the memory system busy, while their
+    // state still fits comfortably in registers and L1.
+    static constexpr size_type FIND_BATCH_GROUP = 16u;
+
 private: // Helpers
     void construction_helper(const Container& cont);
 };
@@ -189,6 +209,60 @@ Compare&& flat_sequence_set<Type, Compare, Container>::get_compare() && noexcept
     return static_cast<Compare&&>(*this);
 }
 
+// Lookup
+template <typename Type, typename Compare, typename Container>
+inline typename flat_sequence_set<Type, Compare, Container>::const_iterator
+    flat_sequence_set<Type, Compare, Container>::find(key_type key) const
+{
+    const Compare& compare = *this;
+    const const_iterator it = std::lower_bound(this->begin(), this->end(), key, compare);
+    return (it != this->end() && !compare(key, *it)) ? it : this->end();
+}
+
+template <typename Type, typename Compare, typename Container>
+inline void flat_sequence_set<Type, Compare, Container>::find_batch(span<const key_type> keys,
+    span<const_iterator> out) const
+{
+    assert(keys.length() == out.length());
+    const Compare& compare = *this;
+    const size_type numRanges = this->num_ranges();
+
+    for (size_type group = 0u; group < keys.length(); group += FIND_BATCH_GROUP)
+    {
+        const size_type groupSize = std::min<size_type>(FIND_BATCH_GROUP, keys.length() - group);
+        const key_type* groupKeys = keys.data() + group;
+        const_iterator* bases = out.data() + group;
+        std::fill_n(bases, groupSize, this->begin());
+
+        // This is a branch-free binary search, where the number of
+        // ranges left only depends on the step, so every search in the
+        // group moves in lock step. The blocks to probe were prefetched
+        // on the previous step, so first prefetch the elements they
+        // point at, then compare against them.
+        for (size_type remaining = numRanges; remaining > 1u; )
+        {
+            const size_type half = remaining / 2u;
+            for (size_type i = 0u; i < groupSize; ++i)
+            {
+                prefetch(bases[i][half].data());
+            }
+            remaining -= half;
+            for (size_type i = 0u; i < groupSize; ++i)
+            {
+                if (compare(bases[i][half], groupKeys[i])) bases[i] += half;
+                prefetch(bases[i] + remaining / 2u);
+            }
+        }
+
+        for (size_type i = 0u; i < groupSize; ++i)
+        {
+            const const_iterator it = (numRanges > 0u && compare(*bases[i], groupKeys[i]))
+                ? bases[i] + 1 : bases[i];
+            bases[i] = (it != this->end() && !compare(groupKeys[i], *it)) ? it : this->end();
+        }
+    }
+}
+
 // Modifiers
 template <typename Type, typename Compare, typename Container>
 void flat_sequence_set<Type, Compare, Container>::insert_range(span<std::add_const_t<Type>> range)
@@ -205,7 +279,7 @@ void flat_sequence_set<Type, Compare, Container>::construction_helper(const Cont
 {
     // TODO: See if there is an easier way to resolve this hack?
     std::vector<typename Container::value_type> spans;
-    spans.resize(cont.size());
+    spans.resize(cont.num_ranges());
     Container::reserve(cont.size());
     std::partial_sort_copy(cont.begin(), cont.end(),
         spans.begin(), spans.end(), static_cast<Compare&>(*this));
@@ -213,6 +287,14 @@ void flat_sequence_set<Type, Compare, Container>::construction_helper(const Cont
         back_range_inserter(static_cast<Container&>(*this)));
 }
 
+namespace pmr {
+
+template <typename Type, typename Compare = std::less<>>
+using flat_sequence_set = data_structures::flat_sequence_set<Type, Compare,
+    pmr::inline_vector<Type>>;
+
+} // close namespace pmr
+
 } // close namespace tr::data_structures
 
 #endif // FLAT_SEQUENCE_SET_HPP
@@ -2,11 +2,15 @@
 #define INLINE_VECTOR_HPP
 
 #include <span.hpp>
+#include <static_vector.hpp>
 #include <utility.hpp>
 
 #include <algorithm>
+#include <limits>
 #include <memory>
+#include <memory_resource>
 #include <numeric>
+#include <stdexcept>
 #include <vector>
 
 // TODO:
@@ -15,8 +19,91 @@
 
 namespace tr::data_structures {
 
-template <typename T, typename Allocator = std::allocator<T>>
-class inline_vector : private Allocator
+// Block policies choose the container `inline_vector` describes its
+// ranges with. It must store the blocks contiguously, as iterators
+// are pointers into it, and it is given the container's allocator
+// (rebound to `Block`) if it is allocator-aware.
+
+// Keep the blocks in a `std::vector` using the container's allocator.
+struct VectorBlockPolicy {
+    template <typename Block, typename Allocator>
+    using container = std::vector<Block, Allocator>;
+};
+
+// Keep up to `N` blocks inside the container itself, for when the
+// number of ranges is known to be small.
+template <std::size_t N>
+struct StaticBlockPolicy {
+    template <typename Block, typename Allocator>
+    using container = static_vector<Block, N>;
+};
+
+// Growth policies choose how many elements `inline_vector` makes room
+// for once `required` no longer fit in its `current` capacity, through
+// `next_capacity<T>(current, required)`.
+
+// Grow by a factor of `Num / Den`, but by no more than `MaxStep`
+// elements at a time (if it is non-zero). With `RoundToSizeClass` the
+// allocation is also rounded up to the size the allocator would most
+// likely hand out anyway: a power of two for small buffers and a whole
+// number of pages for larger ones.
+template <std::size_t Num = 2u, std::size_t Den = 1u, std::size_t MaxStep = 0u,
+    bool RoundToSizeClass = false>
+struct GeometricGrowthPolicy {
+    static_assert(Den > 0u && Num > Den);
+
+    static constexpr std::size_t PAGE_SIZE = 4096u;
+
+    template <typename T>
+    [[nodiscard]] static constexpr std::size_t next_capacity(std::size_t current,
+        std::size_t required) noexcept;
+};
+
+// Grow like `Base`, but move the elements into the new buffer a few
+// ranges at a time rather than all at once. Each `push_back_range`
+// made while this is going on relocates ranges holding at least `Step`
+// elements, and at least twice as many as it appends, so no single
+// call pays for copying the whole container. Ranges are only moved
+// whole, and any other modification finishes the relocation first.
+template <std::size_t Step, typename Base = GeometricGrowthPolicy<>>
+struct IncrementalGrowthPolicy : Base {
+    static_assert(Step > 0u);
+
+    static constexpr std::size_t RELOCATION_STEP = Step;
+};
+
+// The number of elements a growth policy relocates per step, or `0`
+// if it relocates everything as soon as the container grows.
+template <typename Policy, typename = void>
+struct relocation_step : std::integral_constant<std::size_t, 0u> {};
+
+template <typename Policy>
+struct relocation_step<Policy, std::void_t<decltype(Policy::RELOCATION_STEP)>>
+    : std::integral_constant<std::size_t, Policy::RELOCATION_STEP> {};
+
+template <typename Policy>
+inline constexpr std::size_t relocation_step_v = relocation_step<Policy>::value;
+
+template <typename T, bool Incremental>
+struct InlineVectorRelocation {
+    // The state of an incremental relocation: the blocks from
+    // `d_relocatedBlocks` up to `d_relocationEnd` still point
+    // into the old buffer, at the same offsets they will have in
+    // the new one.
+    T*          d_oldBuffer = nullptr;
+    std::size_t d_oldCapacity = 0u;
+    std::size_t d_relocatedBlocks = 0u;
+    std::size_t d_relocationEnd = 0u;
+};
+
+template <typename T>
+struct InlineVectorRelocation<T, false> {};
+
+template <typename T, typename Allocator = std::allocator<T>,
+    typename BlockPolicy = VectorBlockPolicy, typename GrowthPolicy = GeometricGrowthPolicy<>>
+class inline_vector
+    : private Allocator
+    , private InlineVectorRelocation<T, (relocation_step_v<GrowthPolicy> > 0u)>
 {
     // This class is a vector of sequences that
     // are stored inline. 
@@ -51,10 +138,17 @@ public: // Constructors
     inline_vector(const inline_vector& other, const Allocator& alloc);
     inline_vector(inline_vector&& other) noexcept;
     inline_vector(inline_vector&& other, const Allocator& alloc);
+    ~inline_vector();
 
 public: // Assignment
+    // These follow the allocator's propagation traits, as the standard
+    // containers do. Where the allocator doesn't propagate and differs
+    // from `other`'s, the ranges are copied into memory from this
+    // container's own allocator, even when moving.
     inline_vector& operator=(const inline_vector& other);
-    inline_vector& operator=(inline_vector&& other);
+    inline_vector& operator=(inline_vector&& other) noexcept(
+        std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value
+        || std::allocator_traits<Allocator>::is_always_equal::value);
 
     template <typename InputIt>
     void assign(InputIt first, InputIt last);
@@ -82,6 +176,18 @@ public: // Capacity
     // Allocate enough memory for `new_cap` Ts. 
     void reserve(size_type new_cap);
 
+    // Allocate enough memory to describe `new_cap` ranges.
+    void reserve_ranges(size_type new_cap);
+
+    // Release any unused capacity, for both the elements and the ranges.
+    // This does nothing with a monotonic allocator, which couldn't reuse
+    // the memory anyway.
+    void shrink_to_fit();
+
+    // This returns how much memory the container holds, split between
+    // the elements, the blocks describing the ranges and unused capacity.
+    [[nodiscard]] MemoryUsage memory_usage() const noexcept;
+
 public: // Element Access
     [[nodiscard]] reference operator[](size_type index) noexcept;
     [[nodiscard]] const_reference operator[](size_type index) const noexcept;
@@ -132,16 +238,73 @@ public: // Modifiers
 
     void pop_back_range() noexcept;
 
+    // Reorder the ranges by `compare`, which is given two `span<T>`s.
+    // Only the blocks are sorted, after which the elements are moved
+    // once into a new buffer in the new order, so iterating stays
+    // sequential in memory.
+    template <typename Compare>
+    void sort_ranges(Compare compare);
+    template <typename Compare>
+    void stable_sort_ranges(Compare compare);
+
+    // Reorder the ranges so that the one at `permutation[i]` ends up at
+    // index `i`. This throws `std::invalid_argument` if `permutation`
+    // isn't a permutation of `[0, num_ranges())`.
+    void permute_ranges(span<const size_type> permutation);
+
 private: // Private Types
     template <typename U>
     using ReboundAlloc = typename std::allocator_traits<Allocator>::template rebind_alloc<U>;
 
+    using Block = span<T>;
+    using BlockManager = typename BlockPolicy::template container<Block, ReboundAlloc<Block>>;
+
+    using Relocation = InlineVectorRelocation<T, (relocation_step_v<GrowthPolicy> > 0u)>;
+
 private: // Helper variables
-    static constexpr size_type RESIZE_FACTOR = 2u;
+    static constexpr size_type RELOCATION_STEP = relocation_step_v<GrowthPolicy>;
+
+private: // Helpers
+    // Throw `std::length_error` if the block policy has no room for
+    // another range, before anything has been changed.
+    void check_block_room() const;
+
+    // Remove the elements in `gap`, moving those after it down.
+    void close_gap(Block gap);
+
+    // Make room for at least `required` elements, as the growth policy sees fit.
+    void grow(size_type required);
+
+    // Move the elements to a buffer of exactly `new_cap` elements.
+    void reallocate(size_type new_cap);
+
+    // Move the elements to a new buffer, laid out in the order of the blocks.
+    void lay_out_in_block_order();
+
+    // Like `grow`, but with an incremental growth policy this only
+    // starts moving the elements to the new buffer.
+    void grow_incrementally(size_type required);
+
+    // Move ranges holding at least `budget` elements into the new
+    // buffer, releasing the old one once they have all been moved.
+    void relocate(size_type budget);
+    void finish_relocation();
+
+    // Destroy the elements and return the buffer to the allocator,
+    // which must happen before the allocator is replaced.
+    void release_buffer() noexcept;
+
+    // Append copies of the ranges of `other`, after making room for them.
+    void append_copies(const inline_vector& other);
+
+    // This returns the capacity of the buffer being relocated from.
+    [[nodiscard]] size_type old_capacity() const noexcept;
+
+    [[nodiscard]] static BlockManager make_block_manager(const Allocator& alloc);
+    [[nodiscard]] static BlockManager make_block_manager(BlockManager&& other,
+        const Allocator& alloc);
 
 private:
-    using Block = span<T>;
-    using BlockManager = std::vector<Block, ReboundAlloc<Block>>;
     BlockManager        d_blockManager;
 
     T*                  d_buffer;
@@ -153,317 +316,520 @@ private:
 // INLINE DEFINITIONS
 // =================================================================
 
+// GeometricGrowthPolicy
+template <std::size_t Num, std::size_t Den, std::size_t MaxStep, bool RoundToSizeClass>
+template <typename T>
+inline constexpr std::size_t
+    GeometricGrowthPolicy<Num, Den, MaxStep, RoundToSizeClass>::next_capacity(
+    std::size_t current, std::size_t required) noexcept
+{
+    std::size_t next = current * Num / Den + 1u;
+    if constexpr (MaxStep > 0u)
+    {
+        next = std::min(next, current + MaxStep);
+    }
+    next = std::max(next, required);
+
+    if constexpr (RoundToSizeClass)
+    {
+        std::size_t numBytes = next * sizeof(T);
+        if (numBytes < PAGE_SIZE)
+        {
+            std::size_t sizeClass = 1u;
+            while (sizeClass < numBytes) sizeClass <<= 1u;
+            numBytes = sizeClass;
+        }
+        else
+        {
+            numBytes = (numBytes + PAGE_SIZE - 1u) / PAGE_SIZE * PAGE_SIZE;
+        }
+        next = numBytes / sizeof(T);
+    }
+
+    return next;
+}
+
 // Constructors
-template <typename T, typename Allocator>
-inline inline_vector<T, Allocator>::inline_vector()
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
+inline inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::inline_vector()
     noexcept(std::is_nothrow_default_constructible_v<Allocator>)
     : inline_vector(Allocator{})
 {}
 
-template <typename T, typename Allocator>
-inline inline_vector<T, Allocator>::inline_vector(const Allocator& alloc) noexcept
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
+inline inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::inline_vector(
+    const Allocator& alloc) noexcept
     : Allocator(alloc)
-    , d_blockManager(alloc)
+    , d_blockManager(make_block_manager(alloc))
     , d_buffer(nullptr)
     , d_size(0u)
     , d_capacity(0u)
 {}
 
-template <typename T, typename Allocator>
-inline inline_vector<T, Allocator>::inline_vector(const inline_vector& other)
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
+inline inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::inline_vector(
+    const inline_vector& other)
     : Allocator(std::allocator_traits<allocator_type>::select_on_container_copy_construction(
         other.get_allocator()))
-    , d_blockManager(*this)
+    , d_blockManager(make_block_manager(*this))
     , d_buffer(nullptr)
     , d_size(0u)
     , d_capacity(0u)
 {
     this->reserve(other.d_size);
+    this->reserve_ranges(other.num_ranges());
     std::for_each(other.cbegin(), other.cend(), [this](auto block) {
         push_back_range(block);
     });
 }
 
-template <typename T, typename Allocator>
-inline inline_vector<T, Allocator>::inline_vector(const inline_vector& other, 
-    const Allocator& alloc)
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
+inline inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::inline_vector(
+    const inline_vector& other, const Allocator& alloc)
     : Allocator(alloc)
-    , d_blockManager(alloc)
+    , d_blockManager(make_block_manager(alloc))
     , d_buffer(nullptr)
     , d_size(0u)
     , d_capacity(0u)
 {
     this->reserve(other.d_size);
+    this->reserve_ranges(other.num_ranges());
     std::for_each(other.cbegin(), other.cend(), [this](auto block) {
         push_back_range(block);
     });
 }
 
-template <typename T, typename Allocator>
-inline inline_vector<T, Allocator>::inline_vector(inline_vector&& other) noexcept
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
+inline inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::inline_vector(
+    inline_vector&& other) noexcept
     : Allocator(other)
-    , d_blockManager(std::move(other.d_blockManager), *this)
+    , d_blockManager(make_block_manager(std::move(other.d_blockManager), *this))
     , d_buffer(other.d_buffer)
     , d_size(other.d_size)
     , d_capacity(other.d_capacity)
 {
+    static_cast<Relocation&>(*this) = std::exchange(static_cast<Relocation&>(other),
+        Relocation{});
+    other.d_blockManager.clear();
     other.d_buffer = nullptr;
+    other.d_size = 0u;
+    other.d_capacity = 0u;
+}
+
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
+inline inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::inline_vector(inline_vector&& other,
+    const Allocator& alloc)
+    : Allocator(alloc)
+    , d_blockManager(make_block_manager(alloc))
+    , d_buffer(nullptr)
+    , d_size(0u)
+    , d_capacity(0u)
+{
+    if (static_cast<const Allocator&>(*this) == other.get_allocator())
+    {
+        this->d_blockManager = std::move(other.d_blockManager);
+        other.d_blockManager.clear();
+        std::swap(this->d_buffer, other.d_buffer);
+        std::swap(this->d_size, other.d_size);
+        std::swap(this->d_capacity, other.d_capacity);
+        std::swap(static_cast<Relocation&>(*this), static_cast<Relocation&>(other));
+    }
+    else
+    {
+        // The memory belongs to a different allocator, so we
+        // have to fall back to copying it.
+        this->reserve(other.d_size);
+        this->reserve_ranges(other.num_ranges());
+        std::for_each(other.cbegin(), other.cend(), [this](auto block) {
+            push_back_range(block);
+        });
+    }
+}
+
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
+inline inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::~inline_vector()
+{
+    // A monotonic allocator reclaims everything at once, so
+    // there is nothing to do unless we have destructors to run.
+    if constexpr (!is_monotonic_v<Allocator> || !std::is_trivially_destructible_v<T>)
+    {
+        this->clear();
+        if (this->d_buffer)
+        {
+            std::allocator_traits<Allocator>::deallocate(*this, this->d_buffer, this->d_capacity);
+        }
+    }
+}
+
+// Assignment
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
+inline inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>&
+    inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::operator=(const inline_vector& other)
+{
+    if (this == &other) return *this;
+
+    if constexpr (std::allocator_traits<Allocator>::propagate_on_container_copy_assignment::value)
+    {
+        if (!(static_cast<const Allocator&>(*this) == other.get_allocator()))
+        {
+            this->release_buffer();
+        }
+        static_cast<Allocator&>(*this) = other.get_allocator();
+
+        // Copying an empty block manager hands it the new allocator,
+        // if its own traits say it should take it.
+        const BlockManager blockManager = make_block_manager(*this);
+        this->d_blockManager = blockManager;
+    }
+
+    this->clear();
+    this->append_copies(other);
+    return *this;
+}
+
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
+inline inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>&
+    inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::operator=(inline_vector&& other)
+    noexcept(std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value
+        || std::allocator_traits<Allocator>::is_always_equal::value)
+{
+    if (this == &other) return *this;
+
+    if constexpr (!std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value)
+    {
+        if (!(static_cast<const Allocator&>(*this) == other.get_allocator()))
+        {
+            // The memory belongs to a different allocator, so we
+            // have to fall back to copying it.
+            this->clear();
+            this->append_copies(other);
+            return *this;
+        }
+    }
+
+    this->release_buffer();
+    if constexpr (std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value)
+    {
+        static_cast<Allocator&>(*this) = other.get_allocator();
+    }
+
+    this->d_blockManager = std::move(other.d_blockManager);
+    other.d_blockManager.clear();
+    this->d_buffer = std::exchange(other.d_buffer, nullptr);
+    this->d_size = std::exchange(other.d_size, 0u);
+    this->d_capacity = std::exchange(other.d_capacity, 0u);
+    static_cast<Relocation&>(*this) = std::exchange(static_cast<Relocation&>(other),
+        Relocation{});
+    return *this;
 }
 
 // Allocator
-template <typename T, typename Allocator>
-inline typename inline_vector<T, Allocator>::allocator_type 
-    inline_vector<T, Allocator>::get_allocator() const noexcept
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
+inline typename inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::allocator_type 
+    inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::get_allocator() const noexcept
 {
     return *this;
 }
 
 // Capacity
-template <typename T, typename Allocator>
-inline bool inline_vector<T, Allocator>::empty() const noexcept
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
+inline bool inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::empty() const noexcept
 {
     return (this->d_size == 0u);
 }
 
-template <typename T, typename Allocator>
-inline typename inline_vector<T, Allocator>::size_type inline_vector<T, Allocator>::size()
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
+inline typename inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::size_type
+    inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::size()
     const noexcept
 {
     return this->d_size;
 }
 
-template <typename T, typename Allocator>
-inline typename inline_vector<T, Allocator>::size_type inline_vector<T, Allocator>::capacity()
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
+inline typename inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::size_type
+    inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::capacity()
     const noexcept
 {
     return this->d_capacity;
 }
 
-template <typename T, typename Allocator>
-inline typename inline_vector<T, Allocator>::size_type inline_vector<T, Allocator>::num_ranges()
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
+inline typename inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::size_type
+    inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::num_ranges()
     const noexcept
 {
     return this->d_blockManager.size();
 }
 
-template <typename T, typename Allocator>
-inline typename inline_vector<T, Allocator>::size_type inline_vector<T, Allocator>::max_size()
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
+inline typename inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::size_type
+    inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::max_size()
     const noexcept
 {
     return std::allocator_traits<Allocator>::max_size(*this);
 }
 
-template <typename T, typename Allocator>
-inline void inline_vector<T, Allocator>::reserve(size_type new_cap) 
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
+inline void inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::reserve(size_type new_cap) 
 {
     if (new_cap <= this->d_capacity) return;
+    this->finish_relocation();
 
-    this->d_blockManager.reserve(this->d_blockManager.capacity() 
-        + (new_cap - this->d_capacity));
+    // If the allocator can extend the current buffer then the
+    // elements (and the blocks pointing at them) can stay put.
+    if constexpr (has_try_expand_v<Allocator>)
+    {
+        if (this->d_buffer && static_cast<Allocator&>(*this).try_expand(this->d_buffer,
+            this->d_capacity, new_cap))
+        {
+            this->d_capacity = new_cap;
+            return;
+        }
+    }
 
-    T* newBuff = std::allocator_traits<Allocator>::allocate(*this,
-        new_cap);
+    this->reallocate(new_cap);
+}
 
-    try {
-        safe_uninitialized_copy(make_move_iterator_if_noexcept(this->d_buffer),
-            make_move_iterator_if_noexcept(this->d_buffer + this->d_size),
-            newBuff, static_cast<Allocator&>(*this));
-        std::swap(d_buffer, newBuff);
-        std::for_each(newBuff, newBuff + this->d_size, [this](T& obj) noexcept {
-            std::allocator_traits<Allocator>::destroy(*this, std::addressof(obj));
-        });
-        std::for_each(this->d_blockManager.begin(), this->d_blockManager.end(),
-            [this, newBuff](Block& block) noexcept {
-                block = Block{this->d_buffer + (block.data() - newBuff),
-                              block.length()};
-            }
-        );
-        std::allocator_traits<Allocator>::deallocate(*this, newBuff, this->d_capacity);
-        this->d_capacity = new_cap;
-    }
-    catch (...)
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
+inline void inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::reserve_ranges(
+    size_type new_cap)
+{
+    this->d_blockManager.reserve(new_cap);
+}
+
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
+inline void inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::shrink_to_fit()
+{
+    if constexpr (!is_monotonic_v<Allocator>)
     {
-        std::allocator_traits<Allocator>::deallocate(*this, newBuff, new_cap);
-        throw;
+        this->finish_relocation();
+        if (this->d_size == 0u && this->d_buffer)
+        {
+            std::allocator_traits<Allocator>::deallocate(*this, this->d_buffer, this->d_capacity);
+            this->d_buffer = nullptr;
+            this->d_capacity = 0u;
+        }
+        else if (this->d_size < this->d_capacity)
+        {
+            this->reallocate(this->d_size);
+        }
+
+        this->d_blockManager.shrink_to_fit();
     }
 }
 
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
+inline MemoryUsage inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::memory_usage()
+    const noexcept
+{
+    return {
+        sizeof(T) * this->d_size,
+        sizeof(T) * (this->d_capacity - this->d_size + this->old_capacity()),
+        sizeof(Block) * this->d_blockManager.size(),
+        sizeof(Block) * (this->d_blockManager.capacity() - this->d_blockManager.size())
+    };
+}
+
 // Element Access
-template <typename T, typename Allocator>
-inline typename inline_vector<T, Allocator>::reference 
-    inline_vector<T, Allocator>::at(size_type index)
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
+inline typename inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::reference 
+    inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::at(size_type index)
 {
     if (index >= this->d_blockManager.size()) { throw std::out_of_range{"Index out of range"}; }
     return this->operator[](index);
 }
 
-template <typename T, typename Allocator>
-inline typename inline_vector<T, Allocator>::const_reference
-    inline_vector<T, Allocator>::at(size_type index) const
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
+inline typename inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::const_reference
+    inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::at(size_type index) const
 {
     if (index >= this->d_blockManager.size()) { throw std::out_of_range{"Index out of range"}; }
     return this->operator[](index);
 }
 
-template <typename T, typename Allocator>
-inline typename inline_vector<T, Allocator>::reference
-    inline_vector<T, Allocator>::operator[](size_type index) noexcept
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
+inline typename inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::reference
+    inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::operator[](size_type index) noexcept
 {
     assert(index < this->d_blockManager.size());
     return this->d_blockManager[index];
 }
 
-template <typename T, typename Allocator>
-inline typename inline_vector<T, Allocator>::const_reference
-    inline_vector<T, Allocator>::operator[](size_type index) const noexcept
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
+inline typename inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::const_reference
+    inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::operator[](
+    size_type index) const noexcept
 {
     assert(index < this->d_blockManager.size());
     return this->d_blockManager[index];
 }
 
-template <typename T, typename Allocator>
-inline typename inline_vector<T, Allocator>::reference
-    inline_vector<T, Allocator>::front() noexcept
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
+inline typename inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::reference
+    inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::front() noexcept
 {
     assert(!this->empty());
     return this->operator[](0u);
 }
 
-template <typename T, typename Allocator>
-inline typename inline_vector<T, Allocator>::const_reference
-    inline_vector<T, Allocator>::front() const noexcept
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
+inline typename inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::const_reference
+    inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::front() const noexcept
 {
     assert(!this->empty());
     return this->operator[](0u);
 }
 
-template <typename T, typename Allocator>
-inline typename inline_vector<T, Allocator>::reference
-    inline_vector<T, Allocator>::back() noexcept
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
+inline typename inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::reference
+    inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::back() noexcept
 {
     assert(!this->empty());
     return this->operator[](this->d_blockManager.size() - 1u);
 }
 
-template <typename T, typename Allocator>
-inline typename inline_vector<T, Allocator>::const_reference
-    inline_vector<T, Allocator>::back() const noexcept
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
+inline typename inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::const_reference
+    inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::back() const noexcept
 {
     assert(!this->empty());
     return this->operator[](this->d_blockManager.size() - 1u);
 }
 
 // Iterators
-template <typename T, typename Allocator>
-inline typename inline_vector<T, Allocator>::iterator inline_vector<T, Allocator>::begin()
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
+inline typename inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::iterator
+    inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::begin()
     noexcept
 {
     return this->d_blockManager.data();
 }
 
-template <typename T, typename Allocator>
-inline typename inline_vector<T, Allocator>::const_iterator inline_vector<T, Allocator>::begin()
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
+inline typename inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::const_iterator
+    inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::begin()
     const noexcept
 {
     return this->cbegin();
 }
 
-template <typename T, typename Allocator>
-inline typename inline_vector<T, Allocator>::const_iterator inline_vector<T, Allocator>::cbegin()
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
+inline typename inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::const_iterator
+    inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::cbegin()
     const noexcept
 {
     return this->d_blockManager.data();
 }
 
-template <typename T, typename Allocator>
-inline typename inline_vector<T, Allocator>::iterator inline_vector<T, Allocator>::end()
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
+inline typename inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::iterator
+    inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::end()
     noexcept
 {
     return const_cast<const span<T>*>(this->d_blockManager.data()) 
         + this->d_blockManager.size();
 }
 
-template <typename T, typename Allocator>
-inline typename inline_vector<T, Allocator>::const_iterator inline_vector<T, Allocator>::end()
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
+inline typename inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::const_iterator
+    inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::end()
     const noexcept
 {
     return this->cend();
 }
 
-template <typename T, typename Allocator>
-inline typename inline_vector<T, Allocator>::const_iterator inline_vector<T, Allocator>::cend()
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
+inline typename inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::const_iterator
+    inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::cend()
     const noexcept
 {
     return this->d_blockManager.data()
         + this->d_blockManager.size();
 }
 
-template <typename T, typename Allocator>
-inline typename inline_vector<T, Allocator>::reverse_iterator inline_vector<T, Allocator>::rbegin()
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
+inline typename inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::reverse_iterator
+    inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::rbegin()
     noexcept
 {
     return reverse_iterator{this->end()};
 }
 
-template <typename T, typename Allocator>
-inline typename inline_vector<T, Allocator>::const_reverse_iterator 
-    inline_vector<T, Allocator>::rbegin() const noexcept
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
+inline typename inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::const_reverse_iterator 
+    inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::rbegin() const noexcept
 {
     return this->crbegin();
 }
 
-template <typename T, typename Allocator>
-inline typename inline_vector<T, Allocator>::const_reverse_iterator 
-    inline_vector<T, Allocator>::crbegin() const noexcept
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
+inline typename inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::const_reverse_iterator 
+    inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::crbegin() const noexcept
 {
     return reverse_iterator{this->cend()};
 }
 
-template <typename T, typename Allocator>
-inline typename inline_vector<T, Allocator>::reverse_iterator inline_vector<T, Allocator>::rend()
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
+inline typename inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::reverse_iterator
+    inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::rend()
     noexcept
 {
     return reverse_iterator{this->begin()};
 }
 
-template <typename T, typename Allocator>
-inline typename inline_vector<T, Allocator>::const_reverse_iterator 
-    inline_vector<T, Allocator>::rend() const noexcept
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
+inline typename inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::const_reverse_iterator 
+    inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::rend() const noexcept
 {
     return this->crend();
 }
 
-template <typename T, typename Allocator>
-inline typename inline_vector<T, Allocator>::const_reverse_iterator 
-    inline_vector<T, Allocator>::crend() const noexcept
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
+inline typename inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::const_reverse_iterator 
+    inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::crend() const noexcept
 {
     return reverse_iterator{this->cbegin()};
 }
 
 // Modifiers
-template <typename T, typename Allocator>
-inline void inline_vector<T, Allocator>::clear() 
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
+inline void inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::clear() 
 {
+    if constexpr (RELOCATION_STEP > 0u)
+    {
+        // Part way through a relocation the elements are split between
+        // the buffers, but each block still knows where its own are.
+        std::for_each(this->d_blockManager.begin(), this->d_blockManager.end(),
+            [this](Block& block) noexcept {
+                std::for_each(block.begin(), block.end(), [this](T& obj) noexcept {
+                    std::allocator_traits<Allocator>::destroy(*this, std::addressof(obj));
+                });
+            });
+        this->d_relocationEnd = this->d_relocatedBlocks;
+        this->relocate(0u);
+    }
+    else
+    {
+        std::for_each(this->d_buffer, this->d_buffer + this->d_size,
+            [this](T& obj) noexcept { 
+                std::allocator_traits<Allocator>::destroy(*this, std::addressof(obj)); 
+            });
+    }
     this->d_blockManager.clear();
-    std::for_each(this->d_buffer, this->d_buffer + this->d_size,
-        [this](T& obj) noexcept { 
-            std::allocator_traits<Allocator>::destroy(*this, std::addressof(obj)); 
-        });
     this->d_size = 0u;
 }
 
-template <typename T, typename Allocator>
-inline typename inline_vector<T, Allocator>::iterator inline_vector<T, Allocator>::erase_range(
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
+inline typename inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::iterator
+    inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::erase_range(
     const_iterator pos)
 {
+    this->finish_relocation();
+
     Block block{const_cast<T*>(pos->data()), pos->length()};
-    std::for_each(block.begin(), block.end(), [this](T& obj) noexcept {
-        std::allocator_traits<Allocator>::destroy(*this, std::addressof(obj));
-    });
-    std::copy(make_move_iterator_if_noexcept(block.data() + block.length()),
-        make_move_iterator_if_noexcept(this->d_buffer + this->size()),
-        block.data());
-    
+    this->close_gap(block);
+
     std::ptrdiff_t offset = const_cast<Block*>(pos) - this->d_blockManager.data();
     std::for_each(this->d_blockManager.begin() + offset, this->d_blockManager.end(),
         [pos](Block& block) noexcept {
@@ -483,21 +849,18 @@ inline typename inline_vector<T, Allocator>::iterator inline_vector<T, Allocator
     }
 }
 
-template <typename T, typename Allocator>
-inline typename inline_vector<T, Allocator>::iterator inline_vector<T, Allocator>::erase_range(
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
+inline typename inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::iterator
+    inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::erase_range(
     const_iterator first, const_iterator last)
 {
     if (first == last) return first;
+    this->finish_relocation();
+
     auto effectiveLast = last - 1u;
 
     Block block{const_cast<T*>(first->data()), (effectiveLast->data() - first->data()) + effectiveLast->length()};
-    std::for_each(block.begin(), block.end(), [this](T& obj) noexcept {
-        std::allocator_traits<Allocator>::destroy(*this, std::addressof(obj));
-    });
-
-    std::copy(make_move_iterator_if_noexcept(block.data() + block.length()),
-        make_move_iterator_if_noexcept(this->d_buffer + this->size()),
-        block.data());
+    this->close_gap(block);
 
     std::ptrdiff_t offset = std::distance(this->d_blockManager.data(), const_cast<Block*>(first));
     std::for_each(this->d_blockManager.begin() + offset, this->d_blockManager.end(),
@@ -527,16 +890,19 @@ inline typename inline_vector<T, Allocator>::iterator inline_vector<T, Allocator
     }
 }
 
-template <typename T, typename Allocator>
-inline typename inline_vector<T, Allocator>::iterator inline_vector<T, Allocator>::insert_range(
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
+inline typename inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::iterator
+    inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::insert_range(
     const_iterator pos, span<std::add_const_t<T>> range)
 {
+    this->check_block_room();
+    this->finish_relocation();
+
     auto dist = std::distance(this->d_blockManager.data(), 
         const_cast<Block*>(pos));
     if ((this->d_capacity - this->d_size) < range.length())
     {
-        reserve(std::max(this->d_capacity * RESIZE_FACTOR + 1u,
-            this->d_capacity + range.length()));
+        this->grow(this->d_size + range.length());
     }
 
     auto it = this->d_blockManager.begin() + dist;
@@ -546,27 +912,34 @@ inline typename inline_vector<T, Allocator>::iterator inline_vector<T, Allocator
         [](std::ptrdiff_t curr, Block& block) { return curr + block.length(); });
     *it = Block{this->d_buffer + offset, range.length()};
 
+    // The last `numToConstruct` elements move past the end, into
+    // uninitialised memory, and the rest of the tail shifts up behind
+    // them. Where the range is longer than the tail, the part of it
+    // which lands past the old end is constructed rather than assigned.
     std::ptrdiff_t numToConstruct = std::min(range.length(), this->d_size - offset);
+    T* const shiftedEnd = this->d_buffer + this->d_size + range.length() - numToConstruct;
 
     try {
         std::uninitialized_copy(
             make_move_iterator_if_noexcept(this->d_buffer + this->d_size - numToConstruct),
             make_move_iterator_if_noexcept(this->d_buffer + this->d_size),
-            this->d_buffer + this->d_size
+            shiftedEnd
         );
         std::copy_backward(
             make_move_iterator_if_noexcept(this->d_buffer + offset),
             make_move_iterator_if_noexcept(this->d_buffer + this->d_size - numToConstruct),
-            this->d_buffer + this->d_size
+            shiftedEnd
         );
-        std::copy(range.begin(), range.end(), this->d_buffer + offset);
+        std::copy(range.begin(), range.begin() + numToConstruct, this->d_buffer + offset);
+        std::uninitialized_copy(range.begin() + numToConstruct, range.end(),
+            this->d_buffer + offset + numToConstruct);
     }
     catch (...)
     {
         this->d_blockManager.erase(it);
         std::copy(
             make_move_iterator_if_noexcept(this->d_buffer + offset + range.length()),
-            make_move_iterator_if_noexcept(this->d_buffer + this->d_size + numToConstruct),
+            make_move_iterator_if_noexcept(this->d_buffer + this->d_size + range.length()),
             this->d_buffer + offset
         );
         throw;
@@ -590,14 +963,17 @@ inline typename inline_vector<T, Allocator>::iterator inline_vector<T, Allocator
     }
 }
 
-template <typename T, typename Allocator>
-inline void inline_vector<T, Allocator>::push_back_range(span<std::add_const_t<T>> range)
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
+inline void
+    inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::push_back_range(
+    span<std::add_const_t<T>> range)
 {
+    this->check_block_room();
     if ((this->d_capacity - this->d_size) < range.length())
     {
-        reserve(std::max(this->d_capacity * RESIZE_FACTOR + 1u, 
-            this->d_capacity + range.length()));
+        this->grow_incrementally(this->d_size + range.length());
     }
+    this->relocate(std::max<size_type>(RELOCATION_STEP, 2u * range.length()));
 
     this->d_blockManager.emplace_back(this->d_buffer + this->d_size, range.length());
 
@@ -614,18 +990,21 @@ inline void inline_vector<T, Allocator>::push_back_range(span<std::add_const_t<T
     this->d_size += range.length();
 }
 
-template <typename T, typename Allocator>
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
 template <typename InputIt>
-inline void inline_vector<T, Allocator>::push_back_range(InputIt first, InputIt last)
+inline void inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::push_back_range(
+    InputIt first, InputIt last)
 {
+    this->check_block_room();
     if constexpr (at_least_forward_iterator_v<InputIt>)
     {
         size_type length = std::distance(first, last);
 
         if ((this->d_capacity - this->d_size) < length)
         {
-            reserve(std::max(this->d_capacity * RESIZE_FACTOR + 1u, this->d_capacity + length));
+            this->grow_incrementally(this->d_size + length);
         }
+        this->relocate(std::max<size_type>(RELOCATION_STEP, 2u * length));
 
         this->d_blockManager.emplace_back(this->d_buffer + this->d_size, length);
 
@@ -648,7 +1027,7 @@ inline void inline_vector<T, Allocator>::push_back_range(InputIt first, InputIt
             {
                 if (this->d_size == this->d_capacity)
                 {
-                    reserve(this->d_capacity * RESIZE_FACTOR + 1u);
+                    this->grow(this->d_size + 1u);
                 }
 
                 std::allocator_traits<Allocator>::construct(*this, this->d_buffer + this->d_size,
@@ -667,30 +1046,354 @@ inline void inline_vector<T, Allocator>::push_back_range(InputIt first, InputIt
                     std::allocator_traits<Allocator>::destroy(*this, std::addressof(obj));
                 }
             );
+            this->d_size -= count;
 
             throw;
         }
 
-        this->d_blockManager.emplace_back(this->d_size - count, count);
+        this->d_blockManager.emplace_back(this->d_buffer + this->d_size - count, count);
     }
 }
 
-template <typename T, typename Allocator>
-inline void inline_vector<T, Allocator>::pop_back_range() noexcept
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
+inline void inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::pop_back_range() noexcept
 {
-    assert(!this->empty());
-    auto [start_pos, length] = this->d_blockManager.back();
+    assert(!this->d_blockManager.empty());
+    Block block = this->d_blockManager.back();
 
-    std::for_each(this->d_buffer + start_pos, this->d_buffer + start_pos + length,
+    std::for_each(block.begin(), block.end(),
         [this](T& obj) noexcept { 
             std::allocator_traits<Allocator>::destroy(*this, std::addressof(obj)); 
         }
     );
 
+    this->d_size -= block.length();
     this->d_blockManager.pop_back();
-    this->d_size = start_pos;
+
+    if constexpr (RELOCATION_STEP > 0u)
+    {
+        // The block may have been waiting to be relocated, in
+        // which case the old buffer may now be empty.
+        this->d_relocationEnd = std::min(this->d_relocationEnd, this->num_ranges());
+        this->relocate(0u);
+    }
 }
 
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
+template <typename Compare>
+inline void inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::sort_ranges(Compare compare)
+{
+    this->finish_relocation();
+    std::sort(this->d_blockManager.begin(), this->d_blockManager.end(), compare);
+    this->lay_out_in_block_order();
+}
+
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
+template <typename Compare>
+inline void inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::stable_sort_ranges(
+    Compare compare)
+{
+    this->finish_relocation();
+    std::stable_sort(this->d_blockManager.begin(), this->d_blockManager.end(), compare);
+    this->lay_out_in_block_order();
+}
+
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
+inline void inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::permute_ranges(
+    span<const size_type> permutation)
+{
+    // A repeated index would copy a range twice and overrun the buffer.
+    std::vector<bool> seen(this->num_ranges(), false);
+    if (permutation.length() != seen.size()
+        || !std::all_of(permutation.begin(), permutation.end(), [&seen](size_type index) {
+            if (index >= seen.size() || seen[index]) return false;
+            seen[index] = true;
+            return true;
+        }))
+    {
+        throw std::invalid_argument{"Not a permutation of the ranges"};
+    }
+
+    this->finish_relocation();
+
+    BlockManager permuted = make_block_manager(*this);
+    permuted.reserve(this->num_ranges());
+    std::for_each(permutation.begin(), permutation.end(), [this, &permuted](size_type index) {
+        permuted.push_back(this->d_blockManager[index]);
+    });
+    std::copy(permuted.begin(), permuted.end(), this->d_blockManager.begin());
+
+    this->lay_out_in_block_order();
+}
+
+// Helpers
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
+inline void inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::check_block_room() const
+{
+    if (this->d_blockManager.size() == this->d_blockManager.max_size())
+    {
+        throw std::length_error{"No room for another range"};
+    }
+}
+
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
+inline void inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::close_gap(Block gap)
+{
+    // The elements after the gap are shifted down over it, which leaves
+    // the same number of (moved-from) elements to destroy at the end.
+    std::copy(make_move_iterator_if_noexcept(gap.data() + gap.length()),
+        make_move_iterator_if_noexcept(this->d_buffer + this->d_size),
+        gap.data());
+    std::for_each(this->d_buffer + this->d_size - gap.length(), this->d_buffer + this->d_size,
+        [this](T& obj) noexcept {
+            std::allocator_traits<Allocator>::destroy(*this, std::addressof(obj));
+        });
+    this->d_size -= gap.length();
+}
+
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
+inline void inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::grow(size_type required)
+{
+    this->reserve(GrowthPolicy::template next_capacity<T>(this->d_capacity, required));
+}
+
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
+inline void inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::reallocate(size_type new_cap)
+{
+    T* newBuff = std::allocator_traits<Allocator>::allocate(*this,
+        new_cap);
+
+    try {
+        safe_uninitialized_copy(make_move_iterator_if_noexcept(this->d_buffer),
+            make_move_iterator_if_noexcept(this->d_buffer + this->d_size),
+            newBuff, static_cast<Allocator&>(*this));
+        std::swap(d_buffer, newBuff);
+        std::for_each(newBuff, newBuff + this->d_size, [this](T& obj) noexcept {
+            std::allocator_traits<Allocator>::destroy(*this, std::addressof(obj));
+        });
+        std::for_each(this->d_blockManager.begin(), this->d_blockManager.end(),
+            [this, newBuff](Block& block) noexcept {
+                block = Block{this->d_buffer + (block.data() - newBuff),
+                              block.length()};
+            }
+        );
+        if (newBuff)
+        {
+            std::allocator_traits<Allocator>::deallocate(*this, newBuff, this->d_capacity);
+        }
+        this->d_capacity = new_cap;
+    }
+    catch (...)
+    {
+        std::allocator_traits<Allocator>::deallocate(*this, newBuff, new_cap);
+        throw;
+    }
+}
+
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
+inline void inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::lay_out_in_block_order()
+{
+    if (this->d_size == 0u) return;
+
+    T* newBuff = std::allocator_traits<Allocator>::allocate(*this, this->d_capacity);
+    size_type offset = 0u;
+
+    try {
+        std::for_each(this->d_blockManager.begin(), this->d_blockManager.end(),
+            [this, newBuff, &offset](const Block& block) {
+                safe_uninitialized_copy(make_move_iterator_if_noexcept(block.begin()),
+                    make_move_iterator_if_noexcept(block.end()), newBuff + offset,
+                    static_cast<Allocator&>(*this));
+                offset += block.length();
+            }
+        );
+    }
+    catch (...)
+    {
+        // The blocks still point at the old elements, which are intact.
+        std::for_each(newBuff, newBuff + offset, [this](T& obj) noexcept {
+            std::allocator_traits<Allocator>::destroy(*this, std::addressof(obj));
+        });
+        std::allocator_traits<Allocator>::deallocate(*this, newBuff, this->d_capacity);
+        throw;
+    }
+
+    offset = 0u;
+    std::for_each(this->d_blockManager.begin(), this->d_blockManager.end(),
+        [this, newBuff, &offset](Block& block) noexcept {
+            std::for_each(block.begin(), block.end(), [this](T& obj) noexcept {
+                std::allocator_traits<Allocator>::destroy(*this, std::addressof(obj));
+            });
+            block = Block{newBuff + offset, block.length()};
+            offset += block.length();
+        }
+    );
+
+    std::allocator_traits<Allocator>::deallocate(*this, this->d_buffer, this->d_capacity);
+    this->d_buffer = newBuff;
+}
+
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
+inline void inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::grow_incrementally(
+    size_type required)
+{
+    if constexpr (RELOCATION_STEP == 0u)
+    {
+        this->grow(required);
+    }
+    else
+    {
+        this->finish_relocation();
+        const size_type new_cap =
+            GrowthPolicy::template next_capacity<T>(this->d_capacity, required);
+
+        if constexpr (has_try_expand_v<Allocator>)
+        {
+            if (this->d_buffer && static_cast<Allocator&>(*this).try_expand(this->d_buffer,
+                this->d_capacity, new_cap))
+            {
+                this->d_capacity = new_cap;
+                return;
+            }
+        }
+
+        if (this->d_size == 0u)
+        {
+            this->reallocate(new_cap);
+            return;
+        }
+
+        // Nothing is committed until the new buffer exists, so a
+        // throwing allocation leaves the container as it was.
+        T* newBuff = std::allocator_traits<Allocator>::allocate(*this, new_cap);
+
+        this->d_oldBuffer = this->d_buffer;
+        this->d_oldCapacity = this->d_capacity;
+        this->d_relocatedBlocks = 0u;
+        this->d_relocationEnd = this->d_blockManager.size();
+
+        this->d_buffer = newBuff;
+        this->d_capacity = new_cap;
+    }
+}
+
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
+inline void inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::relocate(size_type budget)
+{
+    if constexpr (RELOCATION_STEP > 0u)
+    {
+        if (!this->d_oldBuffer) return;
+
+        size_type numRelocated = 0u;
+        while (numRelocated < budget && this->d_relocatedBlocks != this->d_relocationEnd)
+        {
+            Block& block = this->d_blockManager[this->d_relocatedBlocks];
+            T* destination = this->d_buffer + (block.data() - this->d_oldBuffer);
+
+            safe_uninitialized_copy(make_move_iterator_if_noexcept(block.begin()),
+                make_move_iterator_if_noexcept(block.end()), destination,
+                static_cast<Allocator&>(*this));
+            std::for_each(block.begin(), block.end(), [this](T& obj) noexcept {
+                std::allocator_traits<Allocator>::destroy(*this, std::addressof(obj));
+            });
+            block = Block{destination, block.length()};
+
+            // Empty ranges still count, so that the number of blocks
+            // handled in one go is bounded too.
+            numRelocated += std::max<size_type>(block.length(), 1u);
+            ++this->d_relocatedBlocks;
+        }
+
+        if (this->d_relocatedBlocks == this->d_relocationEnd)
+        {
+            std::allocator_traits<Allocator>::deallocate(*this, this->d_oldBuffer,
+                this->d_oldCapacity);
+            this->d_oldBuffer = nullptr;
+            this->d_oldCapacity = 0u;
+        }
+    }
+}
+
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
+inline void inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::release_buffer() noexcept
+{
+    this->clear();
+    if (this->d_buffer)
+    {
+        std::allocator_traits<Allocator>::deallocate(*this, this->d_buffer, this->d_capacity);
+        this->d_buffer = nullptr;
+        this->d_capacity = 0u;
+    }
+}
+
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
+inline void inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::append_copies(
+    const inline_vector& other)
+{
+    this->reserve(this->d_size + other.d_size);
+    this->reserve_ranges(this->num_ranges() + other.num_ranges());
+    std::for_each(other.cbegin(), other.cend(), [this](auto block) {
+        push_back_range(block);
+    });
+}
+
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
+inline void inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::finish_relocation()
+{
+    this->relocate(std::numeric_limits<size_type>::max());
+}
+
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
+inline typename inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::size_type
+    inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::old_capacity() const noexcept
+{
+    if constexpr (RELOCATION_STEP > 0u)
+    {
+        return this->d_oldCapacity;
+    }
+    else
+    {
+        return 0u;
+    }
+}
+
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
+inline typename inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::BlockManager
+    inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::make_block_manager(
+    const Allocator& alloc)
+{
+    if constexpr (std::uses_allocator_v<BlockManager, ReboundAlloc<Block>>)
+    {
+        return BlockManager(ReboundAlloc<Block>(alloc));
+    }
+    else
+    {
+        return BlockManager();
+    }
+}
+
+template <typename T, typename Allocator, typename BlockPolicy, typename GrowthPolicy>
+inline typename inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::BlockManager
+    inline_vector<T, Allocator, BlockPolicy, GrowthPolicy>::make_block_manager(BlockManager&& other,
+        const Allocator& alloc)
+{
+    if constexpr (std::uses_allocator_v<BlockManager, ReboundAlloc<Block>>)
+    {
+        return BlockManager(std::move(other), ReboundAlloc<Block>(alloc));
+    }
+    else
+    {
+        return BlockManager(std::move(other));
+    }
+}
+
+namespace pmr {
+
+template <typename T>
+using inline_vector = data_structures::inline_vector<T, std::pmr::polymorphic_allocator<T>>;
+
+} // close namespace pmr
+
 } // close namespace tr::data_structures
 
 #endif // INLINE_VECTOR_HPP
@@ -1,35 +1,57 @@
 #ifndef LOCAL_BUFFERED_ALLOCATOR_HPP
 #define LOCAL_BUFFERED_ALLOCATOR_HPP
 
+#include <utility.hpp>
+
 #include <utility>
 
 namespace tr::data_structures {
 
 template <typename T, typename Buffer>
 struct LocalBufferedAllocator {
+    // An allocator which forwards all of its requests to a
+    // `Buffer` (such as `LocalBufferedResource`) which it does
+    // not own. Copies and rebound copies share the same `Buffer`.
+
 public: // Types
     using value_type = T;
     using size_type = typename Buffer::size_type;
 
+    static constexpr bool is_monotonic = is_monotonic_v<Buffer>;
+
 public: // Construction
     constexpr LocalBufferedAllocator(Buffer* buffer) noexcept;
     constexpr LocalBufferedAllocator(const LocalBufferedAllocator& other) noexcept;
+    template <typename U>
+    constexpr LocalBufferedAllocator(const LocalBufferedAllocator<U, Buffer>& other) noexcept;
 
 public: // Assignment
     constexpr LocalBufferedAllocator& operator=(const LocalBufferedAllocator& other) noexcept;
 
 public: // Allocation
-    [[nodiscard]] constexpr T* allocate(size_type n) 
-        noexcept(std::declval<Buffer>().allocate(n, alignof(T)));
-    
-    constexpr void deallocate(T* p, size_type n) 
-        noexcept(std::declval<Buffer>().deallocate(p, n));
+    [[nodiscard]] constexpr T* allocate(size_type n)
+        noexcept(noexcept(std::declval<Buffer&>().allocate(n, alignof(T))));
+
+    constexpr void deallocate(T* p, size_type n)
+        noexcept(noexcept(std::declval<Buffer&>().deallocate(p, n, alignof(T))));
+
+    // Only available if `Buffer` can grow allocations in place.
+    template <typename B = Buffer, typename = std::enable_if_t<
+        has_resource_try_expand_v<B>>>
+    [[nodiscard]] bool try_expand(T* p, size_type oldN, size_type newN) noexcept;
 
 public: // Capacity
     [[nodiscard]] constexpr size_type max_size() const noexcept;
 
+public: // Accessors
+    [[nodiscard]] constexpr Buffer* buffer() const noexcept;
+
 public: // Modifiers
-    friend void swap(LocalBufferedAllocator& lhs, LocalBufferedAllocator& rhs) noexcept;
+    friend void swap(LocalBufferedAllocator& lhs, LocalBufferedAllocator& rhs) noexcept
+    {
+        using std::swap;
+        swap(lhs.d_buffer, rhs.d_buffer);
+    }
 
 private: // Members
     Buffer* d_buffer;
@@ -38,6 +60,21 @@ private: // Members
 // =================================================================
 // INLINE DEFINITIONS
 // =================================================================
+// Comparison
+template <typename T, typename U, typename Buffer>
+inline constexpr bool operator==(const LocalBufferedAllocator<T, Buffer>& lhs,
+    const LocalBufferedAllocator<U, Buffer>& rhs) noexcept
+{
+    return lhs.buffer() == rhs.buffer();
+}
+
+template <typename T, typename U, typename Buffer>
+inline constexpr bool operator!=(const LocalBufferedAllocator<T, Buffer>& lhs,
+    const LocalBufferedAllocator<U, Buffer>& rhs) noexcept
+{
+    return !(lhs == rhs);
+}
+
 // Construction
 template <typename T, typename Buffer>
 inline constexpr LocalBufferedAllocator<T, Buffer>::LocalBufferedAllocator(Buffer* buffer) noexcept
@@ -50,44 +87,58 @@ inline constexpr LocalBufferedAllocator<T, Buffer>::LocalBufferedAllocator(
     : d_buffer(other.d_buffer)
 {}
 
+template <typename T, typename Buffer>
+template <typename U>
+inline constexpr LocalBufferedAllocator<T, Buffer>::LocalBufferedAllocator(
+    const LocalBufferedAllocator<U, Buffer>& other) noexcept
+    : d_buffer(other.buffer())
+{}
+
 // Assignment
 template <typename T, typename Buffer>
-inline constexpr LocalBufferedAllocator<T, Buffer>& LocalBufferedAllocator::operator=(
+inline constexpr LocalBufferedAllocator<T, Buffer>& LocalBufferedAllocator<T, Buffer>::operator=(
     const LocalBufferedAllocator& other) noexcept
 {
     d_buffer = other.d_buffer;
+    return *this;
 }
 
 // Allocation
 template <typename T, typename Buffer>
-inline constexpr T* LocalBufferedAllocator<T, Buffer>::allocate(size_type n) 
-    noexcept(std::declval<Buffer>().allocate(n, alignof(T)))
+inline constexpr T* LocalBufferedAllocator<T, Buffer>::allocate(size_type n)
+    noexcept(noexcept(std::declval<Buffer&>().allocate(n, alignof(T))))
 {
-    return reinterpret_cast<T*>(d_buffer->allocate(sizeof(T) * n, alignof(T)));
+    return static_cast<T*>(d_buffer->allocate(sizeof(T) * n, alignof(T)));
 }
 
 template <typename T, typename Buffer>
 inline constexpr void LocalBufferedAllocator<T, Buffer>::deallocate(T* p, size_type n)
-    noexcept(std::declval<Buffer>().deallocate(p, n))
+    noexcept(noexcept(std::declval<Buffer&>().deallocate(p, n, alignof(T))))
+{
+    d_buffer->deallocate(p, sizeof(T) * n, alignof(T));
+}
+
+template <typename T, typename Buffer>
+template <typename, typename>
+inline bool LocalBufferedAllocator<T, Buffer>::try_expand(T* p, size_type oldN,
+    size_type newN) noexcept
 {
-    d_buffer->deallocate(p, sizeof(T) * n);
+    return d_buffer->try_expand(p, sizeof(T) * oldN, sizeof(T) * newN);
 }
 
 // Capacity
 template <typename T, typename Buffer>
-inline constexpr typename LocalBufferedAllocator<T, Buffer>::size_type 
+inline constexpr typename LocalBufferedAllocator<T, Buffer>::size_type
     LocalBufferedAllocator<T, Buffer>::max_size() const noexcept
 {
-    return d_buffer->max_size();
+    return d_buffer->max_size() / sizeof(T);
 }
 
-// Modifiers
+// Accessors
 template <typename T, typename Buffer>
-inline void swap(LocalBufferedAllocator<T, Buffer>& rhs, LocalBufferedAllocator<T, Buffer>& rhs) 
-    noexcept
+inline constexpr Buffer* LocalBufferedAllocator<T, Buffer>::buffer() const noexcept
 {
-    using std::swap;
-    swap(lhs.d_buffer, rhs.d_buffer);
+    return d_buffer;
 }
 
 } // close namespace tr::data_structures
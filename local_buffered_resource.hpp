@@ -1,80 +1,536 @@
 #ifndef LOCAL_BUFFERED_RESOURCE
 #define LOCAL_BUFFERED_RESOURCE
 
-#include <bitset>
+#include <utility.hpp>
+
+#include <algorithm>
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory_resource>
 #include <new>
 #include <type_traits>
 
 namespace tr::data_structures {
 
 template <std::size_t Capacity, std::size_t Alignment = alignof(std::max_align_t)>
-struct LocalBufferedResource {
+struct LocalBufferedResource : std::pmr::memory_resource {
+    // A memory resource which hands out memory from a buffer
+    // stored inside the object itself.
+    //
+    // The buffer is split into chunks of `Alignment` bytes (but at
+    // least `MIN_CHUNK_SIZE`), and the free space is kept as maximal
+    // runs of chunks in segregated free lists, two-level as in TLSF:
+    // the first level is the power of two below a run's length and
+    // the second splits that range into `NUM_SUB_CLASSES` equal size
+    // classes. A bitmap over each level records which lists are
+    // non-empty, so finding a list whose every run is long enough
+    // takes a couple of bit scans, and allocating, freeing and
+    // growing in place all take constant time whatever the state of
+    // the buffer. The price is that a request may be passed upstream
+    // while a run just long enough for it sits in a list with shorter
+    // ones, and that a request of `n` chunks needs a free run at
+    // least one size class longer (bar the lists' heads).
+    //
+    // Each free run stores its length and list links in its first
+    // chunk, and its length again in its last, while two bitmaps mark
+    // the first and last chunk of every free run. Freeing a block
+    // checks the chunks either side of it in those bitmaps and merges
+    // it with any free neighbours. An over-aligned request looks for
+    // a run long enough to hold it at any offset, and gives back the
+    // chunks before and after the aligned block.
+    //
+    // Requests which do not fit in the local buffer are passed on
+    // to an upstream resource (the heap by default), and are
+    // routed back to it on deallocation by checking whether the
+    // address lies inside the local buffer.
+    //
+    // This is a `std::pmr::memory_resource`, so it can be used either
+    // through `LocalBufferedAllocator` or `std::pmr::polymorphic_allocator`.
+
+    static_assert(Alignment != 0u && (Alignment & (Alignment - 1u)) == 0u,
+        "Alignment must be a power of two");
+
 public: // Types
     using size_type = std::size_t;
 
 public: // Construction
-    LocalBufferedResource() = default;
-    LocalBufferedResource(const LocalBufferedAllocator&) = delete;
-    
+    explicit LocalBufferedResource(
+        std::pmr::memory_resource* upstream = std::pmr::new_delete_resource()) noexcept;
+    LocalBufferedResource(const LocalBufferedResource&) = delete;
+
 public: // Assignment
     LocalBufferedResource& operator=(const LocalBufferedResource&) = delete;
 
 public: // Allocation
-    [[nodiscard]] constexpr void* allocate(size_type numBytes, 
-        size_type alignment = alignof(std::max_align_t));
+    // Attempt to grow the allocation at `position` from `oldBytes` to
+    // `newBytes` without moving it, which succeeds if it came from the
+    // local buffer and is followed by a long enough free run.
+    [[nodiscard]] bool try_expand(void* position, size_type oldBytes, size_type newBytes) noexcept;
+
+public: // Capacity
+    [[nodiscard]] size_type max_size() const noexcept;
+
+    // This returns the number of bytes of the local buffer currently
+    // handed out, rounded up to whole chunks.
+    [[nodiscard]] size_type bytes_used() const noexcept;
+
+public: // Accessors
+    [[nodiscard]] std::pmr::memory_resource* upstream_resource() const noexcept;
+
+    // This returns whether `position` was allocated from the local buffer.
+    [[nodiscard]] bool owns(const void* position) const noexcept;
+
+private: // memory_resource interface
+    void* do_allocate(size_type numBytes, size_type alignment) override;
+    void do_deallocate(void* position, size_type numBytes, size_type alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+private: // Private Types
+    using Word = std::uint64_t;
+
+    // A size class: the free list of runs whose lengths map to it.
+    struct SizeClass {
+        size_type   d_firstLevel;
+        size_type   d_secondLevel;
+    };
+
+    [[nodiscard]] static constexpr size_type floor_log2(size_type value) noexcept;
+
+private: // Helper variables
+    static constexpr size_type MIN_CHUNK_SIZE = 16u;
+    static constexpr size_type CHUNK_SIZE = std::max(Alignment, MIN_CHUNK_SIZE);
+    static constexpr size_type NUM_CHUNKS = std::max<size_type>(1u,
+        (Capacity + CHUNK_SIZE - 1u) / CHUNK_SIZE);
+    static constexpr size_type BITS_PER_WORD = std::numeric_limits<Word>::digits;
+    static constexpr size_type NUM_WORDS = (NUM_CHUNKS + BITS_PER_WORD - 1u) / BITS_PER_WORD;
+
+    // Runs shorter than `NUM_SUB_CLASSES` chunks each have a class of
+    // their own, and every longer power-of-two range is split into
+    // `NUM_SUB_CLASSES` classes.
+    static constexpr size_type SUB_CLASS_BITS = 4u;
+    static constexpr size_type NUM_SUB_CLASSES = size_type{1u} << SUB_CLASS_BITS;
+    static constexpr size_type NUM_FIRST_LEVELS = (NUM_CHUNKS < NUM_SUB_CLASSES) ? 1u
+        : floor_log2(NUM_CHUNKS) - SUB_CLASS_BITS + 2u;
+
+    static_assert(NUM_FIRST_LEVELS <= BITS_PER_WORD);
+
+private: // Private Types
+    // Chunk indices, run lengths, and `NO_RUN`.
+    using Index = smallest_unsigned_t<NUM_CHUNKS>;
+
+    // The header kept in the first chunk of a free run. The length
+    // comes first, so that it is also where the copy kept in the
+    // last chunk goes.
+    struct FreeRun {
+        Index   d_length;
+        Index   d_next;
+        Index   d_previous;
+    };
+
+    static_assert(sizeof(FreeRun) <= MIN_CHUNK_SIZE);
+
+private: // Helper variables
+    static constexpr Index NO_RUN = static_cast<Index>(NUM_CHUNKS);
+
+private: // Helpers
+    [[nodiscard]] std::byte* base() noexcept;
+    [[nodiscard]] const std::byte* base() const noexcept;
+
+    // Allocate from the local buffer, returning `nullptr` if
+    // there is no free run to take it from.
+    [[nodiscard]] void* allocate_local(size_type numBytes, size_type alignment) noexcept;
 
-    constexpr void deallocate(void* position, size_type numBytes);
+    // The class a run of `length` chunks is filed under.
+    [[nodiscard]] static SizeClass class_of(size_type length) noexcept;
+
+    // Return the first chunk of a free run of at least `length` chunks,
+    // or `NO_RUN` if no size class can be relied on to have one.
+    [[nodiscard]] size_type find_run(size_type length) const noexcept;
+
+    [[nodiscard]] FreeRun read_run(size_type index) const noexcept;
+    void write_run(size_type index, const FreeRun& run) noexcept;
+
+    // Add the chunks `[index, index + length)` to the free runs,
+    // which must not have free neighbours, or take the run starting
+    // at `index` out of them.
+    void insert_run(size_type index, size_type length) noexcept;
+    void remove_run(size_type index) noexcept;
+
+    [[nodiscard]] static bool test(const Word* bitmap, size_type index) noexcept;
+    static void set(Word* bitmap, size_type index, bool value) noexcept;
 
 private: // Members
-    using BufferType = std::aligned_storage_t<Capacity, Alignment>;
-    
-    BufferType              d_buffer;
-    std::bitset<Capacity>   d_byteBook; // Keeps track of which bytes are allocated
-}; 
+    alignas(CHUNK_SIZE) std::byte   d_buffer[NUM_CHUNKS * CHUNK_SIZE];
+    Word                            d_runStarts[NUM_WORDS]; // Set bits start free runs
+    Word                            d_runEnds[NUM_WORDS];   // Set bits end free runs
+    Word                            d_firstLevels;          // Set bits have a non-empty class
+    Word                            d_secondLevels[NUM_FIRST_LEVELS]; // Set bits are non-empty classes
+    Index                           d_freeRuns[NUM_FIRST_LEVELS][NUM_SUB_CLASSES]; // List heads
+    size_type                       d_numUsed;
+    std::pmr::memory_resource*      d_upstream;
+};
 
 // =================================================================
 // INLINE DEFINITIONS
 // =================================================================
-// Allocation
+// Construction
+template <std::size_t Capacity, std::size_t Alignment>
+inline LocalBufferedResource<Capacity, Alignment>::LocalBufferedResource(
+    std::pmr::memory_resource* upstream) noexcept
+    : d_runStarts{}
+    , d_runEnds{}
+    , d_firstLevels(0u)
+    , d_secondLevels{}
+    , d_numUsed(0u)
+    , d_upstream(upstream)
+{
+    assert(upstream);
+
+    for (auto& heads : d_freeRuns)
+    {
+        std::fill(std::begin(heads), std::end(heads), NO_RUN);
+    }
+    this->insert_run(0u, NUM_CHUNKS);
+}
+
+// memory_resource interface
+template <std::size_t Capacity, std::size_t Alignment>
+inline void* LocalBufferedResource<Capacity, Alignment>::do_allocate(
+    size_type numBytes, size_type alignment)
+{
+    assert(alignment != 0u && (alignment & (alignment - 1u)) == 0u);
+
+    if (void* position = this->allocate_local(numBytes, alignment))
+    {
+        return position;
+    }
+
+    return this->d_upstream->allocate(numBytes, alignment);
+}
+
 template <std::size_t Capacity, std::size_t Alignment>
-inline constexpr void* LocalBufferedResource<Capacity, Alignment>::allocate(
+inline void LocalBufferedResource<Capacity, Alignment>::do_deallocate(void* position,
     size_type numBytes, size_type alignment)
 {
-    if(numBytes <= (Capacity - d_byteBook.count()))
+    if (!position) return;
+
+    if (!this->owns(position))
     {
-        throw std::bad_alloc("Unable to allocate more memory. "
-        "Buffer does not have enough contiguous space");
+        this->d_upstream->deallocate(position, numBytes, alignment);
+        return;
     }
 
-    // Find the first set of numBytes contiguous unset bits
-    // in the bitset
-    for (std::size_t index = 0u; index < Capacity; ++index)
+    size_type index = static_cast<size_type>(
+        static_cast<std::byte*>(position) - this->base()) / CHUNK_SIZE;
+    const size_type numChunks = std::max<size_type>(1u,
+        (numBytes + CHUNK_SIZE - 1u) / CHUNK_SIZE);
+    assert(!test(this->d_runStarts, index));
+    this->d_numUsed -= numChunks;
+
+    // Merge with the free runs either side, if there are any.
+    size_type length = numChunks;
+    if (index + length < NUM_CHUNKS && test(this->d_runStarts, index + length))
     {
-        std::size_t numContiguous;
-        for (numContiguous = 0u; numContiguous < (Capacity - numBytes); ++numContiguous)
+        length += this->read_run(index + length).d_length;
+        this->remove_run(index + numChunks);
+    }
+    if (index != 0u && test(this->d_runEnds, index - 1u))
+    {
+        const size_type previous = index - this->read_run(index - 1u).d_length;
+        this->remove_run(previous);
+        length += index - previous;
+        index = previous;
+    }
+
+    this->insert_run(index, length);
+}
+
+template <std::size_t Capacity, std::size_t Alignment>
+inline bool LocalBufferedResource<Capacity, Alignment>::do_is_equal(
+    const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
+
+// Allocation
+template <std::size_t Capacity, std::size_t Alignment>
+inline bool LocalBufferedResource<Capacity, Alignment>::try_expand(void* position,
+    size_type oldBytes, size_type newBytes) noexcept
+{
+    if (!position || !this->owns(position)) return false;
+
+    const size_type index = static_cast<size_type>(
+        static_cast<std::byte*>(position) - this->base()) / CHUNK_SIZE;
+    const size_type oldChunks = std::max<size_type>(1u,
+        (oldBytes + CHUNK_SIZE - 1u) / CHUNK_SIZE);
+    const size_type newChunks = (newBytes + CHUNK_SIZE - 1u) / CHUNK_SIZE;
+
+    if (newChunks <= oldChunks) return true;
+
+    const size_type next = index + oldChunks;
+    if (next >= NUM_CHUNKS || !test(this->d_runStarts, next)) return false;
+
+    const size_type nextLength = this->read_run(next).d_length;
+    const size_type extra = newChunks - oldChunks;
+    if (extra > nextLength) return false;
+
+    this->remove_run(next);
+    if (extra != nextLength)
+    {
+        this->insert_run(next + extra, nextLength - extra);
+    }
+    this->d_numUsed += extra;
+    return true;
+}
+
+// Capacity
+template <std::size_t Capacity, std::size_t Alignment>
+inline typename LocalBufferedResource<Capacity, Alignment>::size_type
+    LocalBufferedResource<Capacity, Alignment>::max_size() const noexcept
+{
+    return std::numeric_limits<size_type>::max();
+}
+
+template <std::size_t Capacity, std::size_t Alignment>
+inline typename LocalBufferedResource<Capacity, Alignment>::size_type
+    LocalBufferedResource<Capacity, Alignment>::bytes_used() const noexcept
+{
+    return this->d_numUsed * CHUNK_SIZE;
+}
+
+// Accessors
+template <std::size_t Capacity, std::size_t Alignment>
+inline std::pmr::memory_resource*
+    LocalBufferedResource<Capacity, Alignment>::upstream_resource() const noexcept
+{
+    return this->d_upstream;
+}
+
+template <std::size_t Capacity, std::size_t Alignment>
+inline bool LocalBufferedResource<Capacity, Alignment>::owns(const void* position)
+    const noexcept
+{
+    const auto* bytePosition = static_cast<const std::byte*>(position);
+    return !std::less<const std::byte*>{}(bytePosition, this->base())
+        && std::less<const std::byte*>{}(bytePosition, this->base() + NUM_CHUNKS * CHUNK_SIZE);
+}
+
+// Helpers
+template <std::size_t Capacity, std::size_t Alignment>
+inline constexpr typename LocalBufferedResource<Capacity, Alignment>::size_type
+    LocalBufferedResource<Capacity, Alignment>::floor_log2(size_type value) noexcept
+{
+    size_type log = 0u;
+    while (value >>= 1u) ++log;
+    return log;
+}
+
+template <std::size_t Capacity, std::size_t Alignment>
+inline std::byte* LocalBufferedResource<Capacity, Alignment>::base() noexcept
+{
+    return this->d_buffer;
+}
+
+template <std::size_t Capacity, std::size_t Alignment>
+inline const std::byte* LocalBufferedResource<Capacity, Alignment>::base() const noexcept
+{
+    return this->d_buffer;
+}
+
+template <std::size_t Capacity, std::size_t Alignment>
+inline void* LocalBufferedResource<Capacity, Alignment>::allocate_local(
+    size_type numBytes, size_type alignment) noexcept
+{
+    const size_type numChunks = std::max<size_type>(1u,
+        (numBytes + CHUNK_SIZE - 1u) / CHUNK_SIZE);
+
+    // An over-aligned block can start anywhere in its first `step`
+    // chunks, so it needs a run that much longer.
+    const size_type step = std::max<size_type>(1u, alignment / CHUNK_SIZE);
+    if (numBytes > NUM_CHUNKS * CHUNK_SIZE || numChunks > NUM_CHUNKS - this->d_numUsed
+        || step - 1u > NUM_CHUNKS - numChunks)
+    {
+        return nullptr;
+    }
+
+    const size_type index = this->find_run(numChunks + step - 1u);
+    if (index == NO_RUN) return nullptr;
+
+    const size_type length = this->read_run(index).d_length;
+    this->remove_run(index);
+
+    size_type start = index;
+    if (step != 1u)
+    {
+        const auto address = reinterpret_cast<std::uintptr_t>(this->base() + index * CHUNK_SIZE);
+        start += ((alignment - address % alignment) % alignment) / CHUNK_SIZE;
+        if (start != index)
         {
-            if (const_cast<const std::bitset<Capacity>>(d_byteBook)[i])
+            this->insert_run(index, start - index);
+        }
+    }
+    if (start + numChunks != index + length)
+    {
+        this->insert_run(start + numChunks, index + length - start - numChunks);
+    }
+
+    this->d_numUsed += numChunks;
+    return this->base() + start * CHUNK_SIZE;
+}
+
+template <std::size_t Capacity, std::size_t Alignment>
+inline typename LocalBufferedResource<Capacity, Alignment>::SizeClass
+    LocalBufferedResource<Capacity, Alignment>::class_of(size_type length) noexcept
+{
+    if (length < NUM_SUB_CLASSES) return {0u, length};
+
+    const size_type log = BITS_PER_WORD - 1u - count_leading_zeros(length);
+    return {log - SUB_CLASS_BITS + 1u, (length >> (log - SUB_CLASS_BITS)) - NUM_SUB_CLASSES};
+}
+
+template <std::size_t Capacity, std::size_t Alignment>
+inline typename LocalBufferedResource<Capacity, Alignment>::size_type
+    LocalBufferedResource<Capacity, Alignment>::find_run(size_type length) const noexcept
+{
+    // Every run in the classes after the one `length` falls in is long
+    // enough, so round up to the next class and take the first run
+    // there or above.
+    size_type rounded = length;
+    if (length >= NUM_SUB_CLASSES)
+    {
+        const size_type log = BITS_PER_WORD - 1u - count_leading_zeros(length);
+        rounded += (size_type{1u} << (log - SUB_CLASS_BITS)) - 1u;
+    }
+
+    const SizeClass sizeClass = class_of(rounded);
+    if (sizeClass.d_firstLevel < NUM_FIRST_LEVELS)
+    {
+        Word secondLevels = this->d_secondLevels[sizeClass.d_firstLevel]
+            & (~Word{0} << sizeClass.d_secondLevel);
+        size_type firstLevel = sizeClass.d_firstLevel;
+        if (secondLevels == 0u)
+        {
+            const Word firstLevels = (firstLevel + 1u == BITS_PER_WORD) ? 0u
+                : this->d_firstLevels & (~Word{0} << (firstLevel + 1u));
+            if (firstLevels != 0u)
             {
-                break;
+                firstLevel = count_trailing_zeros(firstLevels);
+                secondLevels = this->d_secondLevels[firstLevel];
             }
         }
+        if (secondLevels != 0u)
+        {
+            return this->d_freeRuns[firstLevel][count_trailing_zeros(secondLevels)];
+        }
+    }
+
+    // Otherwise the head of `length`'s own class may still be long enough.
+    const SizeClass ownClass = class_of(length);
+    const size_type head = this->d_freeRuns[ownClass.d_firstLevel][ownClass.d_secondLevel];
+    if (head != NO_RUN && this->read_run(head).d_length >= length)
+    {
+        return head;
+    }
+    return NO_RUN;
+}
+
+template <std::size_t Capacity, std::size_t Alignment>
+inline typename LocalBufferedResource<Capacity, Alignment>::FreeRun
+    LocalBufferedResource<Capacity, Alignment>::read_run(size_type index) const noexcept
+{
+    FreeRun run;
+    std::memcpy(&run, this->base() + index * CHUNK_SIZE, sizeof(FreeRun));
+    return run;
+}
+
+template <std::size_t Capacity, std::size_t Alignment>
+inline void LocalBufferedResource<Capacity, Alignment>::write_run(size_type index,
+    const FreeRun& run) noexcept
+{
+    std::memcpy(this->base() + index * CHUNK_SIZE, &run, sizeof(FreeRun));
+}
+
+template <std::size_t Capacity, std::size_t Alignment>
+inline void LocalBufferedResource<Capacity, Alignment>::insert_run(size_type index,
+    size_type length) noexcept
+{
+    assert(length != 0u && index + length <= NUM_CHUNKS);
+
+    const SizeClass sizeClass = class_of(length);
+    Index& head = this->d_freeRuns[sizeClass.d_firstLevel][sizeClass.d_secondLevel];
+    if (head != NO_RUN)
+    {
+        FreeRun next = this->read_run(head);
+        next.d_previous = static_cast<Index>(index);
+        this->write_run(head, next);
+    }
 
-        if (numContiguous == numBytes - 1u)
+    const auto runLength = static_cast<Index>(length);
+    std::memcpy(this->base() + (index + length - 1u) * CHUNK_SIZE, &runLength, sizeof(Index));
+    this->write_run(index, FreeRun{runLength, head, NO_RUN});
+    head = static_cast<Index>(index);
+
+    this->d_firstLevels |= Word{1u} << sizeClass.d_firstLevel;
+    this->d_secondLevels[sizeClass.d_firstLevel] |= Word{1u} << sizeClass.d_secondLevel;
+    set(this->d_runStarts, index, true);
+    set(this->d_runEnds, index + length - 1u, true);
+}
+
+template <std::size_t Capacity, std::size_t Alignment>
+inline void LocalBufferedResource<Capacity, Alignment>::remove_run(size_type index) noexcept
+{
+    assert(test(this->d_runStarts, index));
+
+    const FreeRun run = this->read_run(index);
+    if (run.d_next != NO_RUN)
+    {
+        FreeRun next = this->read_run(run.d_next);
+        next.d_previous = run.d_previous;
+        this->write_run(run.d_next, next);
+    }
+    if (run.d_previous != NO_RUN)
+    {
+        FreeRun previous = this->read_run(run.d_previous);
+        previous.d_next = run.d_next;
+        this->write_run(run.d_previous, previous);
+    }
+    else
+    {
+        const SizeClass sizeClass = class_of(run.d_length);
+        this->d_freeRuns[sizeClass.d_firstLevel][sizeClass.d_secondLevel] = run.d_next;
+        if (run.d_next == NO_RUN)
         {
-            for (numContiguous = 0u; numContiguous < numBytes; ++numContiguous)
+            Word& secondLevels = this->d_secondLevels[sizeClass.d_firstLevel];
+            secondLevels &= ~(Word{1u} << sizeClass.d_secondLevel);
+            if (secondLevels == 0u)
             {
-                d_byteBook.set(index + numContiguous);
+                this->d_firstLevels &= ~(Word{1u} << sizeClass.d_firstLevel);
             }
-
-            return reinterpret_cast<void*>(
-                reinterpret_cast<std::byte*>(std::addressof(d_buffer))
-                + index);
         }
     }
 
-    throw std::bad_alloc("Unable to allocate more memory. "
-        "Buffer does not have enough contiguous space");
+    set(this->d_runStarts, index, false);
+    set(this->d_runEnds, index + run.d_length - 1u, false);
+}
+
+template <std::size_t Capacity, std::size_t Alignment>
+inline bool LocalBufferedResource<Capacity, Alignment>::test(const Word* bitmap,
+    size_type index) noexcept
+{
+    return (bitmap[index / BITS_PER_WORD] >> (index % BITS_PER_WORD)) & 1u;
+}
+
+template <std::size_t Capacity, std::size_t Alignment>
+inline void LocalBufferedResource<Capacity, Alignment>::set(Word* bitmap, size_type index,
+    bool value) noexcept
+{
+    const Word bit = Word{1u} << (index % BITS_PER_WORD);
+    if (value) { bitmap[index / BITS_PER_WORD] |= bit; }
+    else       { bitmap[index / BITS_PER_WORD] &= ~bit; }
 }
 
 } // close namespace tr::data_structures
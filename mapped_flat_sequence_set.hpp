@@ -0,0 +1,774 @@
+#ifndef MAPPED_FLAT_SEQUENCE_SET_HPP
+#define MAPPED_FLAT_SEQUENCE_SET_HPP
+
+#include <span.hpp>
+#include <utility.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstdio>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// A read-only `flat_sequence_set` which lives in a file, so that many
+// processes can map the same one and share a single copy of it in the
+// page cache. Opening one only maps the file, so it is ready at once and
+// pages are read in as lookups touch them.
+//
+// The file holds, in the writer's byte order:
+//
+//      header      64 bytes: the magic "TRMFSS1", then as `uint64_t`s
+//                  the element size, the number of ranges, the number
+//                  of elements and the positions of the offsets and
+//                  the payload in the file
+//      offsets     one `uint64_t` per range, plus one: where each range
+//                  starts in the payload, in elements, and where the
+//                  last one ends
+//      payload     the elements of every range in sorted order,
+//                  aligned to a cache line
+//
+// The offset table doubles as the search index: a lookup binary
+// searches it, only touching the payload of the ranges it compares.
+
+namespace tr::data_structures {
+
+template <typename T, typename Compare = std::less<>>
+class mapped_flat_sequence_set : private Compare {
+    // This is a view of a set written by `write_mapped_flat_sequence_set`.
+    // It has the same lookup interface as `flat_sequence_set`, but
+    // its ranges are read-only and are returned by value.
+
+    static_assert(std::is_trivially_copyable_v<T>);
+
+public: // Types
+    class const_iterator;
+
+    using value_type = span<const T>;
+    using reference = span<const T>;
+    using const_reference = span<const T>;
+    using iterator = const_iterator;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    using key_type = span<const T>;
+
+public: // Constructors
+    // Map the set written to `path`. This throws `std::system_error` if
+    // the file can't be mapped and `std::runtime_error` if it doesn't
+    // hold a set of `T`.
+    explicit mapped_flat_sequence_set(const char* path, const Compare& compare = {});
+    mapped_flat_sequence_set(const mapped_flat_sequence_set&) = delete;
+    mapped_flat_sequence_set(mapped_flat_sequence_set&& other) noexcept;
+    ~mapped_flat_sequence_set();
+
+public: // Assignment
+    mapped_flat_sequence_set& operator=(const mapped_flat_sequence_set&) = delete;
+    mapped_flat_sequence_set& operator=(mapped_flat_sequence_set&& other) noexcept;
+
+public: // Accessors
+    [[nodiscard]] span<const T> operator[](size_type index) const noexcept;
+    [[nodiscard]] span<const T> at(size_type index) const;
+    [[nodiscard]] span<const T> front() const noexcept;
+    [[nodiscard]] span<const T> back() const noexcept;
+
+    [[nodiscard]] const Compare& get_compare() const noexcept;
+
+public: // Capacity
+    [[nodiscard]] bool empty() const noexcept;
+
+    // This returns the number of `T`s in the set.
+    [[nodiscard]] size_type size() const noexcept;
+
+    // This returns the number of ranges in the set.
+    [[nodiscard]] size_type num_ranges() const noexcept;
+
+public: // Iteration
+    [[nodiscard]] const_iterator begin() const noexcept;
+    [[nodiscard]] const_iterator cbegin() const noexcept;
+    [[nodiscard]] const_iterator end() const noexcept;
+    [[nodiscard]] const_iterator cend() const noexcept;
+
+public: // Lookup
+    [[nodiscard]] const_iterator find(key_type key) const;
+
+    // Look up every key in `keys`, writing where each was found (or
+    // `end()`) to the same index in `out`, overlapping the searches'
+    // cache and page misses as `flat_sequence_set::find_batch` does.
+    void find_batch(span<const key_type> keys, span<const_iterator> out) const;
+
+private: // Helper variables
+    static constexpr size_type FIND_BATCH_GROUP = 16u;
+
+private: // Helpers
+    void unmap() noexcept;
+
+private: // Members
+    void*                   d_mapping;
+    size_type               d_mappingBytes;
+    const std::uint64_t*    d_offsets;
+    const T*                d_payload;
+    size_type               d_numRanges;
+};
+
+template <typename T, typename Compare>
+class mapped_flat_sequence_set<T, Compare>::const_iterator {
+    // A random access iterator over the ranges, which are
+    // made on the fly from the offset table.
+
+public: // Types
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = span<const T>;
+    using reference = span<const T>;
+    using pointer = void;
+    using difference_type = std::ptrdiff_t;
+
+public: // Constructors
+    const_iterator() noexcept = default;
+    const_iterator(const std::uint64_t* offset, const T* payload) noexcept;
+
+public: // Access
+    [[nodiscard]] reference operator*() const noexcept;
+    [[nodiscard]] reference operator[](difference_type n) const noexcept;
+
+public: // Arithmetic
+    const_iterator& operator++() noexcept;
+    const_iterator operator++(int) noexcept;
+    const_iterator& operator--() noexcept;
+    const_iterator operator--(int) noexcept;
+    const_iterator& operator+=(difference_type n) noexcept;
+    const_iterator& operator-=(difference_type n) noexcept;
+
+    [[nodiscard]] friend const_iterator operator+(const_iterator it, difference_type n) noexcept
+    {
+        return it += n;
+    }
+
+    [[nodiscard]] friend const_iterator operator+(difference_type n, const_iterator it) noexcept
+    {
+        return it += n;
+    }
+
+    [[nodiscard]] friend const_iterator operator-(const_iterator it, difference_type n) noexcept
+    {
+        return it -= n;
+    }
+
+    [[nodiscard]] friend difference_type operator-(const const_iterator& lhs,
+        const const_iterator& rhs) noexcept
+    {
+        return lhs.d_offset - rhs.d_offset;
+    }
+
+public: // Comparison
+    [[nodiscard]] friend bool operator==(const const_iterator& lhs,
+        const const_iterator& rhs) noexcept
+    {
+        return lhs.d_offset == rhs.d_offset;
+    }
+
+    [[nodiscard]] friend bool operator!=(const const_iterator& lhs,
+        const const_iterator& rhs) noexcept
+    {
+        return lhs.d_offset != rhs.d_offset;
+    }
+
+    [[nodiscard]] friend bool operator<(const const_iterator& lhs,
+        const const_iterator& rhs) noexcept
+    {
+        return lhs.d_offset < rhs.d_offset;
+    }
+
+    [[nodiscard]] friend bool operator>(const const_iterator& lhs,
+        const const_iterator& rhs) noexcept
+    {
+        return rhs < lhs;
+    }
+
+    [[nodiscard]] friend bool operator<=(const const_iterator& lhs,
+        const const_iterator& rhs) noexcept
+    {
+        return !(rhs < lhs);
+    }
+
+    [[nodiscard]] friend bool operator>=(const const_iterator& lhs,
+        const const_iterator& rhs) noexcept
+    {
+        return !(lhs < rhs);
+    }
+
+private: // Friends
+    friend class mapped_flat_sequence_set;
+
+private: // Members
+    const std::uint64_t*    d_offset = nullptr;
+    const T*                d_payload = nullptr;
+};
+
+// Write the ranges of `set` (a `flat_sequence_set`, or anything else
+// holding sorted ranges of `T`) to `path` in the format which
+// `mapped_flat_sequence_set` maps, replacing the file if it exists.
+// The set is written to `path` with ".tmp" appended, synced and then
+// renamed over `path`, so processes which have the old file mapped
+// keep seeing it whole and a failure part way leaves it untouched.
+// This throws `std::system_error` if the file can't be written.
+template <typename Ranges>
+void write_mapped_flat_sequence_set(const char* path, const Ranges& set);
+
+// =================================================================
+// INLINE DEFINITIONS
+// =================================================================
+namespace detail {
+
+inline constexpr char MAPPED_SET_MAGIC[8u] = "TRMFSS1";
+inline constexpr std::size_t MAPPED_SET_ALIGNMENT = 64u;
+
+struct MappedSetHeader {
+    char            d_magic[8u];
+    std::uint64_t   d_elementSize;
+    std::uint64_t   d_numRanges;
+    std::uint64_t   d_numElements;
+    std::uint64_t   d_offsetsPosition;
+    std::uint64_t   d_payloadPosition;
+    std::uint64_t   d_reserved[2u];
+};
+
+static_assert(sizeof(MappedSetHeader) == MAPPED_SET_ALIGNMENT);
+
+class BufferedFileWriter {
+    // Collects small writes into large ones, in a temporary file next
+    // to `path` which only replaces it once it is complete.
+
+public: // Construction
+    explicit BufferedFileWriter(const char* path);
+    BufferedFileWriter(const BufferedFileWriter&) = delete;
+    ~BufferedFileWriter();
+
+public: // Assignment
+    BufferedFileWriter& operator=(const BufferedFileWriter&) = delete;
+
+public: // Writing
+    void write(const void* data, std::size_t numBytes);
+    void pad_to(std::size_t position);
+
+    // Write out anything buffered, sync the file to disk and rename
+    // it over the destination. If this isn't called (or throws) the
+    // temporary file is removed and the destination left as it was.
+    void commit();
+
+    [[nodiscard]] std::size_t position() const noexcept;
+
+private: // Helpers
+    void flush();
+
+private: // Helper variables
+    static constexpr std::size_t BUFFER_BYTES = std::size_t{1u} << 20u;
+
+private: // Members
+    std::vector<char>   d_buffer;
+    std::string         d_path;
+    std::string         d_temporaryPath;
+    std::size_t         d_position;
+    int                 d_fd;
+    bool                d_committed;
+};
+
+inline BufferedFileWriter::BufferedFileWriter(const char* path)
+    : d_path(path)
+    , d_temporaryPath(this->d_path + ".tmp")
+    , d_position(0u)
+    , d_fd(::open(this->d_temporaryPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644))
+    , d_committed(false)
+{
+    if (this->d_fd < 0)
+    {
+        throw std::system_error{errno, std::generic_category(), this->d_temporaryPath};
+    }
+    this->d_buffer.reserve(BUFFER_BYTES);
+}
+
+inline BufferedFileWriter::~BufferedFileWriter()
+{
+    if (this->d_fd >= 0)
+    {
+        ::close(this->d_fd);
+    }
+    if (!this->d_committed)
+    {
+        ::unlink(this->d_temporaryPath.c_str());
+    }
+}
+
+inline void BufferedFileWriter::write(const void* data, std::size_t numBytes)
+{
+    const char* bytes = static_cast<const char*>(data);
+    while (numBytes > 0u)
+    {
+        if (this->d_buffer.size() == BUFFER_BYTES)
+        {
+            this->flush();
+        }
+        const std::size_t count = std::min(numBytes, BUFFER_BYTES - this->d_buffer.size());
+        this->d_buffer.insert(this->d_buffer.end(), bytes, bytes + count);
+        this->d_position += count;
+        bytes += count;
+        numBytes -= count;
+    }
+}
+
+inline void BufferedFileWriter::pad_to(std::size_t position)
+{
+    assert(position >= this->d_position);
+    static constexpr char ZEROS[MAPPED_SET_ALIGNMENT] = {};
+    while (this->d_position < position)
+    {
+        this->write(ZEROS, std::min(position - this->d_position, sizeof(ZEROS)));
+    }
+}
+
+inline void BufferedFileWriter::commit()
+{
+    this->flush();
+    if (::fsync(this->d_fd) != 0)
+    {
+        throw std::system_error{errno, std::generic_category(), "fsync"};
+    }
+
+    const int fd = std::exchange(this->d_fd, -1);
+    if (::close(fd) != 0)
+    {
+        throw std::system_error{errno, std::generic_category(), "close"};
+    }
+    if (::rename(this->d_temporaryPath.c_str(), this->d_path.c_str()) != 0)
+    {
+        throw std::system_error{errno, std::generic_category(), this->d_path};
+    }
+    this->d_committed = true;
+}
+
+inline std::size_t BufferedFileWriter::position() const noexcept
+{
+    return this->d_position;
+}
+
+inline void BufferedFileWriter::flush()
+{
+    const char* data = this->d_buffer.data();
+    std::size_t remaining = this->d_buffer.size();
+    while (remaining > 0u)
+    {
+        const ssize_t numWritten = ::write(this->d_fd, data, remaining);
+        if (numWritten < 0)
+        {
+            if (errno == EINTR) continue;
+            throw std::system_error{errno, std::generic_category(), "write"};
+        }
+        data += numWritten;
+        remaining -= numWritten;
+    }
+    this->d_buffer.clear();
+}
+
+} // close namespace detail
+
+// mapped_flat_sequence_set::const_iterator
+template <typename T, typename Compare>
+inline mapped_flat_sequence_set<T, Compare>::const_iterator::const_iterator(
+    const std::uint64_t* offset, const T* payload) noexcept
+    : d_offset(offset)
+    , d_payload(payload)
+{}
+
+template <typename T, typename Compare>
+inline typename mapped_flat_sequence_set<T, Compare>::const_iterator::reference
+    mapped_flat_sequence_set<T, Compare>::const_iterator::operator*() const noexcept
+{
+    return {this->d_payload + this->d_offset[0u], this->d_payload + this->d_offset[1u]};
+}
+
+template <typename T, typename Compare>
+inline typename mapped_flat_sequence_set<T, Compare>::const_iterator::reference
+    mapped_flat_sequence_set<T, Compare>::const_iterator::operator[](
+    difference_type n) const noexcept
+{
+    return *(*this + n);
+}
+
+template <typename T, typename Compare>
+inline typename mapped_flat_sequence_set<T, Compare>::const_iterator&
+    mapped_flat_sequence_set<T, Compare>::const_iterator::operator++() noexcept
+{
+    ++this->d_offset;
+    return *this;
+}
+
+template <typename T, typename Compare>
+inline typename mapped_flat_sequence_set<T, Compare>::const_iterator
+    mapped_flat_sequence_set<T, Compare>::const_iterator::operator++(int) noexcept
+{
+    const_iterator copy{*this};
+    ++this->d_offset;
+    return copy;
+}
+
+template <typename T, typename Compare>
+inline typename mapped_flat_sequence_set<T, Compare>::const_iterator&
+    mapped_flat_sequence_set<T, Compare>::const_iterator::operator--() noexcept
+{
+    --this->d_offset;
+    return *this;
+}
+
+template <typename T, typename Compare>
+inline typename mapped_flat_sequence_set<T, Compare>::const_iterator
+    mapped_flat_sequence_set<T, Compare>::const_iterator::operator--(int) noexcept
+{
+    const_iterator copy{*this};
+    --this->d_offset;
+    return copy;
+}
+
+template <typename T, typename Compare>
+inline typename mapped_flat_sequence_set<T, Compare>::const_iterator&
+    mapped_flat_sequence_set<T, Compare>::const_iterator::operator+=(
+    difference_type n) noexcept
+{
+    this->d_offset += n;
+    return *this;
+}
+
+template <typename T, typename Compare>
+inline typename mapped_flat_sequence_set<T, Compare>::const_iterator&
+    mapped_flat_sequence_set<T, Compare>::const_iterator::operator-=(
+    difference_type n) noexcept
+{
+    this->d_offset -= n;
+    return *this;
+}
+
+// Constructors
+template <typename T, typename Compare>
+inline mapped_flat_sequence_set<T, Compare>::mapped_flat_sequence_set(const char* path,
+    const Compare& compare)
+    : Compare(compare)
+    , d_mapping(nullptr)
+    , d_mappingBytes(0u)
+    , d_offsets(nullptr)
+    , d_payload(nullptr)
+    , d_numRanges(0u)
+{
+    using detail::MappedSetHeader;
+
+    const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        throw std::system_error{errno, std::generic_category(), path};
+    }
+
+    struct stat status;
+    if (::fstat(fd, &status) != 0)
+    {
+        const int error = errno;
+        ::close(fd);
+        throw std::system_error{error, std::generic_category(), path};
+    }
+    const size_type fileBytes = status.st_size;
+    if (fileBytes < sizeof(MappedSetHeader))
+    {
+        ::close(fd);
+        throw std::runtime_error{"Mapped set file is too small"};
+    }
+
+    // A shared, read-only mapping is backed directly by the page cache,
+    // so every process mapping the file shares the same pages.
+    void* mapping = ::mmap(nullptr, fileBytes, PROT_READ, MAP_SHARED, fd, 0);
+    const int error = errno;
+    ::close(fd);
+    if (mapping == MAP_FAILED)
+    {
+        throw std::system_error{error, std::generic_category(), path};
+    }
+    this->d_mapping = mapping;
+    this->d_mappingBytes = fileBytes;
+
+    MappedSetHeader header;
+    std::memcpy(&header, mapping, sizeof(header));
+
+    const auto fits = [fileBytes](std::uint64_t position, std::uint64_t count,
+        std::uint64_t size) {
+        return position <= fileBytes && count <= (fileBytes - position) / size;
+    };
+    const bool valid = std::memcmp(header.d_magic, detail::MAPPED_SET_MAGIC,
+            sizeof(header.d_magic)) == 0
+        && header.d_elementSize == sizeof(T)
+        && header.d_offsetsPosition % alignof(std::uint64_t) == 0u
+        && header.d_payloadPosition % alignof(T) == 0u
+        && header.d_numRanges < std::numeric_limits<std::uint64_t>::max()
+        && fits(header.d_offsetsPosition, header.d_numRanges + 1u, sizeof(std::uint64_t))
+        && fits(header.d_payloadPosition, header.d_numElements, sizeof(T));
+    if (!valid)
+    {
+        this->unmap();
+        throw std::runtime_error{"Mapped set file is malformed"};
+    }
+
+    const char* base = static_cast<const char*>(mapping);
+    this->d_offsets = reinterpret_cast<const std::uint64_t*>(base + header.d_offsetsPosition);
+    this->d_payload = reinterpret_cast<const T*>(base + header.d_payloadPosition);
+    this->d_numRanges = header.d_numRanges;
+
+    // Checking every offset would read the whole table, so only the
+    // ends are checked here.
+    if (this->d_offsets[0u] != 0u || this->d_offsets[this->d_numRanges] != header.d_numElements)
+    {
+        this->unmap();
+        throw std::runtime_error{"Mapped set file is malformed"};
+    }
+}
+
+template <typename T, typename Compare>
+inline mapped_flat_sequence_set<T, Compare>::mapped_flat_sequence_set(
+    mapped_flat_sequence_set&& other) noexcept
+    : Compare(static_cast<Compare&&>(other))
+    , d_mapping(std::exchange(other.d_mapping, nullptr))
+    , d_mappingBytes(std::exchange(other.d_mappingBytes, 0u))
+    , d_offsets(std::exchange(other.d_offsets, nullptr))
+    , d_payload(std::exchange(other.d_payload, nullptr))
+    , d_numRanges(std::exchange(other.d_numRanges, 0u))
+{}
+
+template <typename T, typename Compare>
+inline mapped_flat_sequence_set<T, Compare>::~mapped_flat_sequence_set()
+{
+    this->unmap();
+}
+
+// Assignment
+template <typename T, typename Compare>
+inline mapped_flat_sequence_set<T, Compare>& mapped_flat_sequence_set<T, Compare>::operator=(
+    mapped_flat_sequence_set&& other) noexcept
+{
+    if (this != &other)
+    {
+        this->unmap();
+        static_cast<Compare&>(*this) = static_cast<Compare&&>(other);
+        this->d_mapping = std::exchange(other.d_mapping, nullptr);
+        this->d_mappingBytes = std::exchange(other.d_mappingBytes, 0u);
+        this->d_offsets = std::exchange(other.d_offsets, nullptr);
+        this->d_payload = std::exchange(other.d_payload, nullptr);
+        this->d_numRanges = std::exchange(other.d_numRanges, 0u);
+    }
+    return *this;
+}
+
+// Accessors
+template <typename T, typename Compare>
+inline span<const T> mapped_flat_sequence_set<T, Compare>::operator[](size_type index)
+    const noexcept
+{
+    assert(index < this->d_numRanges);
+    return this->begin()[index];
+}
+
+template <typename T, typename Compare>
+inline span<const T> mapped_flat_sequence_set<T, Compare>::at(size_type index) const
+{
+    if (index >= this->d_numRanges) { throw std::out_of_range{"Index out of range"}; }
+    return this->operator[](index);
+}
+
+template <typename T, typename Compare>
+inline span<const T> mapped_flat_sequence_set<T, Compare>::front() const noexcept
+{
+    return this->operator[](0u);
+}
+
+template <typename T, typename Compare>
+inline span<const T> mapped_flat_sequence_set<T, Compare>::back() const noexcept
+{
+    return this->operator[](this->d_numRanges - 1u);
+}
+
+template <typename T, typename Compare>
+inline const Compare& mapped_flat_sequence_set<T, Compare>::get_compare() const noexcept
+{
+    return *this;
+}
+
+// Capacity
+template <typename T, typename Compare>
+inline bool mapped_flat_sequence_set<T, Compare>::empty() const noexcept
+{
+    return this->d_numRanges == 0u;
+}
+
+template <typename T, typename Compare>
+inline typename mapped_flat_sequence_set<T, Compare>::size_type
+    mapped_flat_sequence_set<T, Compare>::size() const noexcept
+{
+    return this->d_offsets ? this->d_offsets[this->d_numRanges] : 0u;
+}
+
+template <typename T, typename Compare>
+inline typename mapped_flat_sequence_set<T, Compare>::size_type
+    mapped_flat_sequence_set<T, Compare>::num_ranges() const noexcept
+{
+    return this->d_numRanges;
+}
+
+// Iteration
+template <typename T, typename Compare>
+inline typename mapped_flat_sequence_set<T, Compare>::const_iterator
+    mapped_flat_sequence_set<T, Compare>::begin() const noexcept
+{
+    return {this->d_offsets, this->d_payload};
+}
+
+template <typename T, typename Compare>
+inline typename mapped_flat_sequence_set<T, Compare>::const_iterator
+    mapped_flat_sequence_set<T, Compare>::cbegin() const noexcept
+{
+    return this->begin();
+}
+
+template <typename T, typename Compare>
+inline typename mapped_flat_sequence_set<T, Compare>::const_iterator
+    mapped_flat_sequence_set<T, Compare>::end() const noexcept
+{
+    return {this->d_offsets + this->d_numRanges, this->d_payload};
+}
+
+template <typename T, typename Compare>
+inline typename mapped_flat_sequence_set<T, Compare>::const_iterator
+    mapped_flat_sequence_set<T, Compare>::cend() const noexcept
+{
+    return this->end();
+}
+
+// Lookup
+template <typename T, typename Compare>
+inline typename mapped_flat_sequence_set<T, Compare>::const_iterator
+    mapped_flat_sequence_set<T, Compare>::find(key_type key) const
+{
+    const Compare& compare = *this;
+    const const_iterator it = std::lower_bound(this->begin(), this->end(), key, compare);
+    return (it != this->end() && !compare(key, *it)) ? it : this->end();
+}
+
+template <typename T, typename Compare>
+inline void mapped_flat_sequence_set<T, Compare>::find_batch(span<const key_type> keys,
+    span<const_iterator> out) const
+{
+    assert(keys.length() == out.length());
+    const Compare& compare = *this;
+
+    for (size_type group = 0u; group < keys.length(); group += FIND_BATCH_GROUP)
+    {
+        const size_type groupSize = std::min<size_type>(FIND_BATCH_GROUP, keys.length() - group);
+        const key_type* groupKeys = keys.data() + group;
+        const_iterator* bases = out.data() + group;
+        std::fill_n(bases, groupSize, this->begin());
+
+        // The same lock step, branch-free search as `flat_sequence_set`,
+        // except that a probe reads an offset rather than a block.
+        for (size_type remaining = this->d_numRanges; remaining > 1u; )
+        {
+            const size_type half = remaining / 2u;
+            for (size_type i = 0u; i < groupSize; ++i)
+            {
+                prefetch(this->d_payload + bases[i].d_offset[half]);
+            }
+            remaining -= half;
+            for (size_type i = 0u; i < groupSize; ++i)
+            {
+                if (compare(bases[i][half], groupKeys[i])) bases[i] += half;
+                prefetch(bases[i].d_offset + remaining / 2u);
+            }
+        }
+
+        for (size_type i = 0u; i < groupSize; ++i)
+        {
+            const const_iterator it = (this->d_numRanges > 0u && compare(*bases[i], groupKeys[i]))
+                ? bases[i] + 1 : bases[i];
+            bases[i] = (it != this->end() && !compare(groupKeys[i], *it)) ? it : this->end();
+        }
+    }
+}
+
+// Helpers
+template <typename T, typename Compare>
+inline void mapped_flat_sequence_set<T, Compare>::unmap() noexcept
+{
+    if (this->d_mapping)
+    {
+        ::munmap(this->d_mapping, this->d_mappingBytes);
+        this->d_mapping = nullptr;
+        this->d_mappingBytes = 0u;
+        this->d_offsets = nullptr;
+        this->d_payload = nullptr;
+        this->d_numRanges = 0u;
+    }
+}
+
+// Writing
+template <typename Ranges>
+inline void write_mapped_flat_sequence_set(const char* path, const Ranges& set)
+{
+    using Element = std::remove_const_t<typename Ranges::value_type::value_type>;
+    static_assert(std::is_trivially_copyable_v<Element>);
+
+    const auto align = [](std::size_t position) {
+        const std::size_t alignment = std::max(detail::MAPPED_SET_ALIGNMENT, alignof(Element));
+        return (position + alignment - 1u) / alignment * alignment;
+    };
+
+    detail::MappedSetHeader header{};
+    std::memcpy(header.d_magic, detail::MAPPED_SET_MAGIC, sizeof(header.d_magic));
+    header.d_elementSize = sizeof(Element);
+    header.d_numRanges = std::distance(std::begin(set), std::end(set));
+    header.d_numElements = 0u;
+    for (const auto& range : set)
+    {
+        header.d_numElements += range.length();
+    }
+    header.d_offsetsPosition = sizeof(header);
+    header.d_payloadPosition = align(header.d_offsetsPosition
+        + (header.d_numRanges + 1u) * sizeof(std::uint64_t));
+
+    detail::BufferedFileWriter file{path};
+    file.write(&header, sizeof(header));
+
+    std::uint64_t offset = 0u;
+    file.write(&offset, sizeof(offset));
+    for (const auto& range : set)
+    {
+        offset += range.length();
+        file.write(&offset, sizeof(offset));
+    }
+
+    file.pad_to(header.d_payloadPosition);
+    for (const auto& range : set)
+    {
+        file.write(range.data(), range.length() * sizeof(Element));
+    }
+    file.commit();
+}
+
+} // close namespace tr::data_structures
+
+#endif // MAPPED_FLAT_SEQUENCE_SET_HPP
@@ -0,0 +1,280 @@
+#ifndef MAPPED_MEMORY_RESOURCE_HPP
+#define MAPPED_MEMORY_RESOURCE_HPP
+
+#include <utility.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory_resource>
+#include <new>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace tr::data_structures {
+
+class MappedMemoryResource : public std::pmr::memory_resource {
+    // A memory resource for very large buffers, built directly on
+    // `mmap`.
+    //
+    // Each large allocation reserves `reservationBytes` of address
+    // space up front, but only commits (makes accessible) the pages
+    // which were asked for, in whole huge pages. The committed region
+    // is marked as eligible for transparent huge pages to cut down on
+    // TLB misses. `try_expand` grows an allocation by committing more
+    // of its reservation, so it never has to move; containers using
+    // an allocator which exposes it (such as `LocalBufferedAllocator`)
+    // can grow without copying. Past the end of the reservation it
+    // tries to map the address space directly after it instead.
+    //
+    // Requests smaller than `minMappedBytes` are not worth a mapping
+    // of their own and are passed on to the upstream resource.
+
+public: // Types
+    using size_type = std::size_t;
+
+public: // Construction
+    explicit MappedMemoryResource(size_type reservationBytes = DEFAULT_RESERVATION,
+        size_type minMappedBytes = HUGE_PAGE_SIZE,
+        std::pmr::memory_resource* upstream = std::pmr::new_delete_resource()) noexcept;
+    MappedMemoryResource(const MappedMemoryResource&) = delete;
+
+public: // Assignment
+    MappedMemoryResource& operator=(const MappedMemoryResource&) = delete;
+
+public: // Allocation
+    // Attempt to grow the allocation at `position` from `oldBytes` to
+    // `newBytes` without moving it, returning whether this succeeded.
+    [[nodiscard]] bool try_expand(void* position, size_type oldBytes, size_type newBytes) noexcept;
+
+public: // Capacity
+    [[nodiscard]] size_type max_size() const noexcept;
+
+    // This returns how many bytes of the allocation at `position`
+    // (which must be a mapped allocation) are currently committed.
+    [[nodiscard]] size_type committed_bytes(const void* position) const noexcept;
+
+public: // Accessors
+    [[nodiscard]] std::pmr::memory_resource* upstream_resource() const noexcept;
+
+private: // memory_resource interface
+    void* do_allocate(size_type numBytes, size_type alignment) override;
+    void do_deallocate(void* position, size_type numBytes, size_type alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+private: // Private Types
+    struct MappingHeader {
+        void*       d_base;         // Start of the whole mapping
+        size_type   d_length;       // Length of the whole mapping
+        size_type   d_reserved;     // Bytes available from the user pointer
+        size_type   d_committed;    // Bytes accessible from the user pointer
+    };
+
+private: // Helper variables
+    static constexpr size_type HUGE_PAGE_SIZE = 2u * 1024u * 1024u;
+    static constexpr size_type DEFAULT_RESERVATION = size_type{64u} * 1024u * 1024u * 1024u;
+
+private: // Helpers
+    [[nodiscard]] static size_type page_size() noexcept;
+    [[nodiscard]] static size_type round_up(size_type numBytes, size_type multiple) noexcept;
+    [[nodiscard]] static MappingHeader* header_of(const void* position) noexcept;
+
+    // Make `[first, first + length)` readable and writable.
+    [[nodiscard]] static bool commit(std::byte* first, size_type length) noexcept;
+
+    // Reserve at least `numBytes` more address space directly after
+    // the mapping described by `header`, if it is free.
+    [[nodiscard]] bool extend_reservation(MappingHeader* header, size_type numBytes) noexcept;
+
+private: // Members
+    size_type                   d_reservationBytes;
+    size_type                   d_minMappedBytes;
+    std::pmr::memory_resource*  d_upstream;
+};
+
+// =================================================================
+// INLINE DEFINITIONS
+// =================================================================
+// Construction
+inline MappedMemoryResource::MappedMemoryResource(size_type reservationBytes,
+    size_type minMappedBytes, std::pmr::memory_resource* upstream) noexcept
+    : d_reservationBytes(round_up(reservationBytes, HUGE_PAGE_SIZE))
+    , d_minMappedBytes(minMappedBytes)
+    , d_upstream(upstream)
+{
+    assert(upstream);
+}
+
+// Allocation
+inline bool MappedMemoryResource::try_expand(void* position, size_type oldBytes,
+    size_type newBytes) noexcept
+{
+    if (!position || oldBytes < this->d_minMappedBytes) return false;
+
+    MappingHeader* header = header_of(position);
+    if (newBytes <= header->d_committed) return true;
+    if (newBytes > header->d_reserved
+        && !this->extend_reservation(header, newBytes - header->d_reserved))
+    {
+        return false;
+    }
+
+    const size_type newCommitted = std::min(round_up(newBytes, HUGE_PAGE_SIZE),
+        header->d_reserved);
+    if (!commit(static_cast<std::byte*>(position) + header->d_committed,
+        newCommitted - header->d_committed))
+    {
+        return false;
+    }
+
+    header->d_committed = newCommitted;
+    return true;
+}
+
+// Capacity
+inline MappedMemoryResource::size_type MappedMemoryResource::max_size() const noexcept
+{
+    return std::numeric_limits<size_type>::max();
+}
+
+inline MappedMemoryResource::size_type MappedMemoryResource::committed_bytes(
+    const void* position) const noexcept
+{
+    return header_of(position)->d_committed;
+}
+
+// Accessors
+inline std::pmr::memory_resource* MappedMemoryResource::upstream_resource() const noexcept
+{
+    return this->d_upstream;
+}
+
+// memory_resource interface
+inline void* MappedMemoryResource::do_allocate(size_type numBytes, size_type alignment)
+{
+    if (numBytes < this->d_minMappedBytes)
+    {
+        return this->d_upstream->allocate(numBytes, alignment);
+    }
+
+    assert(alignment <= HUGE_PAGE_SIZE);
+
+    // Reserve an extra huge page so that the user pointer can be huge
+    // page aligned with a page in front of it to hold the header.
+    const size_type reserved = std::max(this->d_reservationBytes,
+        round_up(numBytes, HUGE_PAGE_SIZE));
+    const size_type length = reserved + HUGE_PAGE_SIZE;
+
+    void* base = ::mmap(nullptr, length, PROT_NONE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (base == MAP_FAILED)
+    {
+        throw std::bad_alloc{};
+    }
+
+    auto* position = reinterpret_cast<std::byte*>(round_up(
+        reinterpret_cast<std::uintptr_t>(base) + page_size(), HUGE_PAGE_SIZE));
+    const size_type committed = round_up(numBytes, HUGE_PAGE_SIZE);
+
+    if (!commit(position - page_size(), page_size()) || !commit(position, committed))
+    {
+        ::munmap(base, length);
+        throw std::bad_alloc{};
+    }
+
+    ::new (header_of(position)) MappingHeader{base, length,
+        static_cast<size_type>(static_cast<std::byte*>(base) + length - position), committed};
+    return position;
+}
+
+inline void MappedMemoryResource::do_deallocate(void* position, size_type numBytes,
+    size_type alignment)
+{
+    if (numBytes < this->d_minMappedBytes)
+    {
+        this->d_upstream->deallocate(position, numBytes, alignment);
+        return;
+    }
+
+    const MappingHeader header = *header_of(position);
+    ::munmap(header.d_base, header.d_length);
+}
+
+inline bool MappedMemoryResource::do_is_equal(const std::pmr::memory_resource& other)
+    const noexcept
+{
+    return this == &other;
+}
+
+// Helpers
+inline MappedMemoryResource::size_type MappedMemoryResource::page_size() noexcept
+{
+    static const size_type s_pageSize = static_cast<size_type>(::sysconf(_SC_PAGESIZE));
+    return s_pageSize;
+}
+
+inline MappedMemoryResource::size_type MappedMemoryResource::round_up(size_type numBytes,
+    size_type multiple) noexcept
+{
+    return ((numBytes + multiple - 1u) / multiple) * multiple;
+}
+
+inline MappedMemoryResource::MappingHeader* MappedMemoryResource::header_of(
+    const void* position) noexcept
+{
+    return reinterpret_cast<MappingHeader*>(
+        const_cast<std::byte*>(static_cast<const std::byte*>(position)) - page_size());
+}
+
+inline bool MappedMemoryResource::commit(std::byte* first, size_type length) noexcept
+{
+    if (::mprotect(first, length, PROT_READ | PROT_WRITE) != 0) return false;
+
+#ifdef MADV_HUGEPAGE
+    if (length >= HUGE_PAGE_SIZE)
+    {
+        // Only advisory, so a failure here is not an error.
+        (void)::madvise(first, length, MADV_HUGEPAGE);
+    }
+#endif
+
+    return true;
+}
+
+inline bool MappedMemoryResource::extend_reservation(MappingHeader* header,
+    size_type numBytes) noexcept
+{
+    // Growing by whole reservations keeps the number of mappings (and
+    // so of system calls) logarithmic in the final size.
+    const size_type length = std::max(round_up(numBytes, HUGE_PAGE_SIZE),
+        this->d_reservationBytes);
+    void* end = static_cast<std::byte*>(header->d_base) + header->d_length;
+
+    // `mremap` cannot be used here since `commit` splits the mapping
+    // into several, so ask for a new mapping exactly at its end instead.
+    // Without `MAP_FIXED_NOREPLACE` the address is only a hint, which
+    // the kernel ignores if anything is already mapped there.
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE;
+#ifdef MAP_FIXED_NOREPLACE
+    flags |= MAP_FIXED_NOREPLACE;
+#endif
+
+    void* extension = ::mmap(end, length, PROT_NONE, flags, -1, 0);
+    if (extension == MAP_FAILED) return false;
+    if (extension != end)
+    {
+        ::munmap(extension, length);
+        return false;
+    }
+
+    header->d_length += length;
+    header->d_reserved += length;
+    return true;
+}
+
+} // close namespace tr::data_structures
+
+#endif // MAPPED_MEMORY_RESOURCE_HPP
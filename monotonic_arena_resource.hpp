@@ -0,0 +1,213 @@
+#ifndef MONOTONIC_ARENA_RESOURCE_HPP
+#define MONOTONIC_ARENA_RESOURCE_HPP
+
+#include <utility.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+
+namespace tr::data_structures {
+
+class MonotonicArenaResource : public std::pmr::memory_resource {
+    // A bump-pointer memory resource for short-lived groups of
+    // containers, e.g. everything built while handling a request.
+    //
+    // Memory is carved out of chunks obtained from an upstream
+    // resource, each chunk being `GROWTH_FACTOR` times larger than
+    // the last. `deallocate` does nothing; instead all memory is
+    // handed back at once by `release` (or on destruction), which
+    // costs one upstream deallocation per chunk.
+    //
+    // Containers bound to this resource through an allocator which
+    // advertises `is_monotonic` skip destroying trivially destructible
+    // elements and returning their memory.
+
+public: // Types
+    using size_type = std::size_t;
+
+    static constexpr bool is_monotonic = true;
+
+public: // Construction
+    explicit MonotonicArenaResource(size_type initialChunkSize = DEFAULT_CHUNK_SIZE,
+        std::pmr::memory_resource* upstream = std::pmr::new_delete_resource()) noexcept;
+    MonotonicArenaResource(const MonotonicArenaResource&) = delete;
+    ~MonotonicArenaResource() override;
+
+public: // Assignment
+    MonotonicArenaResource& operator=(const MonotonicArenaResource&) = delete;
+
+public: // Allocation
+    // Attempt to grow the allocation at `position` from `oldBytes` to
+    // `newBytes` without moving it, which succeeds if it was the most
+    // recent allocation and the current chunk has room.
+    [[nodiscard]] bool try_expand(void* position, size_type oldBytes, size_type newBytes) noexcept;
+
+public: // Modifiers
+    // Return every chunk to the upstream resource. All memory
+    // previously handed out by this resource becomes invalid.
+    void release() noexcept;
+
+public: // Capacity
+    [[nodiscard]] size_type max_size() const noexcept;
+
+    // This returns the number of bytes currently held from upstream.
+    [[nodiscard]] size_type bytes_reserved() const noexcept;
+
+public: // Accessors
+    [[nodiscard]] std::pmr::memory_resource* upstream_resource() const noexcept;
+
+private: // memory_resource interface
+    void* do_allocate(size_type numBytes, size_type alignment) override;
+    void do_deallocate(void* position, size_type numBytes, size_type alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+private: // Private Types
+    struct ChunkHeader {
+        ChunkHeader*    d_next;
+        size_type       d_size;
+        size_type       d_alignment;
+    };
+
+private: // Helper variables
+    static constexpr size_type DEFAULT_CHUNK_SIZE = 1024u;
+    static constexpr size_type GROWTH_FACTOR = 2u;
+
+private: // Helpers
+    // Obtain a new chunk from upstream which is large enough
+    // to satisfy a request for `numBytes` aligned to `alignment`.
+    void allocate_chunk(size_type numBytes, size_type alignment);
+
+private: // Members
+    void*                       d_current;
+    size_type                   d_remaining;
+    ChunkHeader*                d_chunks;
+    size_type                   d_initialChunkSize;
+    size_type                   d_nextChunkSize;
+    size_type                   d_bytesReserved;
+    std::pmr::memory_resource*  d_upstream;
+};
+
+// =================================================================
+// INLINE DEFINITIONS
+// =================================================================
+// Construction
+inline MonotonicArenaResource::MonotonicArenaResource(size_type initialChunkSize,
+    std::pmr::memory_resource* upstream) noexcept
+    : d_current(nullptr)
+    , d_remaining(0u)
+    , d_chunks(nullptr)
+    , d_initialChunkSize(std::max<size_type>(initialChunkSize, sizeof(ChunkHeader)))
+    , d_nextChunkSize(d_initialChunkSize)
+    , d_bytesReserved(0u)
+    , d_upstream(upstream)
+{
+    assert(upstream);
+}
+
+inline MonotonicArenaResource::~MonotonicArenaResource()
+{
+    this->release();
+}
+
+// Allocation
+inline bool MonotonicArenaResource::try_expand(void* position, size_type oldBytes,
+    size_type newBytes) noexcept
+{
+    if (!position || static_cast<std::byte*>(position) + oldBytes != this->d_current)
+    {
+        return false;
+    }
+
+    if (newBytes <= oldBytes) return true;
+    if (newBytes - oldBytes > this->d_remaining) return false;
+
+    this->d_current = static_cast<std::byte*>(this->d_current) + (newBytes - oldBytes);
+    this->d_remaining -= newBytes - oldBytes;
+    return true;
+}
+
+// Modifiers
+inline void MonotonicArenaResource::release() noexcept
+{
+    while (this->d_chunks)
+    {
+        ChunkHeader* chunk = this->d_chunks;
+        this->d_chunks = chunk->d_next;
+        this->d_upstream->deallocate(chunk, chunk->d_size, chunk->d_alignment);
+    }
+
+    this->d_current = nullptr;
+    this->d_remaining = 0u;
+    this->d_nextChunkSize = this->d_initialChunkSize;
+    this->d_bytesReserved = 0u;
+}
+
+// Capacity
+inline MonotonicArenaResource::size_type MonotonicArenaResource::max_size() const noexcept
+{
+    return std::numeric_limits<size_type>::max();
+}
+
+inline MonotonicArenaResource::size_type MonotonicArenaResource::bytes_reserved() const noexcept
+{
+    return this->d_bytesReserved;
+}
+
+// Accessors
+inline std::pmr::memory_resource* MonotonicArenaResource::upstream_resource() const noexcept
+{
+    return this->d_upstream;
+}
+
+// memory_resource interface
+inline void* MonotonicArenaResource::do_allocate(size_type numBytes, size_type alignment)
+{
+    if (!std::align(alignment, numBytes, this->d_current, this->d_remaining))
+    {
+        this->allocate_chunk(numBytes, alignment);
+        std::align(alignment, numBytes, this->d_current, this->d_remaining);
+    }
+
+    void* position = this->d_current;
+    this->d_current = static_cast<std::byte*>(this->d_current) + numBytes;
+    this->d_remaining -= numBytes;
+    return position;
+}
+
+inline void MonotonicArenaResource::do_deallocate(void*, size_type, size_type)
+{
+    // Memory is only reclaimed by `release`
+}
+
+inline bool MonotonicArenaResource::do_is_equal(
+    const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
+
+// Helpers
+inline void MonotonicArenaResource::allocate_chunk(size_type numBytes, size_type alignment)
+{
+    const size_type chunkAlignment = std::max(alignment, alignof(ChunkHeader));
+    const size_type chunkSize = std::max(this->d_nextChunkSize,
+        sizeof(ChunkHeader) + alignment + numBytes);
+
+    void* memory = this->d_upstream->allocate(chunkSize, chunkAlignment);
+    this->d_chunks = ::new (memory) ChunkHeader{this->d_chunks, chunkSize, chunkAlignment};
+    this->d_current = this->d_chunks + 1;
+    this->d_remaining = chunkSize - sizeof(ChunkHeader);
+    this->d_bytesReserved += chunkSize;
+
+    if (this->d_nextChunkSize <= std::numeric_limits<size_type>::max() / GROWTH_FACTOR)
+    {
+        this->d_nextChunkSize *= GROWTH_FACTOR;
+    }
+}
+
+} // close namespace tr::data_structures
+
+#endif // MONOTONIC_ARENA_RESOURCE_HPP
@@ -0,0 +1,459 @@
+#ifndef PARALLEL_RANGES_HPP
+#define PARALLEL_RANGES_HPP
+
+#include <span.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <iterator>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Parallel algorithms over containers of ranges, such as `inline_vector`.
+//
+// The work is split by the number of elements rather than the number
+// of ranges, since a few long ranges would otherwise leave most threads
+// idle. They run on an executor: anything with a `bulk_execute(n, f)`
+// which calls `f(i)` for every `i` in `[0, n)`, possibly concurrently,
+// and returns once all of them have.
+
+namespace tr::data_structures {
+
+class SequentialExecutor {
+    // Runs every task on the calling thread, in order.
+
+public: // Execution
+    template <typename Function>
+    void bulk_execute(std::size_t numTasks, Function function);
+
+    [[nodiscard]] std::size_t concurrency() const noexcept;
+};
+
+class ThreadPoolExecutor {
+    // A small, fixed pool of worker threads. `bulk_execute` hands task
+    // indices out from a shared counter, so whichever threads finish
+    // their tasks first pick up the rest. The calling thread works on
+    // the tasks too, so a pool with no workers runs them sequentially.
+    //
+    // If any task throws, the first exception is rethrown once every
+    // task has finished. Only one `bulk_execute` runs at a time.
+    //
+    // A task may itself call `bulk_execute` on the same pool. Every
+    // thread is already busy with the outer call, so rather than
+    // waiting on itself (or on a worker which is waiting on it) the
+    // nested call runs its tasks inline on that thread, in order, as
+    // `SequentialExecutor` would, and any exception propagates at once.
+
+public: // Construction
+    explicit ThreadPoolExecutor(std::size_t numWorkers = default_num_workers());
+    ThreadPoolExecutor(const ThreadPoolExecutor&) = delete;
+    ~ThreadPoolExecutor();
+
+public: // Assignment
+    ThreadPoolExecutor& operator=(const ThreadPoolExecutor&) = delete;
+
+public: // Execution
+    template <typename Function>
+    void bulk_execute(std::size_t numTasks, Function function);
+
+    // This returns the number of threads which run tasks, including the caller.
+    [[nodiscard]] std::size_t concurrency() const noexcept;
+
+public: // Observers
+    // This returns one fewer than the number of hardware threads, as
+    // the calling thread makes up the difference.
+    [[nodiscard]] static std::size_t default_num_workers() noexcept;
+
+private: // Helper variables
+    // The untimed `condition_variable::wait` is exported from libstdc++
+    // under GLIBCXX_3.4.30, so binaries which call it won't load against
+    // an older runtime. `wait_until` is defined in the header, and waiting
+    // against a deadline which never comes avoids that dependency.
+    static constexpr std::chrono::steady_clock::time_point NO_DEADLINE =
+        std::chrono::steady_clock::time_point::max();
+
+private: // Private Types
+    struct Job {
+        const void*                 d_function;
+        void                      (*d_invoke)(const void*, std::size_t);
+        std::size_t                 d_numTasks;
+        std::atomic<std::size_t>    d_nextTask;
+        std::size_t                 d_numWorkers;   // Guarded by `d_mutex`
+        std::exception_ptr          d_exception;    // Guarded by `d_mutex`
+    };
+
+private: // Helpers
+    // This returns the pool whose task the calling thread is running,
+    // or `nullptr` if it isn't running one.
+    [[nodiscard]] static const ThreadPoolExecutor*& running_pool() noexcept;
+
+    void run_worker();
+    void work_on(Job& job) noexcept;
+
+private: // Members
+    std::mutex                  d_submitMutex;
+    std::mutex                  d_mutex;
+    std::condition_variable     d_wake;
+    std::condition_variable     d_done;
+    Job*                        d_job;
+    std::uint64_t               d_generation;
+    bool                        d_stopping;
+    std::vector<std::thread>    d_workers;
+};
+
+// The pool used when no executor is given.
+[[nodiscard]] ThreadPoolExecutor& default_executor();
+
+// Split `ranges` into at most `numChunks` runs of consecutive ranges
+// holding roughly the same number of elements, returning the index at
+// which each run starts followed by `ranges.size()`. Each range also
+// counts as one element, so that empty ranges still cost something.
+template <typename Ranges>
+[[nodiscard]] std::vector<std::size_t> balanced_partition(const Ranges& ranges,
+    std::size_t numChunks);
+
+// Call `function` with every range of `ranges`, split between the
+// executor's threads by element count.
+template <typename Ranges, typename Function, typename Executor>
+void parallel_for_each_range(Ranges& ranges, Function function, Executor& executor);
+
+template <typename Ranges, typename Function>
+void parallel_for_each_range(Ranges& ranges, Function function);
+
+// Call `function(in, out)` with each range of `input` and the range at
+// the same index in `output`, which must already have the same shape.
+template <typename InRanges, typename OutRanges, typename Function, typename Executor>
+void parallel_transform_ranges(const InRanges& input, OutRanges& output, Function function,
+    Executor& executor);
+
+template <typename InRanges, typename OutRanges, typename Function>
+void parallel_transform_ranges(const InRanges& input, OutRanges& output, Function function);
+
+// Stably sort the ranges of `ranges`, which must be able to
+// `permute_ranges` like `inline_vector`, by `compare`. The range
+// indices are sorted in slices on the executor's threads and merged
+// pairwise, and then the elements are moved into their new order once.
+// `compare` may be called concurrently.
+template <typename Ranges, typename Compare, typename Executor>
+void parallel_sort_ranges(Ranges& ranges, Compare compare, Executor& executor);
+
+template <typename Ranges, typename Compare>
+void parallel_sort_ranges(Ranges& ranges, Compare compare);
+
+// =================================================================
+// INLINE DEFINITIONS
+// =================================================================
+// SequentialExecutor
+template <typename Function>
+inline void SequentialExecutor::bulk_execute(std::size_t numTasks, Function function)
+{
+    for (std::size_t task = 0u; task < numTasks; ++task)
+    {
+        function(task);
+    }
+}
+
+inline std::size_t SequentialExecutor::concurrency() const noexcept
+{
+    return 1u;
+}
+
+// ThreadPoolExecutor
+inline ThreadPoolExecutor::ThreadPoolExecutor(std::size_t numWorkers)
+    : d_job(nullptr)
+    , d_generation(0u)
+    , d_stopping(false)
+{
+    d_workers.reserve(numWorkers);
+    for (std::size_t i = 0u; i < numWorkers; ++i)
+    {
+        d_workers.emplace_back([this] { this->run_worker(); });
+    }
+}
+
+inline ThreadPoolExecutor::~ThreadPoolExecutor()
+{
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        d_stopping = true;
+    }
+    d_wake.notify_all();
+
+    for (std::thread& worker : d_workers)
+    {
+        worker.join();
+    }
+}
+
+template <typename Function>
+inline void ThreadPoolExecutor::bulk_execute(std::size_t numTasks, Function function)
+{
+    if (numTasks == 0u) return;
+
+    if (running_pool() == this)
+    {
+        for (std::size_t task = 0u; task < numTasks; ++task)
+        {
+            function(task);
+        }
+        return;
+    }
+
+    std::lock_guard<std::mutex> submitLock(d_submitMutex);
+
+    Job job;
+    job.d_function = std::addressof(function);
+    job.d_invoke = [](const void* function, std::size_t task) {
+        (*static_cast<Function*>(const_cast<void*>(function)))(task);
+    };
+    job.d_numTasks = numTasks;
+    job.d_nextTask.store(0u, std::memory_order_relaxed);
+    job.d_numWorkers = 0u;
+
+    if (!d_workers.empty() && numTasks > 1u)
+    {
+        {
+            std::lock_guard<std::mutex> lock(d_mutex);
+            d_job = &job;
+            ++d_generation;
+        }
+        d_wake.notify_all();
+    }
+
+    this->work_on(job);
+
+    // Stop any more workers joining, then wait for those which did.
+    std::unique_lock<std::mutex> lock(d_mutex);
+    d_job = nullptr;
+    d_done.wait_until(lock, NO_DEADLINE, [&job] { return job.d_numWorkers == 0u; });
+
+    if (job.d_exception)
+    {
+        std::rethrow_exception(job.d_exception);
+    }
+}
+
+inline std::size_t ThreadPoolExecutor::concurrency() const noexcept
+{
+    return d_workers.size() + 1u;
+}
+
+inline std::size_t ThreadPoolExecutor::default_num_workers() noexcept
+{
+    const unsigned numThreads = std::thread::hardware_concurrency();
+    return numThreads > 1u ? numThreads - 1u : 0u;
+}
+
+inline const ThreadPoolExecutor*& ThreadPoolExecutor::running_pool() noexcept
+{
+    thread_local const ThreadPoolExecutor* t_pool = nullptr;
+    return t_pool;
+}
+
+inline void ThreadPoolExecutor::run_worker()
+{
+    std::uint64_t seen = 0u;
+    std::unique_lock<std::mutex> lock(d_mutex);
+    while (true)
+    {
+        d_wake.wait_until(lock, NO_DEADLINE, [this, &seen] {
+            return d_stopping || (d_job && d_generation != seen);
+        });
+        if (d_stopping) return;
+
+        seen = d_generation;
+        Job& job = *d_job;
+        ++job.d_numWorkers;
+
+        lock.unlock();
+        this->work_on(job);
+        lock.lock();
+
+        if (--job.d_numWorkers == 0u)
+        {
+            d_done.notify_all();
+        }
+    }
+}
+
+inline void ThreadPoolExecutor::work_on(Job& job) noexcept
+{
+    const ThreadPoolExecutor*& runningPool = running_pool();
+    const ThreadPoolExecutor* const outerPool = runningPool;
+    runningPool = this;
+
+    while (true)
+    {
+        const std::size_t task = job.d_nextTask.fetch_add(1u, std::memory_order_relaxed);
+        if (task >= job.d_numTasks) break;
+
+        try {
+            job.d_invoke(job.d_function, task);
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(d_mutex);
+            if (!job.d_exception)
+            {
+                job.d_exception = std::current_exception();
+            }
+        }
+    }
+
+    runningPool = outerPool;
+}
+
+inline ThreadPoolExecutor& default_executor()
+{
+    static ThreadPoolExecutor executor;
+    return executor;
+}
+
+// Algorithms
+template <typename Ranges>
+inline std::vector<std::size_t> balanced_partition(const Ranges& ranges, std::size_t numChunks)
+{
+    const auto first = std::begin(ranges);
+    const std::size_t numRanges = std::distance(first, std::end(ranges));
+
+    std::vector<std::size_t> cumulative(numRanges + 1u);
+    cumulative[0u] = 0u;
+    for (std::size_t i = 0u; i < numRanges; ++i)
+    {
+        cumulative[i + 1u] = cumulative[i] + first[i].length() + 1u;
+    }
+
+    std::vector<std::size_t> boundaries{0u};
+    const std::size_t total = cumulative.back();
+    numChunks = std::max<std::size_t>(numChunks, 1u);
+    for (std::size_t chunk = 1u; chunk < numChunks; ++chunk)
+    {
+        const std::size_t target = total / numChunks * chunk
+            + total % numChunks * chunk / numChunks;
+        const std::size_t boundary = std::distance(cumulative.begin(),
+            std::lower_bound(cumulative.begin(), cumulative.end() - 1, target));
+        if (boundary > boundaries.back())
+        {
+            boundaries.push_back(boundary);
+        }
+    }
+    if (numRanges > boundaries.back())
+    {
+        boundaries.push_back(numRanges);
+    }
+    return boundaries;
+}
+
+template <typename Ranges, typename Function, typename Executor>
+inline void parallel_for_each_range(Ranges& ranges, Function function, Executor& executor)
+{
+    // A few chunks per thread leaves room to even out the load.
+    const std::vector<std::size_t> boundaries =
+        balanced_partition(ranges, executor.concurrency() * 4u);
+    const auto first = std::begin(ranges);
+
+    executor.bulk_execute(boundaries.size() - 1u, [&](std::size_t chunk) {
+        for (std::size_t i = boundaries[chunk]; i != boundaries[chunk + 1u]; ++i)
+        {
+            function(first[i]);
+        }
+    });
+}
+
+template <typename Ranges, typename Function>
+inline void parallel_for_each_range(Ranges& ranges, Function function)
+{
+    parallel_for_each_range(ranges, std::move(function), default_executor());
+}
+
+template <typename InRanges, typename OutRanges, typename Function, typename Executor>
+inline void parallel_transform_ranges(const InRanges& input, OutRanges& output,
+    Function function, Executor& executor)
+{
+    assert(std::distance(std::begin(input), std::end(input))
+        == std::distance(std::begin(output), std::end(output)));
+
+    const std::vector<std::size_t> boundaries =
+        balanced_partition(input, executor.concurrency() * 4u);
+    const auto in = std::begin(input);
+    const auto out = std::begin(output);
+
+    executor.bulk_execute(boundaries.size() - 1u, [&](std::size_t chunk) {
+        for (std::size_t i = boundaries[chunk]; i != boundaries[chunk + 1u]; ++i)
+        {
+            assert(in[i].length() == out[i].length());
+            function(in[i], out[i]);
+        }
+    });
+}
+
+template <typename InRanges, typename OutRanges, typename Function>
+inline void parallel_transform_ranges(const InRanges& input, OutRanges& output,
+    Function function)
+{
+    parallel_transform_ranges(input, output, std::move(function), default_executor());
+}
+
+template <typename Ranges, typename Compare, typename Executor>
+inline void parallel_sort_ranges(Ranges& ranges, Compare compare, Executor& executor)
+{
+    using size_type = typename Ranges::size_type;
+
+    const auto first = std::begin(ranges);
+    const std::size_t numRanges = std::distance(first, std::end(ranges));
+    const auto less = [&compare, first](size_type lhs, size_type rhs) {
+        return compare(first[lhs], first[rhs]);
+    };
+
+    std::vector<size_type> order(numRanges);
+    std::iota(order.begin(), order.end(), size_type{0u});
+
+    if (numRanges > 1u)
+    {
+        const std::size_t numSlices = std::min(executor.concurrency(), numRanges);
+        std::size_t width = (numRanges + numSlices - 1u) / numSlices;
+
+        executor.bulk_execute(numSlices, [&](std::size_t slice) {
+            const std::size_t begin = std::min(slice * width, numRanges);
+            const std::size_t end = std::min(begin + width, numRanges);
+            std::stable_sort(order.begin() + begin, order.begin() + end, less);
+        });
+
+        // Each round halves the number of slices, so the last merge is
+        // sequential, but it only moves indices.
+        std::vector<size_type> merged(numRanges);
+        for (; width < numRanges; width *= 2u)
+        {
+            const std::size_t numMerges = (numRanges + 2u * width - 1u) / (2u * width);
+            executor.bulk_execute(numMerges, [&](std::size_t merge) {
+                const std::size_t begin = merge * 2u * width;
+                const std::size_t middle = std::min(begin + width, numRanges);
+                const std::size_t end = std::min(begin + 2u * width, numRanges);
+                std::merge(order.begin() + begin, order.begin() + middle,
+                    order.begin() + middle, order.begin() + end, merged.begin() + begin, less);
+            });
+            order.swap(merged);
+        }
+    }
+
+    ranges.permute_ranges({order.data(), order.size()});
+}
+
+template <typename Ranges, typename Compare>
+inline void parallel_sort_ranges(Ranges& ranges, Compare compare)
+{
+    parallel_sort_ranges(ranges, std::move(compare), default_executor());
+}
+
+} // close namespace tr::data_structures
+
+#endif // PARALLEL_RANGES_HPP
@@ -0,0 +1,582 @@
+#ifndef SEGMENTED_INLINE_VECTOR_HPP
+#define SEGMENTED_INLINE_VECTOR_HPP
+
+#include <span.hpp>
+#include <utility.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace tr::data_structures {
+
+template <typename T, typename Allocator = std::allocator<T>>
+class segmented_inline_vector : private Allocator
+{
+    // An `inline_vector` whose elements never move once they have been
+    // appended, so the spans it hands out stay valid as it grows.
+    //
+    // The elements live in segments which double in size, each of
+    // which is only allocated once it is needed. Every element has an
+    // offset as if the segments were laid end to end, and the segment
+    // holding any offset is found in constant time from its leading
+    // zeros. A range which doesn't fit in what is left of the current
+    // segment starts the next one (or a later one, if it is too long),
+    // so a range never straddles two segments.
+    //
+    // Erasing a range leaves a hole rather than moving its neighbours,
+    // except at the back, where the space is reused. Holes are only
+    // reclaimed by `clear`. Iterators point at the blocks describing
+    // the ranges, which (unlike the ranges themselves) may move when
+    // ranges are added or erased.
+
+public: // Types
+    using value_type = span<T>;
+    using reference = const span<T>&;
+    using const_reference = const span<T>&;
+    using pointer = const span<T>*;
+    using const_pointer = const span<T>*;
+
+    using iterator = const span<T>*;
+    using const_iterator = const span<T>*;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    using size_type = typename std::allocator_traits<Allocator>::size_type;
+    using difference_type = typename std::iterator_traits<iterator>::difference_type;
+
+    using allocator_type = Allocator;
+
+public: // Constructors
+    segmented_inline_vector() noexcept(std::is_nothrow_default_constructible_v<Allocator>);
+    explicit segmented_inline_vector(const Allocator& alloc) noexcept;
+    segmented_inline_vector(const segmented_inline_vector& other);
+    segmented_inline_vector(segmented_inline_vector&& other) noexcept;
+    ~segmented_inline_vector();
+
+public: // Assignment
+    segmented_inline_vector& operator=(const segmented_inline_vector& other);
+    segmented_inline_vector& operator=(segmented_inline_vector&& other);
+
+public: // Allocator
+    [[nodiscard]] allocator_type get_allocator() const noexcept;
+
+public: // Capacity
+    [[nodiscard]] bool empty() const noexcept;
+
+    // This returns the number of elements in the container.
+    [[nodiscard]] size_type size() const noexcept;
+
+    // This returns the number of elements the allocated segments can hold.
+    [[nodiscard]] size_type capacity() const noexcept;
+
+    // This returns the number of ranges in the container.
+    [[nodiscard]] size_type num_ranges() const noexcept;
+
+    [[nodiscard]] size_type max_size() const noexcept;
+
+    // Allocate enough memory to describe `new_cap` ranges.
+    void reserve_ranges(size_type new_cap);
+
+    // This returns how much memory the container holds. Holes left by
+    // erased ranges, and the ends of segments too short for the range
+    // which followed, count as slack.
+    [[nodiscard]] MemoryUsage memory_usage() const noexcept;
+
+public: // Element Access
+    [[nodiscard]] const_reference operator[](size_type index) const noexcept;
+    [[nodiscard]] const_reference at(size_type index) const;
+    [[nodiscard]] const_reference front() const noexcept;
+    [[nodiscard]] const_reference back() const noexcept;
+
+public: // Iterators
+    [[nodiscard]] const_iterator begin() const noexcept;
+    [[nodiscard]] const_iterator cbegin() const noexcept;
+    [[nodiscard]] const_iterator end() const noexcept;
+    [[nodiscard]] const_iterator cend() const noexcept;
+
+    [[nodiscard]] const_reverse_iterator rbegin() const noexcept;
+    [[nodiscard]] const_reverse_iterator crbegin() const noexcept;
+    [[nodiscard]] const_reverse_iterator rend() const noexcept;
+    [[nodiscard]] const_reverse_iterator crend() const noexcept;
+
+public: // Modifiers
+    // This destroys every range but keeps the segments for reuse.
+    void clear() noexcept;
+
+    iterator erase_range(const_iterator pos);
+
+    void push_back_range(span<std::add_const_t<T>> range);
+    template <typename FwdIt>
+    void push_back_range(FwdIt first, FwdIt last);
+
+    void pop_back_range() noexcept;
+
+    void swap(segmented_inline_vector& other) noexcept;
+
+private: // Private Types
+    template <typename U>
+    using ReboundAlloc = typename std::allocator_traits<Allocator>::template rebind_alloc<U>;
+
+    using Block = span<T>;
+    using BlockManager = std::vector<Block, ReboundAlloc<Block>>;
+
+private: // Helper variables
+    static constexpr size_type FIRST_SEGMENT_SIZE = 64u;
+    static constexpr size_type NUM_SEGMENTS = 32u;
+
+private: // Helpers
+    // Segment `k` holds `FIRST_SEGMENT_SIZE << k` elements.
+    [[nodiscard]] static size_type segment_of(size_type offset) noexcept;
+    [[nodiscard]] static size_type segment_begin(size_type segment) noexcept;
+    [[nodiscard]] static size_type segment_size(size_type segment) noexcept;
+
+    // Find room for `length` elements which doesn't cross a segment,
+    // allocating the segment if need be. This returns where they go
+    // and the offset of the end of the new range.
+    [[nodiscard]] std::pair<T*, size_type> claim(size_type length);
+
+    // This returns where the next element would go if it fit.
+    [[nodiscard]] const T* end_position() const noexcept;
+
+    void destroy_range(Block range) noexcept;
+    void release_segments() noexcept;
+
+private: // Members
+    BlockManager    d_blockManager;
+    T*              d_segments[NUM_SEGMENTS];
+    size_type       d_size;
+    size_type       d_end;
+};
+
+// =================================================================
+// INLINE DEFINITIONS
+// =================================================================
+
+// Constructors
+template <typename T, typename Allocator>
+inline segmented_inline_vector<T, Allocator>::segmented_inline_vector()
+    noexcept(std::is_nothrow_default_constructible_v<Allocator>)
+    : segmented_inline_vector(Allocator{})
+{}
+
+template <typename T, typename Allocator>
+inline segmented_inline_vector<T, Allocator>::segmented_inline_vector(
+    const Allocator& alloc) noexcept
+    : Allocator(alloc)
+    , d_blockManager(ReboundAlloc<Block>(alloc))
+    , d_segments()
+    , d_size(0u)
+    , d_end(0u)
+{}
+
+template <typename T, typename Allocator>
+inline segmented_inline_vector<T, Allocator>::segmented_inline_vector(
+    const segmented_inline_vector& other)
+    : segmented_inline_vector(std::allocator_traits<Allocator>
+        ::select_on_container_copy_construction(other.get_allocator()))
+{
+    this->reserve_ranges(other.num_ranges());
+    std::for_each(other.cbegin(), other.cend(), [this](Block block) {
+        this->push_back_range(block);
+    });
+}
+
+template <typename T, typename Allocator>
+inline segmented_inline_vector<T, Allocator>::segmented_inline_vector(
+    segmented_inline_vector&& other) noexcept
+    : segmented_inline_vector(other.get_allocator())
+{
+    this->swap(other);
+}
+
+template <typename T, typename Allocator>
+inline segmented_inline_vector<T, Allocator>::~segmented_inline_vector()
+{
+    this->clear();
+    this->release_segments();
+}
+
+// Assignment
+template <typename T, typename Allocator>
+inline segmented_inline_vector<T, Allocator>&
+    segmented_inline_vector<T, Allocator>::operator=(const segmented_inline_vector& other)
+{
+    if (this != &other)
+    {
+        this->clear();
+        this->reserve_ranges(other.num_ranges());
+        std::for_each(other.cbegin(), other.cend(), [this](Block block) {
+            this->push_back_range(block);
+        });
+    }
+    return *this;
+}
+
+template <typename T, typename Allocator>
+inline segmented_inline_vector<T, Allocator>&
+    segmented_inline_vector<T, Allocator>::operator=(segmented_inline_vector&& other)
+{
+    if (this == &other) return *this;
+
+    if (this->get_allocator() == other.get_allocator())
+    {
+        this->clear();
+        this->release_segments();
+        this->swap(other);
+    }
+    else
+    {
+        // The memory belongs to a different allocator, so we
+        // have to fall back to copying it.
+        *this = static_cast<const segmented_inline_vector&>(other);
+        other.clear();
+    }
+    return *this;
+}
+
+// Allocator
+template <typename T, typename Allocator>
+inline typename segmented_inline_vector<T, Allocator>::allocator_type
+    segmented_inline_vector<T, Allocator>::get_allocator() const noexcept
+{
+    return *this;
+}
+
+// Capacity
+template <typename T, typename Allocator>
+inline bool segmented_inline_vector<T, Allocator>::empty() const noexcept
+{
+    return this->d_blockManager.empty();
+}
+
+template <typename T, typename Allocator>
+inline typename segmented_inline_vector<T, Allocator>::size_type
+    segmented_inline_vector<T, Allocator>::size() const noexcept
+{
+    return this->d_size;
+}
+
+template <typename T, typename Allocator>
+inline typename segmented_inline_vector<T, Allocator>::size_type
+    segmented_inline_vector<T, Allocator>::capacity() const noexcept
+{
+    size_type capacity = 0u;
+    for (size_type segment = 0u; segment < NUM_SEGMENTS; ++segment)
+    {
+        if (this->d_segments[segment]) capacity += segment_size(segment);
+    }
+    return capacity;
+}
+
+template <typename T, typename Allocator>
+inline typename segmented_inline_vector<T, Allocator>::size_type
+    segmented_inline_vector<T, Allocator>::num_ranges() const noexcept
+{
+    return this->d_blockManager.size();
+}
+
+template <typename T, typename Allocator>
+inline typename segmented_inline_vector<T, Allocator>::size_type
+    segmented_inline_vector<T, Allocator>::max_size() const noexcept
+{
+    return std::min<size_type>(std::allocator_traits<Allocator>::max_size(*this),
+        segment_size(NUM_SEGMENTS - 1u));
+}
+
+template <typename T, typename Allocator>
+inline void segmented_inline_vector<T, Allocator>::reserve_ranges(size_type new_cap)
+{
+    this->d_blockManager.reserve(new_cap);
+}
+
+template <typename T, typename Allocator>
+inline MemoryUsage segmented_inline_vector<T, Allocator>::memory_usage() const noexcept
+{
+    return {
+        sizeof(T) * this->d_size,
+        sizeof(T) * (this->capacity() - this->d_size),
+        sizeof(Block) * this->d_blockManager.size(),
+        sizeof(Block) * (this->d_blockManager.capacity() - this->d_blockManager.size())
+    };
+}
+
+// Element Access
+template <typename T, typename Allocator>
+inline typename segmented_inline_vector<T, Allocator>::const_reference
+    segmented_inline_vector<T, Allocator>::operator[](size_type index) const noexcept
+{
+    assert(index < this->d_blockManager.size());
+    return this->d_blockManager[index];
+}
+
+template <typename T, typename Allocator>
+inline typename segmented_inline_vector<T, Allocator>::const_reference
+    segmented_inline_vector<T, Allocator>::at(size_type index) const
+{
+    if (index >= this->d_blockManager.size()) { throw std::out_of_range{"Index out of range"}; }
+    return this->operator[](index);
+}
+
+template <typename T, typename Allocator>
+inline typename segmented_inline_vector<T, Allocator>::const_reference
+    segmented_inline_vector<T, Allocator>::front() const noexcept
+{
+    assert(!this->empty());
+    return this->operator[](0u);
+}
+
+template <typename T, typename Allocator>
+inline typename segmented_inline_vector<T, Allocator>::const_reference
+    segmented_inline_vector<T, Allocator>::back() const noexcept
+{
+    assert(!this->empty());
+    return this->operator[](this->num_ranges() - 1u);
+}
+
+// Iterators
+template <typename T, typename Allocator>
+inline typename segmented_inline_vector<T, Allocator>::const_iterator
+    segmented_inline_vector<T, Allocator>::begin() const noexcept
+{
+    return this->cbegin();
+}
+
+template <typename T, typename Allocator>
+inline typename segmented_inline_vector<T, Allocator>::const_iterator
+    segmented_inline_vector<T, Allocator>::cbegin() const noexcept
+{
+    return this->d_blockManager.data();
+}
+
+template <typename T, typename Allocator>
+inline typename segmented_inline_vector<T, Allocator>::const_iterator
+    segmented_inline_vector<T, Allocator>::end() const noexcept
+{
+    return this->cend();
+}
+
+template <typename T, typename Allocator>
+inline typename segmented_inline_vector<T, Allocator>::const_iterator
+    segmented_inline_vector<T, Allocator>::cend() const noexcept
+{
+    return this->d_blockManager.data() + this->d_blockManager.size();
+}
+
+template <typename T, typename Allocator>
+inline typename segmented_inline_vector<T, Allocator>::const_reverse_iterator
+    segmented_inline_vector<T, Allocator>::rbegin() const noexcept
+{
+    return this->crbegin();
+}
+
+template <typename T, typename Allocator>
+inline typename segmented_inline_vector<T, Allocator>::const_reverse_iterator
+    segmented_inline_vector<T, Allocator>::crbegin() const noexcept
+{
+    return const_reverse_iterator{this->cend()};
+}
+
+template <typename T, typename Allocator>
+inline typename segmented_inline_vector<T, Allocator>::const_reverse_iterator
+    segmented_inline_vector<T, Allocator>::rend() const noexcept
+{
+    return this->crend();
+}
+
+template <typename T, typename Allocator>
+inline typename segmented_inline_vector<T, Allocator>::const_reverse_iterator
+    segmented_inline_vector<T, Allocator>::crend() const noexcept
+{
+    return const_reverse_iterator{this->cbegin()};
+}
+
+// Modifiers
+template <typename T, typename Allocator>
+inline void segmented_inline_vector<T, Allocator>::clear() noexcept
+{
+    std::for_each(this->d_blockManager.begin(), this->d_blockManager.end(),
+        [this](Block block) noexcept { this->destroy_range(block); });
+    this->d_blockManager.clear();
+    this->d_size = 0u;
+    this->d_end = 0u;
+}
+
+template <typename T, typename Allocator>
+inline typename segmented_inline_vector<T, Allocator>::iterator
+    segmented_inline_vector<T, Allocator>::erase_range(const_iterator pos)
+{
+    const auto index = std::distance(this->cbegin(), pos);
+    if (pos == this->cend() - 1)
+    {
+        this->pop_back_range();
+    }
+    else
+    {
+        this->destroy_range(*pos);
+        this->d_size -= pos->length();
+        this->d_blockManager.erase(this->d_blockManager.begin() + index);
+    }
+    return this->cbegin() + index;
+}
+
+template <typename T, typename Allocator>
+inline void segmented_inline_vector<T, Allocator>::push_back_range(
+    span<std::add_const_t<T>> range)
+{
+    this->push_back_range(range.begin(), range.end());
+}
+
+template <typename T, typename Allocator>
+template <typename FwdIt>
+inline void segmented_inline_vector<T, Allocator>::push_back_range(FwdIt first, FwdIt last)
+{
+    static_assert(at_least_forward_iterator_v<FwdIt>,
+        "The length of a range must be known before it is placed");
+
+    const size_type length = std::distance(first, last);
+    const auto [position, end] = this->claim(length);
+
+    this->d_blockManager.emplace_back(position, length);
+    try {
+        safe_uninitialized_copy(first, last, position, static_cast<Allocator&>(*this));
+    }
+    catch (...)
+    {
+        this->d_blockManager.pop_back();
+        throw;
+    }
+
+    this->d_size += length;
+    this->d_end = end;
+}
+
+template <typename T, typename Allocator>
+inline void segmented_inline_vector<T, Allocator>::pop_back_range() noexcept
+{
+    assert(!this->empty());
+    const Block block = this->d_blockManager.back();
+
+    // Only give the space back if nothing was erased from after it.
+    if (block.length() != 0u && block.data() + block.length() == this->end_position())
+    {
+        this->d_end -= block.length();
+    }
+
+    this->destroy_range(block);
+    this->d_size -= block.length();
+    this->d_blockManager.pop_back();
+}
+
+template <typename T, typename Allocator>
+inline void segmented_inline_vector<T, Allocator>::swap(segmented_inline_vector& other) noexcept
+{
+    using std::swap;
+    if constexpr (std::allocator_traits<Allocator>::propagate_on_container_swap::value)
+    {
+        swap(static_cast<Allocator&>(*this), static_cast<Allocator&>(other));
+    }
+    else
+    {
+        assert(this->get_allocator() == other.get_allocator());
+    }
+    swap(this->d_blockManager, other.d_blockManager);
+    swap(this->d_segments, other.d_segments);
+    swap(this->d_size, other.d_size);
+    swap(this->d_end, other.d_end);
+}
+
+template <typename T, typename Allocator>
+inline void swap(segmented_inline_vector<T, Allocator>& lhs,
+    segmented_inline_vector<T, Allocator>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+// Helpers
+template <typename T, typename Allocator>
+inline typename segmented_inline_vector<T, Allocator>::size_type
+    segmented_inline_vector<T, Allocator>::segment_of(size_type offset) noexcept
+{
+    return 63 - count_leading_zeros(offset / FIRST_SEGMENT_SIZE + 1u);
+}
+
+template <typename T, typename Allocator>
+inline typename segmented_inline_vector<T, Allocator>::size_type
+    segmented_inline_vector<T, Allocator>::segment_begin(size_type segment) noexcept
+{
+    return FIRST_SEGMENT_SIZE * ((size_type{1u} << segment) - 1u);
+}
+
+template <typename T, typename Allocator>
+inline typename segmented_inline_vector<T, Allocator>::size_type
+    segmented_inline_vector<T, Allocator>::segment_size(size_type segment) noexcept
+{
+    return FIRST_SEGMENT_SIZE << segment;
+}
+
+template <typename T, typename Allocator>
+inline std::pair<T*, typename segmented_inline_vector<T, Allocator>::size_type>
+    segmented_inline_vector<T, Allocator>::claim(size_type length)
+{
+    if (length == 0u) return {nullptr, this->d_end};
+
+    size_type first = this->d_end;
+    size_type segment = segment_of(first);
+    while (first + length > segment_begin(segment) + segment_size(segment))
+    {
+        ++segment;
+        first = segment_begin(segment);
+    }
+
+    if (segment >= NUM_SEGMENTS) { throw std::length_error{"segmented_inline_vector is full"}; }
+    if (!this->d_segments[segment])
+    {
+        this->d_segments[segment] = std::allocator_traits<Allocator>::allocate(*this,
+            segment_size(segment));
+    }
+
+    return {this->d_segments[segment] + (first - segment_begin(segment)), first + length};
+}
+
+template <typename T, typename Allocator>
+inline const T* segmented_inline_vector<T, Allocator>::end_position() const noexcept
+{
+    if (this->d_end == 0u) return nullptr;
+
+    const size_type segment = segment_of(this->d_end - 1u);
+    const T* base = this->d_segments[segment];
+    return base ? base + (this->d_end - segment_begin(segment)) : nullptr;
+}
+
+template <typename T, typename Allocator>
+inline void segmented_inline_vector<T, Allocator>::destroy_range(Block range) noexcept
+{
+    std::for_each(range.begin(), range.end(), [this](T& obj) noexcept {
+        std::allocator_traits<Allocator>::destroy(*this, std::addressof(obj));
+    });
+}
+
+template <typename T, typename Allocator>
+inline void segmented_inline_vector<T, Allocator>::release_segments() noexcept
+{
+    for (size_type segment = 0u; segment < NUM_SEGMENTS; ++segment)
+    {
+        if (this->d_segments[segment])
+        {
+            std::allocator_traits<Allocator>::deallocate(*this, this->d_segments[segment],
+                segment_size(segment));
+            this->d_segments[segment] = nullptr;
+        }
+    }
+}
+
+} // close namespace tr::data_structures
+
+#endif // SEGMENTED_INLINE_VECTOR_HPP
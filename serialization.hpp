@@ -0,0 +1,647 @@
+#ifndef SERIALIZATION_HPP
+#define SERIALIZATION_HPP
+
+#include <flat_sequence_set.hpp>
+#include <span.hpp>
+#include <utility.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// A streaming binary format for sending containers of trivially
+// copyable elements between processes: `inline_vector`,
+// `flat_sequence_set` and `static_vector` (which is sent as one range).
+//
+// Each container is sent as a frame:
+//
+//      magic           4 bytes, "TRF1"
+//      element size    varint, `sizeof(T)`
+//      num ranges      varint
+//      num elements    varint, the total over every range
+//      lengths         one varint per range
+//      payload         the elements of every range, back to back, as
+//                      their raw bytes in the writer's byte order
+//      checksum        4 bytes, the little-endian Adler-32 of
+//                      everything before it
+//
+// Varints are LEB128: seven bits at a time, least significant first,
+// with the top bit set on every byte but the last.
+//
+// `FrameWriter` and `FrameReader` work incrementally on buffers the
+// caller provides, so a frame can be pushed through a pipe or socket
+// a buffer at a time, and neither allocates per range.
+
+namespace tr::data_structures {
+
+// Detect whether a container holds ranges, rather than plain elements.
+template <typename Container>
+using num_ranges_t = decltype(std::declval<const Container&>().num_ranges());
+
+template <typename Container>
+inline constexpr bool has_num_ranges_v = is_detected_v<num_ranges_t, Container>;
+
+class Adler32 {
+    // The running Adler-32 checksum of a sequence of bytes.
+
+public: // Construction
+    Adler32() noexcept;
+
+public: // Modifiers
+    void update(span<const std::byte> bytes) noexcept;
+
+public: // Observers
+    [[nodiscard]] std::uint32_t value() const noexcept;
+
+private: // Helper variables
+    static constexpr std::uint32_t MODULUS = 65521u;
+
+    // The most bytes which can be summed before reducing `d_b` could overflow.
+    static constexpr std::size_t MAX_RUN = 5552u;
+
+private: // Members
+    std::uint32_t   d_a;
+    std::uint32_t   d_b;
+};
+
+template <typename Container>
+class FrameWriter {
+    // Writes `container` as a frame, a buffer at a time. The container
+    // must not change until the whole frame has been written.
+
+public: // Types
+    using size_type = std::size_t;
+
+public: // Construction
+    explicit FrameWriter(const Container& container);
+    FrameWriter(const FrameWriter&) = delete;
+
+public: // Assignment
+    FrameWriter& operator=(const FrameWriter&) = delete;
+
+public: // Writing
+    // Write as much of the rest of the frame as fits into `out`,
+    // returning how many bytes were written.
+    size_type write(span<std::byte> out);
+
+    // This returns whether the whole frame has been written.
+    [[nodiscard]] bool done() const noexcept;
+
+private: // Private Types
+    enum class Phase { LENGTHS, PAYLOAD, DONE };
+
+    using Element = typename std::conditional_t<has_num_ranges_v<Container>,
+        typename Container::value_type, Container>::value_type;
+    static_assert(std::is_trivially_copyable_v<Element>);
+
+private: // Helper variables
+    static constexpr size_type MAX_VARINT_BYTES = 10u;
+
+private: // Helpers
+    [[nodiscard]] size_type num_ranges() const noexcept;
+    [[nodiscard]] span<const Element> range(size_type index) const noexcept;
+
+    // Queue up the varint encoding of `value` to be written next.
+    void queue_varint(std::uint64_t value) noexcept;
+
+private: // Members
+    const Container&    d_container;
+    Adler32             d_checksum;
+    Phase               d_phase;
+    size_type           d_range;
+    size_type           d_offset;       // Bytes of the current range written
+
+    // Small pieces (the header, lengths and checksum) are encoded here
+    // first, so that they can be split across buffers.
+    std::byte           d_pending[4u * MAX_VARINT_BYTES];
+    size_type           d_pendingBegin;
+    size_type           d_pendingEnd;
+};
+
+template <typename Container>
+class FrameReader {
+    // Reads a frame into `container`, a buffer at a time, replacing its
+    // contents. The container is reserved once, with the sizes in the
+    // frame's header.
+    //
+    // The header is read before the checksum can be checked, so its
+    // counts are validated before anything is sized from them: a frame
+    // may declare at most `maxElements` elements, and no more than the
+    // container could hold, and its lengths must sum to that exactly.
+    // Space for the ranges is only reserved once their lengths have
+    // all arrived.
+    //
+    // This throws `std::runtime_error` if the frame is malformed: if
+    // it has the wrong magic, element size or checksum, if its counts
+    // are too large, or if its lengths don't add up. Reading into a
+    // `flat_sequence_set` also checks that the ranges arrive in order.
+    // After an exception the container's contents are unspecified.
+
+public: // Types
+    using size_type = std::size_t;
+
+public: // Construction
+    explicit FrameReader(Container& container,
+        size_type maxElements = std::numeric_limits<size_type>::max());
+    FrameReader(const FrameReader&) = delete;
+
+public: // Assignment
+    FrameReader& operator=(const FrameReader&) = delete;
+
+public: // Reading
+    // Read from the front of `in`, stopping at the end of the frame,
+    // and return how many bytes were used.
+    size_type read(span<const std::byte> in);
+
+    // This returns whether the whole frame has been read.
+    [[nodiscard]] bool done() const noexcept;
+
+private: // Private Types
+    enum class Phase {
+        MAGIC, ELEMENT_SIZE, NUM_RANGES, NUM_ELEMENTS, LENGTHS, PAYLOAD, CHECKSUM, DONE
+    };
+
+    using Element = typename std::conditional_t<has_num_ranges_v<Container>,
+        typename Container::value_type, Container>::value_type;
+    static_assert(std::is_trivially_copyable_v<Element>);
+
+private: // Helpers
+    // Feed in one byte of a varint, returning whether it was the last,
+    // in which case `value` is set to the whole varint.
+    bool read_varint_byte(std::byte byte, std::uint64_t& value);
+
+    // Reserve the container from the header, once it has been read.
+    void start_payload();
+
+    // Append the range which has just been read, or is empty, and move
+    // on to the next non-empty one.
+    void finish_range();
+
+private: // Members
+    Container&              d_container;
+    Adler32                 d_checksum;
+    Phase                   d_phase;
+
+    std::uint64_t           d_varint;       // The varint read so far
+    unsigned                d_varintShift;
+    std::uint32_t           d_fixed;        // The magic or checksum read so far
+    unsigned                d_fixedBytes;
+
+    size_type               d_maxElements;
+    size_type               d_numRanges;
+    size_type               d_numElements;
+    size_type               d_lengthsTotal; // Sum of the lengths read so far
+    std::vector<size_type>  d_lengths;
+    size_type               d_range;
+    size_type               d_offset;       // Bytes of the current range read
+
+    // Ranges are gathered here before being appended, as they
+    // can be split across buffers.
+    std::vector<Element>    d_staging;
+};
+
+// =================================================================
+// INLINE DEFINITIONS
+// =================================================================
+namespace detail {
+
+inline constexpr std::uint32_t FRAME_MAGIC = 0x31465254u;   // "TRF1", little-endian
+
+inline void store_little_endian(std::uint32_t value, std::byte* bytes) noexcept
+{
+    for (unsigned i = 0u; i < 4u; ++i)
+    {
+        bytes[i] = static_cast<std::byte>(value >> (8u * i));
+    }
+}
+
+// The container a frame is read into: a `flat_sequence_set` is
+// filled through its underlying container, as the ranges arrive in order.
+template <typename Container>
+inline Container& frame_ranges(Container& container) noexcept
+{
+    return container;
+}
+
+template <typename Type, typename Compare, typename Container>
+inline Container& frame_ranges(flat_sequence_set<Type, Compare, Container>& set) noexcept
+{
+    return set.get_container();
+}
+
+// Throw unless `range` can be appended to `container` without breaking
+// its ordering, which only a `flat_sequence_set` has.
+template <typename Container, typename Range>
+inline void check_frame_order(const Container&, const Range&) noexcept
+{}
+
+template <typename Type, typename Compare, typename Container, typename Range>
+inline void check_frame_order(const flat_sequence_set<Type, Compare, Container>& set,
+    const Range& range)
+{
+    if (!set.empty() && !set.get_compare()(set.back(), range))
+    {
+        throw std::runtime_error{"Frame ranges are out of order"};
+    }
+}
+
+} // close namespace detail
+
+// Adler32
+inline Adler32::Adler32() noexcept
+    : d_a(1u)
+    , d_b(0u)
+{}
+
+inline void Adler32::update(span<const std::byte> bytes) noexcept
+{
+    const std::byte* position = bytes.data();
+    std::size_t remaining = bytes.length();
+    while (remaining > 0u)
+    {
+        const std::size_t run = std::min(remaining, MAX_RUN);
+        for (const std::byte* end = position + run; position != end; ++position)
+        {
+            this->d_a += std::to_integer<std::uint32_t>(*position);
+            this->d_b += this->d_a;
+        }
+        this->d_a %= MODULUS;
+        this->d_b %= MODULUS;
+        remaining -= run;
+    }
+}
+
+inline std::uint32_t Adler32::value() const noexcept
+{
+    return (this->d_b << 16u) | this->d_a;
+}
+
+// FrameWriter
+template <typename Container>
+inline FrameWriter<Container>::FrameWriter(const Container& container)
+    : d_container(container)
+    , d_phase(Phase::LENGTHS)
+    , d_range(0u)
+    , d_offset(0u)
+    , d_pendingBegin(0u)
+    , d_pendingEnd(0u)
+{
+    size_type numElements = 0u;
+    for (size_type i = 0u; i < this->num_ranges(); ++i)
+    {
+        numElements += this->range(i).length();
+    }
+
+    detail::store_little_endian(detail::FRAME_MAGIC, this->d_pending);
+    this->d_pendingEnd = 4u;
+    this->queue_varint(sizeof(Element));
+    this->queue_varint(this->num_ranges());
+    this->queue_varint(numElements);
+}
+
+template <typename Container>
+inline typename FrameWriter<Container>::size_type FrameWriter<Container>::write(
+    span<std::byte> out)
+{
+    size_type numWritten = 0u;
+    while (numWritten < out.length())
+    {
+        if (this->d_pendingBegin != this->d_pendingEnd)
+        {
+            const size_type count = std::min(this->d_pendingEnd - this->d_pendingBegin,
+                out.length() - numWritten);
+            const span<const std::byte> bytes{this->d_pending + this->d_pendingBegin, count};
+            std::memcpy(out.data() + numWritten, bytes.data(), count);
+            if (this->d_phase != Phase::DONE)
+            {
+                this->d_checksum.update(bytes);
+            }
+            this->d_pendingBegin += count;
+            numWritten += count;
+        }
+        else if (this->d_phase == Phase::LENGTHS)
+        {
+            if (this->d_range == this->num_ranges())
+            {
+                this->d_phase = Phase::PAYLOAD;
+                this->d_range = 0u;
+            }
+            else
+            {
+                this->queue_varint(this->range(this->d_range++).length());
+            }
+        }
+        else if (this->d_phase == Phase::PAYLOAD)
+        {
+            if (this->d_range == this->num_ranges())
+            {
+                // Nothing more is added to the checksum once it is queued.
+                this->d_pendingBegin = 0u;
+                this->d_pendingEnd = 4u;
+                detail::store_little_endian(this->d_checksum.value(), this->d_pending);
+                this->d_phase = Phase::DONE;
+                continue;
+            }
+
+            const span<const std::byte> bytes = this->range(this->d_range).as_bytes();
+            const size_type count = std::min(bytes.length() - this->d_offset,
+                out.length() - numWritten);
+            const span<const std::byte> chunk{bytes.data() + this->d_offset, count};
+            std::memcpy(out.data() + numWritten, chunk.data(), count);
+            this->d_checksum.update(chunk);
+            numWritten += count;
+
+            this->d_offset += count;
+            if (this->d_offset == bytes.length())
+            {
+                ++this->d_range;
+                this->d_offset = 0u;
+            }
+        }
+        else
+        {
+            break;
+        }
+    }
+    return numWritten;
+}
+
+template <typename Container>
+inline bool FrameWriter<Container>::done() const noexcept
+{
+    return this->d_phase == Phase::DONE && this->d_pendingBegin == this->d_pendingEnd;
+}
+
+template <typename Container>
+inline typename FrameWriter<Container>::size_type FrameWriter<Container>::num_ranges()
+    const noexcept
+{
+    if constexpr (has_num_ranges_v<Container>)
+    {
+        return this->d_container.num_ranges();
+    }
+    else
+    {
+        return 1u;
+    }
+}
+
+template <typename Container>
+inline span<const typename FrameWriter<Container>::Element> FrameWriter<Container>::range(
+    size_type index) const noexcept
+{
+    if constexpr (has_num_ranges_v<Container>)
+    {
+        return this->d_container[index];
+    }
+    else
+    {
+        return {this->d_container.data(), this->d_container.size()};
+    }
+}
+
+template <typename Container>
+inline void FrameWriter<Container>::queue_varint(std::uint64_t value) noexcept
+{
+    if (this->d_pendingBegin == this->d_pendingEnd)
+    {
+        this->d_pendingBegin = this->d_pendingEnd = 0u;
+    }
+
+    while (value >= 0x80u)
+    {
+        this->d_pending[this->d_pendingEnd++] = static_cast<std::byte>(value | 0x80u);
+        value >>= 7u;
+    }
+    this->d_pending[this->d_pendingEnd++] = static_cast<std::byte>(value);
+}
+
+// FrameReader
+template <typename Container>
+inline FrameReader<Container>::FrameReader(Container& container, size_type maxElements)
+    : d_container(container)
+    , d_phase(Phase::MAGIC)
+    , d_varint(0u)
+    , d_varintShift(0u)
+    , d_fixed(0u)
+    , d_fixedBytes(0u)
+    , d_maxElements(maxElements)
+    , d_numRanges(0u)
+    , d_numElements(0u)
+    , d_lengthsTotal(0u)
+    , d_range(0u)
+    , d_offset(0u)
+{}
+
+template <typename Container>
+inline typename FrameReader<Container>::size_type FrameReader<Container>::read(
+    span<const std::byte> in)
+{
+    size_type numRead = 0u;
+    while (numRead < in.length() && this->d_phase != Phase::DONE)
+    {
+        if (this->d_phase == Phase::PAYLOAD)
+        {
+            const size_type length = this->d_lengths[this->d_range] * sizeof(Element);
+            const size_type count = std::min(length - this->d_offset, in.length() - numRead);
+            const span<const std::byte> chunk{in.data() + numRead, count};
+
+            // A plain container is filled in place, but ranges have to
+            // be whole before they can be appended.
+            std::byte* destination;
+            if constexpr (has_num_ranges_v<Container>)
+            {
+                destination = reinterpret_cast<std::byte*>(this->d_staging.data());
+            }
+            else
+            {
+                destination = reinterpret_cast<std::byte*>(this->d_container.data());
+            }
+            std::memcpy(destination + this->d_offset, chunk.data(), count);
+            this->d_checksum.update(chunk);
+            numRead += count;
+
+            this->d_offset += count;
+            if (this->d_offset == length)
+            {
+                this->finish_range();
+            }
+            continue;
+        }
+
+        const std::byte byte = in[numRead++];
+        if (this->d_phase != Phase::CHECKSUM)
+        {
+            this->d_checksum.update({&byte, 1u});
+        }
+
+        std::uint64_t value;
+        switch (this->d_phase)
+        {
+        case Phase::MAGIC:
+        case Phase::CHECKSUM:
+            this->d_fixed |= std::to_integer<std::uint32_t>(byte) << (8u * this->d_fixedBytes);
+            if (++this->d_fixedBytes < 4u) break;
+
+            if (this->d_phase == Phase::MAGIC)
+            {
+                if (this->d_fixed != detail::FRAME_MAGIC)
+                {
+                    throw std::runtime_error{"Frame has the wrong magic"};
+                }
+                this->d_phase = Phase::ELEMENT_SIZE;
+            }
+            else
+            {
+                if (this->d_fixed != this->d_checksum.value())
+                {
+                    throw std::runtime_error{"Frame checksum doesn't match"};
+                }
+                this->d_phase = Phase::DONE;
+            }
+            this->d_fixed = 0u;
+            this->d_fixedBytes = 0u;
+            break;
+        case Phase::ELEMENT_SIZE:
+            if (!this->read_varint_byte(byte, value)) break;
+            if (value != sizeof(Element))
+            {
+                throw std::runtime_error{"Frame has the wrong element size"};
+            }
+            this->d_phase = Phase::NUM_RANGES;
+            break;
+        case Phase::NUM_RANGES:
+            if (!this->read_varint_byte(byte, value)) break;
+            if (!has_num_ranges_v<Container> && value != 1u)
+            {
+                throw std::runtime_error{"Frame must hold one range"};
+            }
+            if (value > this->d_lengths.max_size())
+            {
+                throw std::runtime_error{"Frame has too many ranges"};
+            }
+            // The lengths are gathered as they arrive, rather than
+            // reserved for, as the count hasn't been checked yet.
+            this->d_numRanges = value;
+            this->d_phase = Phase::NUM_ELEMENTS;
+            break;
+        case Phase::NUM_ELEMENTS:
+            if (!this->read_varint_byte(byte, value)) break;
+            if (value > std::min(this->d_maxElements,
+                detail::frame_ranges(this->d_container).max_size()))
+            {
+                throw std::runtime_error{"Frame has too many elements"};
+            }
+            this->d_numElements = value;
+            this->d_phase = Phase::LENGTHS;
+            if (this->d_numRanges == 0u) this->start_payload();
+            break;
+        case Phase::LENGTHS:
+            if (!this->read_varint_byte(byte, value)) break;
+            if (value > this->d_numElements - this->d_lengthsTotal)
+            {
+                throw std::runtime_error{"Frame lengths don't add up"};
+            }
+            this->d_lengthsTotal += value;
+            this->d_lengths.push_back(value);
+            if (this->d_lengths.size() == this->d_numRanges) this->start_payload();
+            break;
+        default:
+            break;
+        }
+    }
+    return numRead;
+}
+
+template <typename Container>
+inline bool FrameReader<Container>::done() const noexcept
+{
+    return this->d_phase == Phase::DONE;
+}
+
+template <typename Container>
+inline bool FrameReader<Container>::read_varint_byte(std::byte byte, std::uint64_t& value)
+{
+    if (this->d_varintShift >= 64u)
+    {
+        throw std::runtime_error{"Frame varint is too long"};
+    }
+
+    this->d_varint |= std::to_integer<std::uint64_t>(byte & std::byte{0x7fu})
+        << this->d_varintShift;
+    this->d_varintShift += 7u;
+    if ((byte & std::byte{0x80u}) != std::byte{0u}) return false;
+
+    value = std::exchange(this->d_varint, 0u);
+    this->d_varintShift = 0u;
+    return true;
+}
+
+template <typename Container>
+inline void FrameReader<Container>::start_payload()
+{
+    if (this->d_lengthsTotal != this->d_numElements)
+    {
+        throw std::runtime_error{"Frame lengths don't add up"};
+    }
+    const size_type longest = this->d_lengths.empty() ? 0u
+        : *std::max_element(this->d_lengths.begin(), this->d_lengths.end());
+
+    auto& ranges = detail::frame_ranges(this->d_container);
+    ranges.clear();
+    ranges.reserve(this->d_numElements);
+    if constexpr (has_num_ranges_v<Container>)
+    {
+        ranges.reserve_ranges(this->d_numRanges);
+        this->d_staging.resize(longest);
+    }
+    else
+    {
+        ranges.resize(this->d_numElements);
+    }
+
+    // Step back one, so that the first range is found just like the next.
+    this->d_phase = Phase::PAYLOAD;
+    this->d_range = std::numeric_limits<size_type>::max();
+    this->finish_range();
+}
+
+template <typename Container>
+inline void FrameReader<Container>::finish_range()
+{
+    const auto append = [this](size_type length) {
+        if constexpr (has_num_ranges_v<Container>)
+        {
+            const span<const Element> range{this->d_staging.data(), length};
+            detail::check_frame_order(this->d_container, range);
+            detail::frame_ranges(this->d_container).push_back_range(range);
+        }
+    };
+
+    if (this->d_range != std::numeric_limits<size_type>::max())
+    {
+        append(this->d_lengths[this->d_range]);
+    }
+
+    // Empty ranges have no payload bytes to wait for.
+    this->d_offset = 0u;
+    while (++this->d_range < this->d_lengths.size() && this->d_lengths[this->d_range] == 0u)
+    {
+        append(0u);
+    }
+
+    if (this->d_range == this->d_lengths.size())
+    {
+        this->d_phase = Phase::CHECKSUM;
+    }
+}
+
+} // close namespace tr::data_structures
+
+#endif // SERIALIZATION_HPP
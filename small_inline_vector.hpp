@@ -0,0 +1,364 @@
+#ifndef SMALL_INLINE_VECTOR_HPP
+#define SMALL_INLINE_VECTOR_HPP
+
+#include <inline_vector.hpp>
+#include <span.hpp>
+#include <utility.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+namespace tr::data_structures {
+
+template <typename T, std::size_t ElemsN, std::size_t RangesN>
+class SmallInlineBuffer {
+    // Storage for the first `ElemsN` elements and the first `RangesN`
+    // blocks of a `small_inline_vector`. Each region is handed out
+    // whole to the first request of its type which fits, until it is
+    // given back.
+
+    static_assert(ElemsN > 0u && RangesN > 0u);
+
+public: // Types
+    using size_type = std::size_t;
+
+public: // Construction
+    SmallInlineBuffer() noexcept;
+    SmallInlineBuffer(const SmallInlineBuffer&) = delete;
+
+public: // Assignment
+    SmallInlineBuffer& operator=(const SmallInlineBuffer&) = delete;
+
+public: // Allocation
+    // This returns the region for `U`s if it is free and can hold
+    // `n` of them, and a null pointer otherwise.
+    template <typename U>
+    [[nodiscard]] U* allocate(size_type n) noexcept;
+
+    // This returns whether `p` was the region for `U`s, in which
+    // case it is free again.
+    template <typename U>
+    bool deallocate(const U* p) noexcept;
+
+public: // Observers
+    // This returns whether both regions are in use, i.e. whether
+    // nothing has been moved to the heap.
+    [[nodiscard]] bool is_inline() const noexcept;
+
+private: // Members
+    alignas(T) std::byte        d_payload[sizeof(T) * ElemsN];
+    alignas(span<T>) std::byte  d_blocks[sizeof(span<T>) * RangesN];
+    bool                        d_payloadInUse;
+    bool                        d_blocksInUse;
+};
+
+template <typename T, typename Buffer>
+struct SmallInlineAllocator {
+    // The allocator of `small_inline_vector`, which takes memory from
+    // a `SmallInlineBuffer` when it can and from the heap otherwise.
+    // Allocators only compare equal if they share the same `Buffer`.
+
+public: // Types
+    using value_type = T;
+    using size_type = std::size_t;
+
+public: // Construction
+    constexpr SmallInlineAllocator(Buffer* buffer) noexcept;
+    template <typename U>
+    constexpr SmallInlineAllocator(const SmallInlineAllocator<U, Buffer>& other) noexcept;
+
+public: // Allocation
+    [[nodiscard]] T* allocate(size_type n);
+    void deallocate(T* p, size_type n) noexcept;
+
+public: // Accessors
+    [[nodiscard]] constexpr Buffer* buffer() const noexcept;
+
+private: // Members
+    Buffer* d_buffer;
+};
+
+template <typename T, std::size_t ElemsN, std::size_t RangesN>
+class small_inline_vector
+    : private SmallInlineBuffer<T, ElemsN, RangesN>
+    , private inline_vector<T, SmallInlineAllocator<T, SmallInlineBuffer<T, ElemsN, RangesN>>>
+{
+    // An `inline_vector` which keeps up to `ElemsN` elements in up to
+    // `RangesN` ranges inside the object itself, so small containers
+    // never allocate. Once either limit is exceeded that part of the
+    // container moves to the heap and stays there.
+    //
+    // Every move is element-wise, even once the container is on the
+    // heap: the allocator of each part is tied to its own object's
+    // buffer, so neither the heap buffer nor the blocks describing it
+    // can be handed to another container, which would free them with
+    // an allocator that doesn't own them. Moving therefore allocates
+    // whenever the contents don't fit inline, and is not `noexcept`.
+
+private: // Private Types
+    using Buffer = SmallInlineBuffer<T, ElemsN, RangesN>;
+    using Base = inline_vector<T, SmallInlineAllocator<T, Buffer>>;
+
+public: // Types
+    using typename Base::value_type;
+    using typename Base::reference;
+    using typename Base::const_reference;
+    using typename Base::pointer;
+    using typename Base::const_pointer;
+
+    using typename Base::iterator;
+    using typename Base::const_iterator;
+    using typename Base::reverse_iterator;
+    using typename Base::const_reverse_iterator;
+
+    using typename Base::size_type;
+    using typename Base::difference_type;
+
+public: // Constructors
+    small_inline_vector() noexcept;
+    small_inline_vector(const small_inline_vector& other);
+
+    // This moves the elements one at a time, leaving `other` empty.
+    small_inline_vector(small_inline_vector&& other);
+
+public: // Assignment
+    small_inline_vector& operator=(const small_inline_vector& other);
+    small_inline_vector& operator=(small_inline_vector&& other);
+
+public: // Capacity
+    using Base::empty;
+    using Base::size;
+    using Base::capacity;
+    using Base::num_ranges;
+    using Base::max_size;
+    using Base::reserve;
+    using Base::reserve_ranges;
+    using Base::memory_usage;
+
+    // This returns whether no part of the container is on the heap.
+    [[nodiscard]] bool is_inline() const noexcept;
+
+public: // Element Access
+    using Base::operator[];
+    using Base::at;
+    using Base::front;
+    using Base::back;
+
+public: // Iterators
+    using Base::begin;
+    using Base::cbegin;
+    using Base::end;
+    using Base::cend;
+    using Base::rbegin;
+    using Base::crbegin;
+    using Base::rend;
+    using Base::crend;
+
+public: // Modifiers
+    using Base::clear;
+    using Base::erase_range;
+    using Base::insert_range;
+    using Base::push_back_range;
+    using Base::pop_back_range;
+
+private: // Helpers
+    // Replace the contents with those of `other`, moving
+    // the elements if `Move` is set.
+    template <bool Move, typename Other>
+    void assign_from(Other& other);
+};
+
+// =================================================================
+// INLINE DEFINITIONS
+// =================================================================
+// SmallInlineBuffer
+template <typename T, std::size_t ElemsN, std::size_t RangesN>
+inline SmallInlineBuffer<T, ElemsN, RangesN>::SmallInlineBuffer() noexcept
+    : d_payloadInUse(false)
+    , d_blocksInUse(false)
+{}
+
+template <typename T, std::size_t ElemsN, std::size_t RangesN>
+template <typename U>
+inline U* SmallInlineBuffer<T, ElemsN, RangesN>::allocate(size_type n) noexcept
+{
+    if constexpr (std::is_same_v<U, T>)
+    {
+        if (this->d_payloadInUse || n > ElemsN) return nullptr;
+        this->d_payloadInUse = true;
+        return reinterpret_cast<U*>(this->d_payload);
+    }
+    else if constexpr (std::is_same_v<U, span<T>>)
+    {
+        if (this->d_blocksInUse || n > RangesN) return nullptr;
+        this->d_blocksInUse = true;
+        return reinterpret_cast<U*>(this->d_blocks);
+    }
+    else
+    {
+        return nullptr;
+    }
+}
+
+template <typename T, std::size_t ElemsN, std::size_t RangesN>
+template <typename U>
+inline bool SmallInlineBuffer<T, ElemsN, RangesN>::deallocate(const U* p) noexcept
+{
+    const auto* position = reinterpret_cast<const std::byte*>(p);
+    if (position == this->d_payload)
+    {
+        this->d_payloadInUse = false;
+        return true;
+    }
+    if (position == this->d_blocks)
+    {
+        this->d_blocksInUse = false;
+        return true;
+    }
+    return false;
+}
+
+template <typename T, std::size_t ElemsN, std::size_t RangesN>
+inline bool SmallInlineBuffer<T, ElemsN, RangesN>::is_inline() const noexcept
+{
+    return this->d_payloadInUse && this->d_blocksInUse;
+}
+
+// SmallInlineAllocator
+template <typename T, typename U, typename Buffer>
+inline constexpr bool operator==(const SmallInlineAllocator<T, Buffer>& lhs,
+    const SmallInlineAllocator<U, Buffer>& rhs) noexcept
+{
+    return lhs.buffer() == rhs.buffer();
+}
+
+template <typename T, typename U, typename Buffer>
+inline constexpr bool operator!=(const SmallInlineAllocator<T, Buffer>& lhs,
+    const SmallInlineAllocator<U, Buffer>& rhs) noexcept
+{
+    return !(lhs == rhs);
+}
+
+template <typename T, typename Buffer>
+inline constexpr SmallInlineAllocator<T, Buffer>::SmallInlineAllocator(Buffer* buffer) noexcept
+    : d_buffer(buffer)
+{}
+
+template <typename T, typename Buffer>
+template <typename U>
+inline constexpr SmallInlineAllocator<T, Buffer>::SmallInlineAllocator(
+    const SmallInlineAllocator<U, Buffer>& other) noexcept
+    : d_buffer(other.buffer())
+{}
+
+template <typename T, typename Buffer>
+inline T* SmallInlineAllocator<T, Buffer>::allocate(size_type n)
+{
+    if (T* p = d_buffer->template allocate<T>(n)) return p;
+    return std::allocator<T>{}.allocate(n);
+}
+
+template <typename T, typename Buffer>
+inline void SmallInlineAllocator<T, Buffer>::deallocate(T* p, size_type n) noexcept
+{
+    if (!d_buffer->deallocate(p))
+    {
+        std::allocator<T>{}.deallocate(p, n);
+    }
+}
+
+template <typename T, typename Buffer>
+inline constexpr Buffer* SmallInlineAllocator<T, Buffer>::buffer() const noexcept
+{
+    return d_buffer;
+}
+
+// Constructors
+template <typename T, std::size_t ElemsN, std::size_t RangesN>
+inline small_inline_vector<T, ElemsN, RangesN>::small_inline_vector() noexcept
+    : Buffer()
+    , Base(SmallInlineAllocator<T, Buffer>{static_cast<Buffer*>(this)})
+{
+    // Neither of these can fail, as the buffer is empty.
+    this->reserve_ranges(RangesN);
+    this->reserve(ElemsN);
+}
+
+template <typename T, std::size_t ElemsN, std::size_t RangesN>
+inline small_inline_vector<T, ElemsN, RangesN>::small_inline_vector(
+    const small_inline_vector& other)
+    : small_inline_vector()
+{
+    this->template assign_from<false>(other);
+}
+
+template <typename T, std::size_t ElemsN, std::size_t RangesN>
+inline small_inline_vector<T, ElemsN, RangesN>::small_inline_vector(
+    small_inline_vector&& other)
+    : small_inline_vector()
+{
+    this->template assign_from<true>(other);
+}
+
+// Assignment
+template <typename T, std::size_t ElemsN, std::size_t RangesN>
+inline small_inline_vector<T, ElemsN, RangesN>&
+    small_inline_vector<T, ElemsN, RangesN>::operator=(const small_inline_vector& other)
+{
+    if (this != &other)
+    {
+        this->template assign_from<false>(other);
+    }
+    return *this;
+}
+
+template <typename T, std::size_t ElemsN, std::size_t RangesN>
+inline small_inline_vector<T, ElemsN, RangesN>&
+    small_inline_vector<T, ElemsN, RangesN>::operator=(small_inline_vector&& other)
+{
+    if (this != &other)
+    {
+        this->template assign_from<true>(other);
+    }
+    return *this;
+}
+
+// Capacity
+template <typename T, std::size_t ElemsN, std::size_t RangesN>
+inline bool small_inline_vector<T, ElemsN, RangesN>::is_inline() const noexcept
+{
+    return Buffer::is_inline();
+}
+
+// Helpers
+template <typename T, std::size_t ElemsN, std::size_t RangesN>
+template <bool Move, typename Other>
+inline void small_inline_vector<T, ElemsN, RangesN>::assign_from(Other& other)
+{
+    this->clear();
+    this->reserve(other.size());
+    this->reserve_ranges(other.num_ranges());
+
+    for (const span<T>& range : other)
+    {
+        if constexpr (Move)
+        {
+            this->push_back_range(std::make_move_iterator(range.begin()),
+                std::make_move_iterator(range.end()));
+        }
+        else
+        {
+            this->push_back_range(range);
+        }
+    }
+
+    if constexpr (Move)
+    {
+        other.clear();
+    }
+}
+
+} // close namespace tr::data_structures
+
+#endif // SMALL_INLINE_VECTOR_HPP
@@ -1,6 +1,7 @@
 #ifndef SPAN_HPP
 #define SPAN_HPP
 
+#include <algorithm>
 #include <array>
 #include <cassert>
 #include <cstddef>
@@ -110,18 +111,44 @@ private: // Members
 // =================================================================
 
 // Comparison
-template <typename T>
-inline constexpr bool operator==(const span<T>& lhs, const span<T>& rhs) noexcept
+// These accept spans of differently-qualified `T` so that, for example,
+// a `span<T>` can be compared against a `span<const T>` key.
+template <typename T, typename U>
+inline constexpr bool operator==(const span<T>& lhs, const span<U>& rhs) noexcept
 {
     return std::equal(lhs.cbegin(), lhs.cend(), rhs.cbegin(), rhs.cend());
 }
 
-template <typename T>
-inline constexpr bool operator!=(const span<T>& lhs, const span<T>& rhs) noexcept
+template <typename T, typename U>
+inline constexpr bool operator!=(const span<T>& lhs, const span<U>& rhs) noexcept
 {
     return !(lhs == rhs);
 }
 
+template <typename T, typename U>
+inline constexpr bool operator<(const span<T>& lhs, const span<U>& rhs) noexcept
+{
+    return std::lexicographical_compare(lhs.cbegin(), lhs.cend(), rhs.cbegin(), rhs.cend());
+}
+
+template <typename T, typename U>
+inline constexpr bool operator>(const span<T>& lhs, const span<U>& rhs) noexcept
+{
+    return rhs < lhs;
+}
+
+template <typename T, typename U>
+inline constexpr bool operator<=(const span<T>& lhs, const span<U>& rhs) noexcept
+{
+    return !(rhs < lhs);
+}
+
+template <typename T, typename U>
+inline constexpr bool operator>=(const span<T>& lhs, const span<U>& rhs) noexcept
+{
+    return !(lhs < rhs);
+}
+
 // Constructors
 template <typename T>
 inline constexpr span<T>::span() noexcept
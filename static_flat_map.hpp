@@ -0,0 +1,302 @@
+#ifndef STATIC_FLAT_MAP_HPP
+#define STATIC_FLAT_MAP_HPP
+
+#include <span.hpp>
+#include <static_flat_set.hpp>
+#include <static_vector.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace tr::data_structures {
+
+template <typename Key, typename Value, std::size_t N, typename Compare = std::less<>>
+class static_flat_map : private Compare {
+    // A sorted map of at most `N` entries which lives entirely inside
+    // the object. Keys and values are kept in separate arrays so that
+    // a lookup only ever touches the keys (see `static_flat_lower_bound`)
+    // and then a single value.
+    //
+    // Since there are no pairs to point at, lookups return a pointer
+    // to the value, or a null pointer if the key is absent. Inserting
+    // a new key into a full map is a precondition violation.
+
+public: // Types
+    using key_type = Key;
+    using mapped_type = Value;
+    using key_compare = Compare;
+    using size_type = std::size_t;
+
+public: // Constructors
+    constexpr static_flat_map() noexcept(std::is_nothrow_default_constructible_v<Compare>);
+    explicit static_flat_map(const Compare& compare);
+    static_flat_map(std::initializer_list<std::pair<Key, Value>> ilist,
+        const Compare& compare = {});
+
+public: // Capacity
+    [[nodiscard]] constexpr bool empty() const noexcept;
+    [[nodiscard]] constexpr bool full() const noexcept;
+    [[nodiscard]] constexpr size_type size() const noexcept;
+    [[nodiscard]] constexpr size_type max_size() const noexcept;
+
+public: // Element Access
+    [[nodiscard]] Value& at(const Key& key);
+    [[nodiscard]] const Value& at(const Key& key) const;
+
+    // This inserts a value-initialized `Value` if `key` is absent.
+    Value& operator[](const Key& key);
+
+    // These return the keys in order and their values, respectively.
+    [[nodiscard]] span<const Key> keys() const noexcept;
+    [[nodiscard]] span<Value> values() noexcept;
+    [[nodiscard]] span<const Value> values() const noexcept;
+
+public: // Lookup
+    [[nodiscard]] Value* find(const Key& key);
+    [[nodiscard]] const Value* find(const Key& key) const;
+    [[nodiscard]] bool contains(const Key& key) const;
+    [[nodiscard]] size_type count(const Key& key) const;
+
+public: // Observers
+    [[nodiscard]] key_compare key_comp() const;
+
+public: // Modifiers
+    void clear() noexcept;
+
+    // These return the value for `key` and whether it was inserted.
+    std::pair<Value*, bool> insert(const Key& key, const Value& value);
+    std::pair<Value*, bool> insert_or_assign(const Key& key, const Value& value);
+    template <typename... Args>
+    std::pair<Value*, bool> try_emplace(const Key& key, Args&&... args);
+
+    size_type erase(const Key& key);
+
+private: // Helpers
+    // This returns the index of `key`, or `size()` if it is absent.
+    [[nodiscard]] size_type index_of(const Key& key) const;
+
+private: // Members
+    static_vector<Key, N>   d_keys;
+    static_vector<Value, N> d_values;
+};
+
+// =================================================================
+// INLINE DEFINITIONS
+// =================================================================
+// Constructors
+template <typename Key, typename Value, std::size_t N, typename Compare>
+inline constexpr static_flat_map<Key, Value, N, Compare>::static_flat_map()
+    noexcept(std::is_nothrow_default_constructible_v<Compare>)
+    : Compare()
+    , d_keys()
+    , d_values()
+{}
+
+template <typename Key, typename Value, std::size_t N, typename Compare>
+inline static_flat_map<Key, Value, N, Compare>::static_flat_map(const Compare& compare)
+    : Compare(compare)
+    , d_keys()
+    , d_values()
+{}
+
+template <typename Key, typename Value, std::size_t N, typename Compare>
+inline static_flat_map<Key, Value, N, Compare>::static_flat_map(
+    std::initializer_list<std::pair<Key, Value>> ilist, const Compare& compare)
+    : Compare(compare)
+    , d_keys()
+    , d_values()
+{
+    for (const auto& [key, value] : ilist)
+    {
+        this->insert(key, value);
+    }
+}
+
+// Capacity
+template <typename Key, typename Value, std::size_t N, typename Compare>
+inline constexpr bool static_flat_map<Key, Value, N, Compare>::empty() const noexcept
+{
+    return this->d_keys.empty();
+}
+
+template <typename Key, typename Value, std::size_t N, typename Compare>
+inline constexpr bool static_flat_map<Key, Value, N, Compare>::full() const noexcept
+{
+    return this->d_keys.full();
+}
+
+template <typename Key, typename Value, std::size_t N, typename Compare>
+inline constexpr typename static_flat_map<Key, Value, N, Compare>::size_type
+    static_flat_map<Key, Value, N, Compare>::size() const noexcept
+{
+    return this->d_keys.size();
+}
+
+template <typename Key, typename Value, std::size_t N, typename Compare>
+inline constexpr typename static_flat_map<Key, Value, N, Compare>::size_type
+    static_flat_map<Key, Value, N, Compare>::max_size() const noexcept
+{
+    return N;
+}
+
+// Element Access
+template <typename Key, typename Value, std::size_t N, typename Compare>
+inline Value& static_flat_map<Key, Value, N, Compare>::at(const Key& key)
+{
+    Value* value = this->find(key);
+    if (!value) { throw std::out_of_range{"Key not found"}; }
+    return *value;
+}
+
+template <typename Key, typename Value, std::size_t N, typename Compare>
+inline const Value& static_flat_map<Key, Value, N, Compare>::at(const Key& key) const
+{
+    const Value* value = this->find(key);
+    if (!value) { throw std::out_of_range{"Key not found"}; }
+    return *value;
+}
+
+template <typename Key, typename Value, std::size_t N, typename Compare>
+inline Value& static_flat_map<Key, Value, N, Compare>::operator[](const Key& key)
+{
+    return *this->try_emplace(key).first;
+}
+
+template <typename Key, typename Value, std::size_t N, typename Compare>
+inline span<const Key> static_flat_map<Key, Value, N, Compare>::keys() const noexcept
+{
+    return {this->d_keys.data(), this->d_keys.size()};
+}
+
+template <typename Key, typename Value, std::size_t N, typename Compare>
+inline span<Value> static_flat_map<Key, Value, N, Compare>::values() noexcept
+{
+    return {this->d_values.data(), this->d_values.size()};
+}
+
+template <typename Key, typename Value, std::size_t N, typename Compare>
+inline span<const Value> static_flat_map<Key, Value, N, Compare>::values() const noexcept
+{
+    return {this->d_values.data(), this->d_values.size()};
+}
+
+// Lookup
+template <typename Key, typename Value, std::size_t N, typename Compare>
+inline Value* static_flat_map<Key, Value, N, Compare>::find(const Key& key)
+{
+    const size_type index = this->index_of(key);
+    return (index != this->size()) ? this->d_values.data() + index : nullptr;
+}
+
+template <typename Key, typename Value, std::size_t N, typename Compare>
+inline const Value* static_flat_map<Key, Value, N, Compare>::find(const Key& key) const
+{
+    const size_type index = this->index_of(key);
+    return (index != this->size()) ? this->d_values.data() + index : nullptr;
+}
+
+template <typename Key, typename Value, std::size_t N, typename Compare>
+inline bool static_flat_map<Key, Value, N, Compare>::contains(const Key& key) const
+{
+    return this->index_of(key) != this->size();
+}
+
+template <typename Key, typename Value, std::size_t N, typename Compare>
+inline typename static_flat_map<Key, Value, N, Compare>::size_type
+    static_flat_map<Key, Value, N, Compare>::count(const Key& key) const
+{
+    return this->contains(key) ? 1u : 0u;
+}
+
+// Observers
+template <typename Key, typename Value, std::size_t N, typename Compare>
+inline typename static_flat_map<Key, Value, N, Compare>::key_compare
+    static_flat_map<Key, Value, N, Compare>::key_comp() const
+{
+    return *this;
+}
+
+// Modifiers
+template <typename Key, typename Value, std::size_t N, typename Compare>
+inline void static_flat_map<Key, Value, N, Compare>::clear() noexcept
+{
+    this->d_keys.clear();
+    this->d_values.clear();
+}
+
+template <typename Key, typename Value, std::size_t N, typename Compare>
+inline std::pair<Value*, bool> static_flat_map<Key, Value, N, Compare>::insert(const Key& key,
+    const Value& value)
+{
+    return this->try_emplace(key, value);
+}
+
+template <typename Key, typename Value, std::size_t N, typename Compare>
+inline std::pair<Value*, bool> static_flat_map<Key, Value, N, Compare>::insert_or_assign(
+    const Key& key, const Value& value)
+{
+    auto result = this->try_emplace(key, value);
+    if (!result.second)
+    {
+        *result.first = value;
+    }
+    return result;
+}
+
+template <typename Key, typename Value, std::size_t N, typename Compare>
+template <typename... Args>
+inline std::pair<Value*, bool> static_flat_map<Key, Value, N, Compare>::try_emplace(
+    const Key& key, Args&&... args)
+{
+    const Compare& compare = *this;
+    const size_type index = static_flat_lower_bound(this->d_keys.data(), this->d_keys.size(),
+        key, compare);
+    if (index != this->size() && !compare(key, this->d_keys[index]))
+    {
+        return {this->d_values.data() + index, false};
+    }
+
+    this->d_values.emplace(this->d_values.begin() + index, std::forward<Args>(args)...);
+    try {
+        this->d_keys.insert(this->d_keys.begin() + index, key);
+    }
+    catch (...)
+    {
+        this->d_values.erase(this->d_values.begin() + index);
+        throw;
+    }
+    return {this->d_values.data() + index, true};
+}
+
+template <typename Key, typename Value, std::size_t N, typename Compare>
+inline typename static_flat_map<Key, Value, N, Compare>::size_type
+    static_flat_map<Key, Value, N, Compare>::erase(const Key& key)
+{
+    const size_type index = this->index_of(key);
+    if (index == this->size()) return 0u;
+
+    this->d_keys.erase(this->d_keys.begin() + index);
+    this->d_values.erase(this->d_values.begin() + index);
+    return 1u;
+}
+
+// Helpers
+template <typename Key, typename Value, std::size_t N, typename Compare>
+inline typename static_flat_map<Key, Value, N, Compare>::size_type
+    static_flat_map<Key, Value, N, Compare>::index_of(const Key& key) const
+{
+    const Compare& compare = *this;
+    const size_type index = static_flat_lower_bound(this->d_keys.data(), this->d_keys.size(),
+        key, compare);
+    return (index != this->size() && !compare(key, this->d_keys[index]))
+        ? index
+        : this->size();
+}
+
+} // close namespace tr::data_structures
+
+#endif // STATIC_FLAT_MAP_HPP
@@ -0,0 +1,329 @@
+#ifndef STATIC_FLAT_SET_HPP
+#define STATIC_FLAT_SET_HPP
+
+#include <span.hpp>
+#include <static_vector.hpp>
+#include <utility.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace tr::data_structures {
+
+// Check to see if sorted `Key`s compared with `Compare` can be searched
+// by counting, with SIMD comparisons, how many keys are smaller.
+template <typename Key, typename Compare>
+inline constexpr bool is_simd_searchable_v =
+    (std::is_same_v<Compare, std::less<>> || std::is_same_v<Compare, std::less<Key>>)
+    && std::is_integral_v<Key> && !std::is_same_v<Key, bool>
+    && (sizeof(Key) == 4u || sizeof(Key) == 8u);
+
+// Return the index of the first of the `n` sorted keys from `first`
+// which is not less than `key`. Small tables of integers are scanned
+// with AVX2 where it is available, everything else uses a binary
+// search whose only branch is the loop condition.
+template <typename Key, typename Compare>
+inline std::size_t static_flat_lower_bound(const Key* first, std::size_t n, const Key& key,
+    const Compare& compare)
+{
+#if defined(__AVX2__)
+    if constexpr (is_simd_searchable_v<Key, Compare>)
+    {
+        // The keys are sorted, so the number less than `key` is its
+        // lower bound. AVX2 only compares signed integers, so unsigned
+        // ones have their top bit flipped first.
+        std::size_t count = 0u;
+        std::size_t i = 0u;
+        if constexpr (sizeof(Key) == 4u)
+        {
+            const __m256i bias = _mm256_set1_epi32(
+                std::is_signed_v<Key> ? 0 : std::numeric_limits<std::int32_t>::min());
+            const __m256i needle = _mm256_xor_si256(
+                _mm256_set1_epi32(static_cast<std::int32_t>(key)), bias);
+            for (; i + 8u <= n; i += 8u)
+            {
+                const __m256i keys = _mm256_xor_si256(bias,
+                    _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first + i)));
+                const __m256i less = _mm256_cmpgt_epi32(needle, keys);
+                count += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(less)));
+            }
+        }
+        else
+        {
+            const __m256i bias = _mm256_set1_epi64x(
+                std::is_signed_v<Key> ? 0 : std::numeric_limits<std::int64_t>::min());
+            const __m256i needle = _mm256_xor_si256(
+                _mm256_set1_epi64x(static_cast<std::int64_t>(key)), bias);
+            for (; i + 4u <= n; i += 4u)
+            {
+                const __m256i keys = _mm256_xor_si256(bias,
+                    _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first + i)));
+                const __m256i less = _mm256_cmpgt_epi64(needle, keys);
+                count += __builtin_popcount(_mm256_movemask_pd(_mm256_castsi256_pd(less)));
+            }
+        }
+
+        for (; i < n; ++i)
+        {
+            count += static_cast<std::size_t>(first[i] < key);
+        }
+        return count;
+    }
+#endif
+
+    if (n == 0u) return 0u;
+
+    const Key* base = first;
+    while (n > 1u)
+    {
+        const std::size_t half = n / 2u;
+        base = compare(base[half], key) ? base + half : base;
+        n -= half;
+    }
+    return static_cast<std::size_t>(base - first) + compare(*base, key);
+}
+
+template <typename Key, std::size_t N, typename Compare = std::less<>>
+class static_flat_set : private Compare {
+    // A sorted set of at most `N` keys which lives entirely inside the
+    // object, for small lookup tables where `std::set` would spend its
+    // time chasing pointers. Lookups use `static_flat_lower_bound`.
+    //
+    // Inserting a new key into a full set is a precondition violation.
+
+public: // Types
+    using key_type = Key;
+    using value_type = Key;
+    using key_compare = Compare;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    using reference = const Key&;
+    using const_reference = const Key&;
+    using iterator = const Key*;
+    using const_iterator = const Key*;
+
+public: // Constructors
+    constexpr static_flat_set() noexcept(std::is_nothrow_default_constructible_v<Compare>);
+    explicit static_flat_set(const Compare& compare);
+    static_flat_set(std::initializer_list<Key> ilist, const Compare& compare = {});
+
+public: // Capacity
+    [[nodiscard]] constexpr bool empty() const noexcept;
+    [[nodiscard]] constexpr bool full() const noexcept;
+    [[nodiscard]] constexpr size_type size() const noexcept;
+    [[nodiscard]] constexpr size_type max_size() const noexcept;
+
+public: // Iterators
+    [[nodiscard]] constexpr const_iterator begin() const noexcept;
+    [[nodiscard]] constexpr const_iterator cbegin() const noexcept;
+    [[nodiscard]] constexpr const_iterator end() const noexcept;
+    [[nodiscard]] constexpr const_iterator cend() const noexcept;
+
+public: // Lookup
+    [[nodiscard]] const_iterator lower_bound(const Key& key) const;
+    [[nodiscard]] const_iterator find(const Key& key) const;
+    [[nodiscard]] bool contains(const Key& key) const;
+    [[nodiscard]] size_type count(const Key& key) const;
+
+public: // Observers
+    [[nodiscard]] key_compare key_comp() const;
+
+public: // Modifiers
+    void clear() noexcept;
+
+    std::pair<iterator, bool> insert(const Key& key);
+
+    iterator erase(const_iterator pos);
+    size_type erase(const Key& key);
+
+private: // Helpers
+    [[nodiscard]] bool equivalent(const Key& lhs, const Key& rhs) const;
+
+private: // Members
+    static_vector<Key, N>   d_keys;
+};
+
+// =================================================================
+// INLINE DEFINITIONS
+// =================================================================
+// Constructors
+template <typename Key, std::size_t N, typename Compare>
+inline constexpr static_flat_set<Key, N, Compare>::static_flat_set()
+    noexcept(std::is_nothrow_default_constructible_v<Compare>)
+    : Compare()
+    , d_keys()
+{}
+
+template <typename Key, std::size_t N, typename Compare>
+inline static_flat_set<Key, N, Compare>::static_flat_set(const Compare& compare)
+    : Compare(compare)
+    , d_keys()
+{}
+
+template <typename Key, std::size_t N, typename Compare>
+inline static_flat_set<Key, N, Compare>::static_flat_set(std::initializer_list<Key> ilist,
+    const Compare& compare)
+    : Compare(compare)
+    , d_keys()
+{
+    for (const Key& key : ilist)
+    {
+        this->insert(key);
+    }
+}
+
+// Capacity
+template <typename Key, std::size_t N, typename Compare>
+inline constexpr bool static_flat_set<Key, N, Compare>::empty() const noexcept
+{
+    return this->d_keys.empty();
+}
+
+template <typename Key, std::size_t N, typename Compare>
+inline constexpr bool static_flat_set<Key, N, Compare>::full() const noexcept
+{
+    return this->d_keys.full();
+}
+
+template <typename Key, std::size_t N, typename Compare>
+inline constexpr typename static_flat_set<Key, N, Compare>::size_type
+    static_flat_set<Key, N, Compare>::size() const noexcept
+{
+    return this->d_keys.size();
+}
+
+template <typename Key, std::size_t N, typename Compare>
+inline constexpr typename static_flat_set<Key, N, Compare>::size_type
+    static_flat_set<Key, N, Compare>::max_size() const noexcept
+{
+    return N;
+}
+
+// Iterators
+template <typename Key, std::size_t N, typename Compare>
+inline constexpr typename static_flat_set<Key, N, Compare>::const_iterator
+    static_flat_set<Key, N, Compare>::begin() const noexcept
+{
+    return this->d_keys.begin();
+}
+
+template <typename Key, std::size_t N, typename Compare>
+inline constexpr typename static_flat_set<Key, N, Compare>::const_iterator
+    static_flat_set<Key, N, Compare>::cbegin() const noexcept
+{
+    return this->d_keys.cbegin();
+}
+
+template <typename Key, std::size_t N, typename Compare>
+inline constexpr typename static_flat_set<Key, N, Compare>::const_iterator
+    static_flat_set<Key, N, Compare>::end() const noexcept
+{
+    return this->d_keys.end();
+}
+
+template <typename Key, std::size_t N, typename Compare>
+inline constexpr typename static_flat_set<Key, N, Compare>::const_iterator
+    static_flat_set<Key, N, Compare>::cend() const noexcept
+{
+    return this->d_keys.cend();
+}
+
+// Lookup
+template <typename Key, std::size_t N, typename Compare>
+inline typename static_flat_set<Key, N, Compare>::const_iterator
+    static_flat_set<Key, N, Compare>::lower_bound(const Key& key) const
+{
+    return this->d_keys.begin() + static_flat_lower_bound(this->d_keys.data(),
+        this->d_keys.size(), key, static_cast<const Compare&>(*this));
+}
+
+template <typename Key, std::size_t N, typename Compare>
+inline typename static_flat_set<Key, N, Compare>::const_iterator
+    static_flat_set<Key, N, Compare>::find(const Key& key) const
+{
+    const_iterator it = this->lower_bound(key);
+    return (it != this->end() && this->equivalent(*it, key)) ? it : this->end();
+}
+
+template <typename Key, std::size_t N, typename Compare>
+inline bool static_flat_set<Key, N, Compare>::contains(const Key& key) const
+{
+    return this->find(key) != this->end();
+}
+
+template <typename Key, std::size_t N, typename Compare>
+inline typename static_flat_set<Key, N, Compare>::size_type
+    static_flat_set<Key, N, Compare>::count(const Key& key) const
+{
+    return this->contains(key) ? 1u : 0u;
+}
+
+// Observers
+template <typename Key, std::size_t N, typename Compare>
+inline typename static_flat_set<Key, N, Compare>::key_compare
+    static_flat_set<Key, N, Compare>::key_comp() const
+{
+    return *this;
+}
+
+// Modifiers
+template <typename Key, std::size_t N, typename Compare>
+inline void static_flat_set<Key, N, Compare>::clear() noexcept
+{
+    this->d_keys.clear();
+}
+
+template <typename Key, std::size_t N, typename Compare>
+inline std::pair<typename static_flat_set<Key, N, Compare>::iterator, bool>
+    static_flat_set<Key, N, Compare>::insert(const Key& key)
+{
+    const_iterator it = this->lower_bound(key);
+    if (it != this->end() && this->equivalent(*it, key))
+    {
+        return {it, false};
+    }
+
+    return {this->d_keys.insert(it, key), true};
+}
+
+template <typename Key, std::size_t N, typename Compare>
+inline typename static_flat_set<Key, N, Compare>::iterator
+    static_flat_set<Key, N, Compare>::erase(const_iterator pos)
+{
+    return this->d_keys.erase(pos);
+}
+
+template <typename Key, std::size_t N, typename Compare>
+inline typename static_flat_set<Key, N, Compare>::size_type
+    static_flat_set<Key, N, Compare>::erase(const Key& key)
+{
+    const_iterator it = this->find(key);
+    if (it == this->end()) return 0u;
+
+    this->d_keys.erase(it);
+    return 1u;
+}
+
+// Helpers
+template <typename Key, std::size_t N, typename Compare>
+inline bool static_flat_set<Key, N, Compare>::equivalent(const Key& lhs, const Key& rhs) const
+{
+    const Compare& compare = *this;
+    return !compare(lhs, rhs) && !compare(rhs, lhs);
+}
+
+} // close namespace tr::data_structures
+
+#endif // STATIC_FLAT_SET_HPP
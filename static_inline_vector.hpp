@@ -0,0 +1,590 @@
+#ifndef STATIC_INLINE_VECTOR_HPP
+#define STATIC_INLINE_VECTOR_HPP
+
+#include <span.hpp>
+#include <utility.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+namespace tr::data_structures {
+
+template <typename T, std::size_t MaxElems, std::size_t MaxRanges>
+class static_inline_vector {
+    // A vector of sequences stored inline, like `inline_vector`, but
+    // with room for at most `MaxElems` elements in at most `MaxRanges`
+    // ranges held inside the object itself.
+    //
+    // It never allocates and never throws. Overflowing it through
+    // `push_back_range` or `insert_range` is a precondition violation;
+    // the `try_` variants report it by returning `false` instead and
+    // leave the container untouched.
+
+    static_assert(MaxElems > 0u && MaxRanges > 0u);
+    static_assert(std::is_nothrow_copy_constructible_v<T>
+        && std::is_nothrow_copy_assignable_v<T>
+        && std::is_nothrow_move_constructible_v<T>
+        && std::is_nothrow_move_assignable_v<T>,
+        "static_inline_vector cannot report an exception from `T`");
+
+public: // Types
+    using value_type = span<T>;
+    using reference = const span<T>&;
+    using const_reference = const span<T>&;
+    using pointer = const span<T>*;
+    using const_pointer = const span<T>*;
+
+    using iterator = const span<T>*;
+    using const_iterator = const span<T>*;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+public: // Constructors
+    static_inline_vector() noexcept;
+    static_inline_vector(const static_inline_vector& other) noexcept;
+    static_inline_vector(static_inline_vector&& other) noexcept;
+    ~static_inline_vector();
+
+public: // Assignment
+    static_inline_vector& operator=(const static_inline_vector& other) noexcept;
+    static_inline_vector& operator=(static_inline_vector&& other) noexcept;
+
+public: // Capacity
+    [[nodiscard]] bool empty() const noexcept;
+
+    // This returns the current size of the container in sizeof(T).
+    [[nodiscard]] size_type size() const noexcept;
+
+    // This returns the capacity of the container in sizeof(T), which
+    // is always `MaxElems`.
+    [[nodiscard]] constexpr size_type capacity() const noexcept;
+
+    // This returns the number of elements (ranges) in the container.
+    [[nodiscard]] size_type num_ranges() const noexcept;
+
+    [[nodiscard]] constexpr size_type max_size() const noexcept;
+    [[nodiscard]] constexpr size_type max_ranges() const noexcept;
+
+    // This returns how much of the object is taken up by the elements,
+    // the blocks describing the ranges and unused capacity.
+    [[nodiscard]] MemoryUsage memory_usage() const noexcept;
+
+public: // Element Access
+    [[nodiscard]] reference operator[](size_type index) noexcept;
+    [[nodiscard]] const_reference operator[](size_type index) const noexcept;
+
+    [[nodiscard]] reference front() noexcept;
+    [[nodiscard]] const_reference front() const noexcept;
+
+    [[nodiscard]] reference back() noexcept;
+    [[nodiscard]] const_reference back() const noexcept;
+
+public: // Iterators
+    [[nodiscard]] iterator begin() noexcept;
+    [[nodiscard]] const_iterator begin() const noexcept;
+    [[nodiscard]] const_iterator cbegin() const noexcept;
+
+    [[nodiscard]] iterator end() noexcept;
+    [[nodiscard]] const_iterator end() const noexcept;
+    [[nodiscard]] const_iterator cend() const noexcept;
+
+    [[nodiscard]] reverse_iterator rbegin() noexcept;
+    [[nodiscard]] const_reverse_iterator rbegin() const noexcept;
+    [[nodiscard]] const_reverse_iterator crbegin() const noexcept;
+
+    [[nodiscard]] reverse_iterator rend() noexcept;
+    [[nodiscard]] const_reverse_iterator rend() const noexcept;
+    [[nodiscard]] const_reverse_iterator crend() const noexcept;
+
+public: // Modifiers
+    void clear() noexcept;
+
+    iterator erase_range(const_iterator pos) noexcept;
+    iterator erase_range(const_iterator first, const_iterator last) noexcept;
+
+    iterator insert_range(const_iterator pos, span<std::add_const_t<T>> range) noexcept;
+    [[nodiscard]] bool try_insert_range(const_iterator pos,
+        span<std::add_const_t<T>> range) noexcept;
+
+    void push_back_range(span<std::add_const_t<T>> range) noexcept;
+    template <typename ForwardIt>
+    void push_back_range(ForwardIt first, ForwardIt last) noexcept;
+
+    [[nodiscard]] bool try_push_back_range(span<std::add_const_t<T>> range) noexcept;
+    template <typename ForwardIt>
+    [[nodiscard]] bool try_push_back_range(ForwardIt first, ForwardIt last) noexcept;
+
+    void pop_back_range() noexcept;
+
+private: // Private Types
+    using Block = span<T>;
+
+private: // Helpers
+    [[nodiscard]] T* data() noexcept;
+    [[nodiscard]] const T* data() const noexcept;
+
+    [[nodiscard]] bool fits(size_type length) const noexcept;
+
+    // Copy or move the contents of `other` into this, which is empty.
+    template <typename Other>
+    void construct_from(Other&& other) noexcept;
+
+private: // Members
+    alignas(T) std::byte    d_storage[sizeof(T) * MaxElems];
+    Block                   d_blocks[MaxRanges];
+    size_type               d_size;
+    size_type               d_numRanges;
+};
+
+// =================================================================
+// INLINE DEFINITIONS
+// =================================================================
+// Constructors
+template <typename T, std::size_t MaxElems, std::size_t MaxRanges>
+inline static_inline_vector<T, MaxElems, MaxRanges>::static_inline_vector() noexcept
+    : d_size(0u)
+    , d_numRanges(0u)
+{}
+
+template <typename T, std::size_t MaxElems, std::size_t MaxRanges>
+inline static_inline_vector<T, MaxElems, MaxRanges>::static_inline_vector(
+    const static_inline_vector& other) noexcept
+    : static_inline_vector()
+{
+    this->construct_from(other);
+}
+
+template <typename T, std::size_t MaxElems, std::size_t MaxRanges>
+inline static_inline_vector<T, MaxElems, MaxRanges>::static_inline_vector(
+    static_inline_vector&& other) noexcept
+    : static_inline_vector()
+{
+    this->construct_from(std::move(other));
+    other.clear();
+}
+
+template <typename T, std::size_t MaxElems, std::size_t MaxRanges>
+inline static_inline_vector<T, MaxElems, MaxRanges>::~static_inline_vector()
+{
+    this->clear();
+}
+
+// Assignment
+template <typename T, std::size_t MaxElems, std::size_t MaxRanges>
+inline static_inline_vector<T, MaxElems, MaxRanges>&
+    static_inline_vector<T, MaxElems, MaxRanges>::operator=(
+        const static_inline_vector& other) noexcept
+{
+    if (this != &other)
+    {
+        this->clear();
+        this->construct_from(other);
+    }
+    return *this;
+}
+
+template <typename T, std::size_t MaxElems, std::size_t MaxRanges>
+inline static_inline_vector<T, MaxElems, MaxRanges>&
+    static_inline_vector<T, MaxElems, MaxRanges>::operator=(
+        static_inline_vector&& other) noexcept
+{
+    if (this != &other)
+    {
+        this->clear();
+        this->construct_from(std::move(other));
+        other.clear();
+    }
+    return *this;
+}
+
+// Capacity
+template <typename T, std::size_t MaxElems, std::size_t MaxRanges>
+inline bool static_inline_vector<T, MaxElems, MaxRanges>::empty() const noexcept
+{
+    return (this->d_size == 0u);
+}
+
+template <typename T, std::size_t MaxElems, std::size_t MaxRanges>
+inline typename static_inline_vector<T, MaxElems, MaxRanges>::size_type
+    static_inline_vector<T, MaxElems, MaxRanges>::size() const noexcept
+{
+    return this->d_size;
+}
+
+template <typename T, std::size_t MaxElems, std::size_t MaxRanges>
+inline constexpr typename static_inline_vector<T, MaxElems, MaxRanges>::size_type
+    static_inline_vector<T, MaxElems, MaxRanges>::capacity() const noexcept
+{
+    return MaxElems;
+}
+
+template <typename T, std::size_t MaxElems, std::size_t MaxRanges>
+inline typename static_inline_vector<T, MaxElems, MaxRanges>::size_type
+    static_inline_vector<T, MaxElems, MaxRanges>::num_ranges() const noexcept
+{
+    return this->d_numRanges;
+}
+
+template <typename T, std::size_t MaxElems, std::size_t MaxRanges>
+inline constexpr typename static_inline_vector<T, MaxElems, MaxRanges>::size_type
+    static_inline_vector<T, MaxElems, MaxRanges>::max_size() const noexcept
+{
+    return MaxElems;
+}
+
+template <typename T, std::size_t MaxElems, std::size_t MaxRanges>
+inline constexpr typename static_inline_vector<T, MaxElems, MaxRanges>::size_type
+    static_inline_vector<T, MaxElems, MaxRanges>::max_ranges() const noexcept
+{
+    return MaxRanges;
+}
+
+template <typename T, std::size_t MaxElems, std::size_t MaxRanges>
+inline MemoryUsage static_inline_vector<T, MaxElems, MaxRanges>::memory_usage() const noexcept
+{
+    return {
+        sizeof(T) * this->d_size,
+        sizeof(T) * (MaxElems - this->d_size),
+        sizeof(Block) * this->d_numRanges,
+        sizeof(Block) * (MaxRanges - this->d_numRanges)
+    };
+}
+
+// Element Access
+template <typename T, std::size_t MaxElems, std::size_t MaxRanges>
+inline typename static_inline_vector<T, MaxElems, MaxRanges>::reference
+    static_inline_vector<T, MaxElems, MaxRanges>::operator[](size_type index) noexcept
+{
+    assert(index < this->d_numRanges);
+    return this->d_blocks[index];
+}
+
+template <typename T, std::size_t MaxElems, std::size_t MaxRanges>
+inline typename static_inline_vector<T, MaxElems, MaxRanges>::const_reference
+    static_inline_vector<T, MaxElems, MaxRanges>::operator[](size_type index) const noexcept
+{
+    assert(index < this->d_numRanges);
+    return this->d_blocks[index];
+}
+
+template <typename T, std::size_t MaxElems, std::size_t MaxRanges>
+inline typename static_inline_vector<T, MaxElems, MaxRanges>::reference
+    static_inline_vector<T, MaxElems, MaxRanges>::front() noexcept
+{
+    return this->operator[](0u);
+}
+
+template <typename T, std::size_t MaxElems, std::size_t MaxRanges>
+inline typename static_inline_vector<T, MaxElems, MaxRanges>::const_reference
+    static_inline_vector<T, MaxElems, MaxRanges>::front() const noexcept
+{
+    return this->operator[](0u);
+}
+
+template <typename T, std::size_t MaxElems, std::size_t MaxRanges>
+inline typename static_inline_vector<T, MaxElems, MaxRanges>::reference
+    static_inline_vector<T, MaxElems, MaxRanges>::back() noexcept
+{
+    return this->operator[](this->d_numRanges - 1u);
+}
+
+template <typename T, std::size_t MaxElems, std::size_t MaxRanges>
+inline typename static_inline_vector<T, MaxElems, MaxRanges>::const_reference
+    static_inline_vector<T, MaxElems, MaxRanges>::back() const noexcept
+{
+    return this->operator[](this->d_numRanges - 1u);
+}
+
+// Iterators
+template <typename T, std::size_t MaxElems, std::size_t MaxRanges>
+inline typename static_inline_vector<T, MaxElems, MaxRanges>::iterator
+    static_inline_vector<T, MaxElems, MaxRanges>::begin() noexcept
+{
+    return this->d_blocks;
+}
+
+template <typename T, std::size_t MaxElems, std::size_t MaxRanges>
+inline typename static_inline_vector<T, MaxElems, MaxRanges>::const_iterator
+    static_inline_vector<T, MaxElems, MaxRanges>::begin() const noexcept
+{
+    return this->cbegin();
+}
+
+template <typename T, std::size_t MaxElems, std::size_t MaxRanges>
+inline typename static_inline_vector<T, MaxElems, MaxRanges>::const_iterator
+    static_inline_vector<T, MaxElems, MaxRanges>::cbegin() const noexcept
+{
+    return this->d_blocks;
+}
+
+template <typename T, std::size_t MaxElems, std::size_t MaxRanges>
+inline typename static_inline_vector<T, MaxElems, MaxRanges>::iterator
+    static_inline_vector<T, MaxElems, MaxRanges>::end() noexcept
+{
+    return this->d_blocks + this->d_numRanges;
+}
+
+template <typename T, std::size_t MaxElems, std::size_t MaxRanges>
+inline typename static_inline_vector<T, MaxElems, MaxRanges>::const_iterator
+    static_inline_vector<T, MaxElems, MaxRanges>::end() const noexcept
+{
+    return this->cend();
+}
+
+template <typename T, std::size_t MaxElems, std::size_t MaxRanges>
+inline typename static_inline_vector<T, MaxElems, MaxRanges>::const_iterator
+    static_inline_vector<T, MaxElems, MaxRanges>::cend() const noexcept
+{
+    return this->d_blocks + this->d_numRanges;
+}
+
+template <typename T, std::size_t MaxElems, std::size_t MaxRanges>
+inline typename static_inline_vector<T, MaxElems, MaxRanges>::reverse_iterator
+    static_inline_vector<T, MaxElems, MaxRanges>::rbegin() noexcept
+{
+    return reverse_iterator{this->end()};
+}
+
+template <typename T, std::size_t MaxElems, std::size_t MaxRanges>
+inline typename static_inline_vector<T, MaxElems, MaxRanges>::const_reverse_iterator
+    static_inline_vector<T, MaxElems, MaxRanges>::rbegin() const noexcept
+{
+    return this->crbegin();
+}
+
+template <typename T, std::size_t MaxElems, std::size_t MaxRanges>
+inline typename static_inline_vector<T, MaxElems, MaxRanges>::const_reverse_iterator
+    static_inline_vector<T, MaxElems, MaxRanges>::crbegin() const noexcept
+{
+    return const_reverse_iterator{this->cend()};
+}
+
+template <typename T, std::size_t MaxElems, std::size_t MaxRanges>
+inline typename static_inline_vector<T, MaxElems, MaxRanges>::reverse_iterator
+    static_inline_vector<T, MaxElems, MaxRanges>::rend() noexcept
+{
+    return reverse_iterator{this->begin()};
+}
+
+template <typename T, std::size_t MaxElems, std::size_t MaxRanges>
+inline typename static_inline_vector<T, MaxElems, MaxRanges>::const_reverse_iterator
+    static_inline_vector<T, MaxElems, MaxRanges>::rend() const noexcept
+{
+    return this->crend();
+}
+
+template <typename T, std::size_t MaxElems, std::size_t MaxRanges>
+inline typename static_inline_vector<T, MaxElems, MaxRanges>::const_reverse_iterator
+    static_inline_vector<T, MaxElems, MaxRanges>::crend() const noexcept
+{
+    return const_reverse_iterator{this->cbegin()};
+}
+
+// Modifiers
+template <typename T, std::size_t MaxElems, std::size_t MaxRanges>
+inline void static_inline_vector<T, MaxElems, MaxRanges>::clear() noexcept
+{
+    std::destroy(this->data(), this->data() + this->d_size);
+    this->d_size = 0u;
+    this->d_numRanges = 0u;
+}
+
+template <typename T, std::size_t MaxElems, std::size_t MaxRanges>
+inline typename static_inline_vector<T, MaxElems, MaxRanges>::iterator
+    static_inline_vector<T, MaxElems, MaxRanges>::erase_range(const_iterator pos) noexcept
+{
+    return this->erase_range(pos, pos + 1);
+}
+
+template <typename T, std::size_t MaxElems, std::size_t MaxRanges>
+inline typename static_inline_vector<T, MaxElems, MaxRanges>::iterator
+    static_inline_vector<T, MaxElems, MaxRanges>::erase_range(const_iterator first,
+        const_iterator last) noexcept
+{
+    if (first == last) return first;
+
+    const auto firstIndex = static_cast<size_type>(first - this->d_blocks);
+    const auto lastIndex = static_cast<size_type>(last - this->d_blocks);
+    const auto offset = static_cast<size_type>(first->data() - this->data());
+    const auto length = static_cast<size_type>(
+        (last - 1)->data() + (last - 1)->length() - first->data());
+
+    T* begin = this->data();
+    std::move(begin + offset + length, begin + this->d_size, begin + offset);
+    std::destroy(begin + this->d_size - length, begin + this->d_size);
+    this->d_size -= length;
+
+    std::transform(this->d_blocks + lastIndex, this->d_blocks + this->d_numRanges,
+        this->d_blocks + firstIndex, [length](Block block) noexcept {
+            return Block{block.data() - length, block.length()};
+        });
+    this->d_numRanges -= lastIndex - firstIndex;
+
+    return this->d_blocks + firstIndex;
+}
+
+template <typename T, std::size_t MaxElems, std::size_t MaxRanges>
+inline typename static_inline_vector<T, MaxElems, MaxRanges>::iterator
+    static_inline_vector<T, MaxElems, MaxRanges>::insert_range(const_iterator pos,
+        span<std::add_const_t<T>> range) noexcept
+{
+    const auto index = static_cast<size_type>(pos - this->d_blocks);
+    [[maybe_unused]] const bool inserted = this->try_insert_range(pos, range);
+    assert(inserted);
+    return this->d_blocks + index;
+}
+
+template <typename T, std::size_t MaxElems, std::size_t MaxRanges>
+inline bool static_inline_vector<T, MaxElems, MaxRanges>::try_insert_range(const_iterator pos,
+    span<std::add_const_t<T>> range) noexcept
+{
+    if (!this->fits(range.length())) return false;
+
+    const auto index = static_cast<size_type>(pos - this->d_blocks);
+    const size_type offset = (index == this->d_numRanges)
+        ? this->d_size
+        : static_cast<size_type>(pos->data() - this->data());
+    const size_type length = range.length();
+
+    // Open a gap of `length` elements at `offset`. Slots of the gap
+    // below the old size still hold (moved-from) objects which are
+    // assigned to, the rest are constructed in place.
+    T* begin = this->data();
+    const size_type numToConstruct = std::min(length, this->d_size - offset);
+    std::uninitialized_move(begin + this->d_size - numToConstruct, begin + this->d_size,
+        begin + this->d_size - numToConstruct + length);
+    std::move_backward(begin + offset, begin + this->d_size - numToConstruct,
+        begin + this->d_size - numToConstruct + length);
+
+    for (size_type i = 0u; i < length; ++i)
+    {
+        if (offset + i < this->d_size)
+        {
+            begin[offset + i] = range[i];
+        }
+        else
+        {
+            ::new (static_cast<void*>(begin + offset + i)) T(range[i]);
+        }
+    }
+    this->d_size += length;
+
+    std::copy_backward(this->d_blocks + index, this->d_blocks + this->d_numRanges,
+        this->d_blocks + this->d_numRanges + 1);
+    std::for_each(this->d_blocks + index + 1, this->d_blocks + this->d_numRanges + 1,
+        [length](Block& block) noexcept {
+            block = Block{block.data() + length, block.length()};
+        });
+    this->d_blocks[index] = Block{begin + offset, length};
+    ++this->d_numRanges;
+
+    return true;
+}
+
+template <typename T, std::size_t MaxElems, std::size_t MaxRanges>
+inline void static_inline_vector<T, MaxElems, MaxRanges>::push_back_range(
+    span<std::add_const_t<T>> range) noexcept
+{
+    this->push_back_range(range.begin(), range.end());
+}
+
+template <typename T, std::size_t MaxElems, std::size_t MaxRanges>
+template <typename ForwardIt>
+inline void static_inline_vector<T, MaxElems, MaxRanges>::push_back_range(ForwardIt first,
+    ForwardIt last) noexcept
+{
+    [[maybe_unused]] const bool pushed = this->try_push_back_range(first, last);
+    assert(pushed);
+}
+
+template <typename T, std::size_t MaxElems, std::size_t MaxRanges>
+inline bool static_inline_vector<T, MaxElems, MaxRanges>::try_push_back_range(
+    span<std::add_const_t<T>> range) noexcept
+{
+    return this->try_push_back_range(range.begin(), range.end());
+}
+
+template <typename T, std::size_t MaxElems, std::size_t MaxRanges>
+template <typename ForwardIt>
+inline bool static_inline_vector<T, MaxElems, MaxRanges>::try_push_back_range(ForwardIt first,
+    ForwardIt last) noexcept
+{
+    static_assert(at_least_forward_iterator_v<ForwardIt>,
+        "The length of the range must be known before it is copied");
+    static_assert(std::is_nothrow_constructible_v<T,
+        typename std::iterator_traits<ForwardIt>::reference>);
+
+    const auto length = static_cast<size_type>(std::distance(first, last));
+    if (!this->fits(length)) return false;
+
+    T* position = this->data() + this->d_size;
+    std::uninitialized_copy(first, last, position);
+    this->d_blocks[this->d_numRanges++] = Block{position, length};
+    this->d_size += length;
+    return true;
+}
+
+template <typename T, std::size_t MaxElems, std::size_t MaxRanges>
+inline void static_inline_vector<T, MaxElems, MaxRanges>::pop_back_range() noexcept
+{
+    assert(this->d_numRanges > 0u);
+    const Block& block = this->d_blocks[--this->d_numRanges];
+    std::destroy(block.begin(), block.end());
+    this->d_size -= block.length();
+}
+
+// Helpers
+template <typename T, std::size_t MaxElems, std::size_t MaxRanges>
+inline T* static_inline_vector<T, MaxElems, MaxRanges>::data() noexcept
+{
+    return std::launder(reinterpret_cast<T*>(this->d_storage));
+}
+
+template <typename T, std::size_t MaxElems, std::size_t MaxRanges>
+inline const T* static_inline_vector<T, MaxElems, MaxRanges>::data() const noexcept
+{
+    return std::launder(reinterpret_cast<const T*>(this->d_storage));
+}
+
+template <typename T, std::size_t MaxElems, std::size_t MaxRanges>
+inline bool static_inline_vector<T, MaxElems, MaxRanges>::fits(size_type length) const noexcept
+{
+    return this->d_numRanges < MaxRanges && length <= MaxElems - this->d_size;
+}
+
+template <typename T, std::size_t MaxElems, std::size_t MaxRanges>
+template <typename Other>
+inline void static_inline_vector<T, MaxElems, MaxRanges>::construct_from(Other&& other) noexcept
+{
+    assert(this->empty());
+
+    T* begin = this->data();
+    T* otherBegin = const_cast<T*>(other.data());
+    if constexpr (std::is_rvalue_reference_v<Other&&>)
+    {
+        std::uninitialized_move(otherBegin, otherBegin + other.d_size, begin);
+    }
+    else
+    {
+        std::uninitialized_copy(otherBegin, otherBegin + other.d_size, begin);
+    }
+
+    std::transform(other.d_blocks, other.d_blocks + other.d_numRanges, this->d_blocks,
+        [begin, otherBegin](Block block) noexcept {
+            return Block{begin + (block.data() - otherBegin), block.length()};
+        });
+    this->d_size = other.d_size;
+    this->d_numRanges = other.d_numRanges;
+}
+
+} // close namespace tr::data_structures
+
+#endif // STATIC_INLINE_VECTOR_HPP
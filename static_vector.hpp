@@ -3,18 +3,98 @@
 
 #include <utility.hpp>
 
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
 #include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
 #include <type_traits>
 #include <utility>
 
 namespace tr::data_structures {
 
+template <typename T, std::size_t N, bool = std::is_trivial_v<T>>
+class StaticVectorStorage {
+    // The storage of a `static_vector` of non-trivial `T`: raw memory
+    // for `N` objects, of which the first `d_size` are alive.
+
+protected: // Construction
+    StaticVectorStorage() noexcept;
+    StaticVectorStorage(const StaticVectorStorage& other)
+        noexcept(std::is_nothrow_copy_constructible_v<T>);
+    StaticVectorStorage(StaticVectorStorage&& other)
+        noexcept(std::is_nothrow_move_constructible_v<T>);
+    ~StaticVectorStorage();
+
+protected: // Assignment
+    StaticVectorStorage& operator=(const StaticVectorStorage& other)
+        noexcept(std::is_nothrow_copy_constructible_v<T> &&
+            std::is_nothrow_copy_assignable_v<T>);
+    StaticVectorStorage& operator=(StaticVectorStorage&& other)
+        noexcept(std::is_nothrow_move_constructible_v<T> &&
+            std::is_nothrow_move_assignable_v<T>);
+
+protected: // Helpers
+    [[nodiscard]] T* elements() noexcept;
+    [[nodiscard]] const T* elements() const noexcept;
+
+    // Make the contents equal to `[first, first + count)`, reusing
+    // the elements which are already alive.
+    template <typename InputIt>
+    void assign_elements(InputIt first, std::size_t count);
+
+protected: // Members
+    alignas(T) std::byte    d_storage[sizeof(T) * N];
+    smallest_unsigned_t<N>  d_size;
+};
+
+template <typename T, std::size_t N>
+class StaticVectorStorage<T, N, true> {
+    // The storage of a `static_vector` of trivial `T`: a plain array,
+    // so copies, moves and destruction are trivial and the whole
+    // container can be used in constant expressions. Before C++20
+    // the array has to be initialized for the latter.
+
+protected: // Construction
+    constexpr StaticVectorStorage() noexcept;
+
+protected: // Helpers
+    [[nodiscard]] constexpr T* elements() noexcept;
+    [[nodiscard]] constexpr const T* elements() const noexcept;
+
+protected: // Members
+    T                       d_storage[N];
+    smallest_unsigned_t<N>  d_size;
+};
+
 template <typename T, std::size_t N>
-class static_vector {
+class static_vector : private StaticVectorStorage<T, N> {
     // A container implementation that has a compile-time
     // maximum capacity like std::array or a C array.
-    // But has uninitialized storage unlike std::array or C-arrays,
-    // does not require that `T` is default-constructible.
+    // But does not require that `T` is default-constructible, and
+    // for non-trivial `T` leaves the unused storage uninitialized.
+    //
+    // If `T` is trivial then so is copying, moving and destroying a
+    // `static_vector<T, N>`, which may then be `memcpy`ed or placed in
+    // shared memory, and everything but inserting a range of iterators
+    // (which has to roll back on exceptions) is `constexpr`. The price
+    // is that, to be usable in constant expressions before C++20, its
+    // storage is zero-initialized on every construction, which is O(N)
+    // in the capacity rather than in the number of elements.
+    // Like `reserve`, the modifiers which would grow it beyond `N`
+    // elements throw `std::bad_alloc` and leave it unchanged, while
+    // constructing or assigning more than `N` elements is a
+    // precondition violation.
+
+    static_assert(N > 0u);
+
+private: // Private Types
+    using Storage = StaticVectorStorage<T, N>;
+
+    static constexpr bool TRIVIAL = std::is_trivial_v<T>;
 
 public: // Types
     using value_type = T;
@@ -26,61 +106,884 @@ public: // Types
     using iterator = T*;
     using const_iterator = const T*;
     using reverse_iterator = std::reverse_iterator<iterator>;
-    using const_reverse_iterator = std::reverse_iterator<const iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
 
 public: // Construction
     constexpr static_vector() noexcept;
+    constexpr static_vector(size_type count, const T& value)
+        noexcept(std::is_nothrow_copy_constructible_v<T>);
+    template <typename InputIt, typename = std::enable_if_t<at_least_input_iterator_v<InputIt>>>
+    constexpr static_vector(InputIt first, InputIt last);
+    constexpr static_vector(std::initializer_list<T> ilist)
+        noexcept(std::is_nothrow_copy_constructible_v<T>);
     template <std::size_t M, typename = std::enable_if_t<(M <= N)>>
-    static_vector(const static_vector<T, M>& other) 
+    constexpr static_vector(const static_vector<T, M>& other)
         noexcept(std::is_nothrow_copy_constructible_v<T>);
     template <std::size_t M, typename = std::enable_if_t<(M <= N)>>
-    static_vector(static_vector<T, M>&& other)
+    constexpr static_vector(static_vector<T, M>&& other)
         noexcept(std::is_nothrow_move_constructible_v<T>);
-    ~static_vector();
 
 public: // Assignment
     template <std::size_t M, typename = std::enable_if_t<(M <= N)>>
-    static_vector& operator=(static_vector<T, M>& other) 
+    constexpr static_vector& operator=(const static_vector<T, M>& other)
         noexcept(std::is_nothrow_copy_constructible_v<T> &&
             std::is_nothrow_copy_assignable_v<T>);
 
     template <std::size_t M, typename = std::enable_if_t<(M <= N)>>
-    static_vector& operator=(static_vector<T, M>&& other)
+    constexpr static_vector& operator=(static_vector<T, M>&& other)
         noexcept(std::is_nothrow_move_constructible_v<T> &&
-            std::is_nothrow_move_assignable_v<T>);  
+            std::is_nothrow_move_assignable_v<T>);
 
-    void assign(size_type count, const T& value)
+    constexpr void assign(size_type count, const T& value)
+        noexcept(std::is_nothrow_copy_constructible_v<T> &&
+            std::is_nothrow_copy_assignable_v<T>);
+
+    template <typename InputIt, typename = std::enable_if_t<at_least_input_iterator_v<InputIt>>>
+    constexpr void assign(InputIt first, InputIt last);
+
+    constexpr void assign(std::initializer_list<T> ilist)
         noexcept(std::is_nothrow_copy_constructible_v<T> &&
             std::is_nothrow_copy_assignable_v<T>);
-    
-    template <typename InputIt, typename = at_least_input_iterator_v<InputIt>
-    void assign(InputIt first, InputIt last)
-        noexcept(std::is_nothrow_constructible_v<T, 
-            typename std::iterator_traits<InputIt>::value_type> && 
-            std::is_nothrow_assignable_v<T, typename std::iterator_traits<InputIt>::value_type);
-
-    void assign(std::initializer_list<T> ilist)
-        noexcept(std::is_nothrow_move_constructible_v<T> &&
-            std::is_nothrow_move_assignable_v<T>)
 
 public: // Capacity
     [[nodiscard]] constexpr bool empty() const noexcept;
+    [[nodiscard]] constexpr bool full() const noexcept;
     [[nodiscard]] constexpr size_type size() const noexcept;
     [[nodiscard]] constexpr size_type max_size() const noexcept;
+    [[nodiscard]] constexpr size_type capacity() const noexcept;
+
+    // Like `std::inplace_vector`, this only checks that `new_cap`
+    // elements would fit, throwing `std::bad_alloc` otherwise.
+    constexpr void reserve(size_type new_cap);
+    // This does nothing, as the capacity can never change.
+    constexpr void shrink_to_fit() noexcept;
+
+    // This returns how much of the object is taken up by the elements
+    // and by unused capacity. There is no metadata beyond the size.
+    [[nodiscard]] constexpr MemoryUsage memory_usage() const noexcept;
 
 public: // Accessors
-    [[nodiscard]] reference operator[](size_type index) noexcept;
-    [[nodiscard]] const_reference operator[](size_type index) const noexcept;
+    [[nodiscard]] constexpr reference operator[](size_type index) noexcept;
+    [[nodiscard]] constexpr const_reference operator[](size_type index) const noexcept;
+
+    [[nodiscard]] constexpr reference at(size_type index);
+    [[nodiscard]] constexpr const_reference at(size_type index) const;
+
+    [[nodiscard]] constexpr reference front() noexcept;
+    [[nodiscard]] constexpr const_reference front() const noexcept;
+
+    [[nodiscard]] constexpr reference back() noexcept;
+    [[nodiscard]] constexpr const_reference back() const noexcept;
+
+    [[nodiscard]] constexpr pointer data() noexcept;
+    [[nodiscard]] constexpr const_pointer data() const noexcept;
+
+public: // Iterators
+    [[nodiscard]] constexpr iterator begin() noexcept;
+    [[nodiscard]] constexpr const_iterator begin() const noexcept;
+    [[nodiscard]] constexpr const_iterator cbegin() const noexcept;
+
+    [[nodiscard]] constexpr iterator end() noexcept;
+    [[nodiscard]] constexpr const_iterator end() const noexcept;
+    [[nodiscard]] constexpr const_iterator cend() const noexcept;
+
+    [[nodiscard]] constexpr reverse_iterator rbegin() noexcept;
+    [[nodiscard]] constexpr const_reverse_iterator rbegin() const noexcept;
+    [[nodiscard]] constexpr const_reverse_iterator crbegin() const noexcept;
+
+    [[nodiscard]] constexpr reverse_iterator rend() noexcept;
+    [[nodiscard]] constexpr const_reverse_iterator rend() const noexcept;
+    [[nodiscard]] constexpr const_reverse_iterator crend() const noexcept;
+
+public: // Modifiers
+    constexpr void clear() noexcept;
+
+    constexpr void push_back(const T& value);
+    constexpr void push_back(T&& value);
+
+    template <typename... Args>
+    constexpr reference emplace_back(Args&&... args);
+
+    constexpr void pop_back() noexcept;
+
+    constexpr iterator insert(const_iterator pos, const T& value);
+    constexpr iterator insert(const_iterator pos, T&& value);
+    constexpr iterator insert(const_iterator pos, size_type count, const T& value);
+    template <typename InputIt, typename = std::enable_if_t<at_least_input_iterator_v<InputIt>>>
+    iterator insert(const_iterator pos, InputIt first, InputIt last);
+    iterator insert(const_iterator pos, std::initializer_list<T> ilist);
+
+    template <typename... Args>
+    constexpr iterator emplace(const_iterator pos, Args&&... args);
+
+    constexpr iterator erase(const_iterator pos);
+    constexpr iterator erase(const_iterator first, const_iterator last);
+
+    constexpr void resize(size_type count);
+    constexpr void resize(size_type count, const T& value);
+
+    constexpr void swap(static_vector& other)
+        noexcept(std::is_nothrow_move_constructible_v<T> &&
+            std::is_nothrow_swappable_v<T>);
+
+private: // Helpers
+    // Throw `std::bad_alloc` unless `count` more elements would fit.
+    constexpr void check_room(size_type count) const;
+
+    template <typename... Args>
+    constexpr void construct_back(Args&&... args)
+        noexcept(std::is_nothrow_constructible_v<T, Args...>);
 
-private: // Members
-    size_type                                       d_size;
-    std::aligned_storage_t<sizeof(T), alignof(T)>   d_storage[N];
+    constexpr void destroy_back() noexcept;
+
+    // Move the elements in `[first, d_size)` into `first` onwards,
+    // such that what was at `middle` is at `first` afterwards.
+    constexpr void rotate_to_back(size_type first, size_type middle);
 };
 
 // =================================================================
 // INLINE DEFINITIONS
 // =================================================================
+// Comparison
+template <typename T, std::size_t N, std::size_t M>
+inline bool operator==(const static_vector<T, N>& lhs, const static_vector<T, M>& rhs)
+{
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <typename T, std::size_t N, std::size_t M>
+inline bool operator!=(const static_vector<T, N>& lhs, const static_vector<T, M>& rhs)
+{
+    return !(lhs == rhs);
+}
+
+template <typename T, std::size_t N, std::size_t M>
+inline bool operator<(const static_vector<T, N>& lhs, const static_vector<T, M>& rhs)
+{
+    return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <typename T, std::size_t N>
+inline constexpr void swap(static_vector<T, N>& lhs, static_vector<T, N>& rhs)
+    noexcept(noexcept(lhs.swap(rhs)))
+{
+    lhs.swap(rhs);
+}
+
+// StaticVectorStorage
+template <typename T, std::size_t N, bool Trivial>
+inline StaticVectorStorage<T, N, Trivial>::StaticVectorStorage() noexcept
+    : d_size(0u)
+{}
+
+template <typename T, std::size_t N, bool Trivial>
+inline StaticVectorStorage<T, N, Trivial>::StaticVectorStorage(
+    const StaticVectorStorage& other)
+    noexcept(std::is_nothrow_copy_constructible_v<T>)
+    : d_size(0u)
+{
+    std::uninitialized_copy(other.elements(), other.elements() + other.d_size, this->elements());
+    this->d_size = other.d_size;
+}
+
+template <typename T, std::size_t N, bool Trivial>
+inline StaticVectorStorage<T, N, Trivial>::StaticVectorStorage(StaticVectorStorage&& other)
+    noexcept(std::is_nothrow_move_constructible_v<T>)
+    : d_size(0u)
+{
+    std::uninitialized_move(other.elements(), other.elements() + other.d_size, this->elements());
+    this->d_size = other.d_size;
+}
+
+template <typename T, std::size_t N, bool Trivial>
+inline StaticVectorStorage<T, N, Trivial>::~StaticVectorStorage()
+{
+    std::destroy(this->elements(), this->elements() + this->d_size);
+}
+
+template <typename T, std::size_t N, bool Trivial>
+inline StaticVectorStorage<T, N, Trivial>& StaticVectorStorage<T, N, Trivial>::operator=(
+    const StaticVectorStorage& other)
+    noexcept(std::is_nothrow_copy_constructible_v<T> &&
+        std::is_nothrow_copy_assignable_v<T>)
+{
+    if (this != &other)
+    {
+        this->assign_elements(other.elements(), other.d_size);
+    }
+    return *this;
+}
+
+template <typename T, std::size_t N, bool Trivial>
+inline StaticVectorStorage<T, N, Trivial>& StaticVectorStorage<T, N, Trivial>::operator=(
+    StaticVectorStorage&& other)
+    noexcept(std::is_nothrow_move_constructible_v<T> &&
+        std::is_nothrow_move_assignable_v<T>)
+{
+    if (this != &other)
+    {
+        this->assign_elements(std::make_move_iterator(other.elements()), other.d_size);
+    }
+    return *this;
+}
+
+template <typename T, std::size_t N, bool Trivial>
+inline T* StaticVectorStorage<T, N, Trivial>::elements() noexcept
+{
+    return std::launder(reinterpret_cast<T*>(this->d_storage));
+}
+
+template <typename T, std::size_t N, bool Trivial>
+inline const T* StaticVectorStorage<T, N, Trivial>::elements() const noexcept
+{
+    return std::launder(reinterpret_cast<const T*>(this->d_storage));
+}
+
+template <typename T, std::size_t N, bool Trivial>
+template <typename InputIt>
+inline void StaticVectorStorage<T, N, Trivial>::assign_elements(InputIt first,
+    std::size_t count)
+{
+    assert(count <= N);
+
+    T* elements = this->elements();
+    const std::size_t numAssigned = std::min<std::size_t>(count, this->d_size);
+    first = std::copy_n(first, numAssigned, elements);
+
+    if (count > this->d_size)
+    {
+        std::uninitialized_copy_n(first, count - this->d_size, elements + this->d_size);
+    }
+    else
+    {
+        std::destroy(elements + count, elements + this->d_size);
+    }
+    this->d_size = static_cast<smallest_unsigned_t<N>>(count);
+}
+
+template <typename T, std::size_t N>
+inline constexpr StaticVectorStorage<T, N, true>::StaticVectorStorage() noexcept
+    : d_storage{}
+    , d_size(0u)
+{}
+
+template <typename T, std::size_t N>
+inline constexpr T* StaticVectorStorage<T, N, true>::elements() noexcept
+{
+    return this->d_storage;
+}
+
+template <typename T, std::size_t N>
+inline constexpr const T* StaticVectorStorage<T, N, true>::elements() const noexcept
+{
+    return this->d_storage;
+}
+
+// Construction
+template <typename T, std::size_t N>
+inline constexpr static_vector<T, N>::static_vector() noexcept
+    : Storage()
+{}
+
+template <typename T, std::size_t N>
+inline constexpr static_vector<T, N>::static_vector(size_type count, const T& value)
+    noexcept(std::is_nothrow_copy_constructible_v<T>)
+    : static_vector()
+{
+    assert(count <= N);
+    while (count--)
+    {
+        this->construct_back(value);
+    }
+}
+
+template <typename T, std::size_t N>
+template <typename InputIt, typename>
+inline constexpr static_vector<T, N>::static_vector(InputIt first, InputIt last)
+    : static_vector()
+{
+    for (; first != last; ++first)
+    {
+        this->construct_back(*first);
+    }
+}
+
+template <typename T, std::size_t N>
+inline constexpr static_vector<T, N>::static_vector(std::initializer_list<T> ilist)
+    noexcept(std::is_nothrow_copy_constructible_v<T>)
+    : static_vector()
+{
+    assert(ilist.size() <= N);
+    for (const T& value : ilist)
+    {
+        this->construct_back(value);
+    }
+}
+
+template <typename T, std::size_t N>
+template <std::size_t M, typename>
+inline constexpr static_vector<T, N>::static_vector(const static_vector<T, M>& other)
+    noexcept(std::is_nothrow_copy_constructible_v<T>)
+    : static_vector()
+{
+    for (const T& value : other)
+    {
+        this->construct_back(value);
+    }
+}
+
+template <typename T, std::size_t N>
+template <std::size_t M, typename>
+inline constexpr static_vector<T, N>::static_vector(static_vector<T, M>&& other)
+    noexcept(std::is_nothrow_move_constructible_v<T>)
+    : static_vector()
+{
+    for (T& value : other)
+    {
+        this->construct_back(std::move(value));
+    }
+}
+
+// Assignment
+template <typename T, std::size_t N>
+template <std::size_t M, typename>
+inline constexpr static_vector<T, N>& static_vector<T, N>::operator=(
+    const static_vector<T, M>& other)
+    noexcept(std::is_nothrow_copy_constructible_v<T> &&
+        std::is_nothrow_copy_assignable_v<T>)
+{
+    if constexpr (M == N)
+    {
+        if (this == &other) return *this;
+    }
+
+    this->clear();
+    for (const T& value : other)
+    {
+        this->construct_back(value);
+    }
+    return *this;
+}
+
+template <typename T, std::size_t N>
+template <std::size_t M, typename>
+inline constexpr static_vector<T, N>& static_vector<T, N>::operator=(
+    static_vector<T, M>&& other)
+    noexcept(std::is_nothrow_move_constructible_v<T> &&
+        std::is_nothrow_move_assignable_v<T>)
+{
+    if constexpr (M == N)
+    {
+        if (this == &other) return *this;
+    }
+
+    this->clear();
+    for (T& value : other)
+    {
+        this->construct_back(std::move(value));
+    }
+    return *this;
+}
+
+template <typename T, std::size_t N>
+inline constexpr void static_vector<T, N>::assign(size_type count, const T& value)
+    noexcept(std::is_nothrow_copy_constructible_v<T> &&
+        std::is_nothrow_copy_assignable_v<T>)
+{
+    assert(count <= N);
+    this->clear();
+    while (count--)
+    {
+        this->construct_back(value);
+    }
+}
+
+template <typename T, std::size_t N>
+template <typename InputIt, typename>
+inline constexpr void static_vector<T, N>::assign(InputIt first, InputIt last)
+{
+    this->clear();
+    for (; first != last; ++first)
+    {
+        this->construct_back(*first);
+    }
+}
+
+template <typename T, std::size_t N>
+inline constexpr void static_vector<T, N>::assign(std::initializer_list<T> ilist)
+    noexcept(std::is_nothrow_copy_constructible_v<T> &&
+        std::is_nothrow_copy_assignable_v<T>)
+{
+    assert(ilist.size() <= N);
+    this->clear();
+    for (const T& value : ilist)
+    {
+        this->construct_back(value);
+    }
+}
+
+// Capacity
+template <typename T, std::size_t N>
+inline constexpr bool static_vector<T, N>::empty() const noexcept
+{
+    return (this->d_size == 0u);
+}
+
+template <typename T, std::size_t N>
+inline constexpr bool static_vector<T, N>::full() const noexcept
+{
+    return (this->d_size == N);
+}
+
+template <typename T, std::size_t N>
+inline constexpr typename static_vector<T, N>::size_type static_vector<T, N>::size()
+    const noexcept
+{
+    return this->d_size;
+}
+
+template <typename T, std::size_t N>
+inline constexpr typename static_vector<T, N>::size_type static_vector<T, N>::max_size()
+    const noexcept
+{
+    return N;
+}
+
+template <typename T, std::size_t N>
+inline constexpr typename static_vector<T, N>::size_type static_vector<T, N>::capacity()
+    const noexcept
+{
+    return N;
+}
+
+template <typename T, std::size_t N>
+inline constexpr void static_vector<T, N>::reserve(size_type new_cap)
+{
+    if (new_cap > N) { throw std::bad_alloc{}; }
+}
+
+template <typename T, std::size_t N>
+inline constexpr void static_vector<T, N>::shrink_to_fit() noexcept
+{}
+
+template <typename T, std::size_t N>
+inline constexpr MemoryUsage static_vector<T, N>::memory_usage() const noexcept
+{
+    return {
+        sizeof(T) * this->d_size,
+        sizeof(T) * (N - this->d_size),
+        0u,
+        0u
+    };
+}
+
+// Accessors
+template <typename T, std::size_t N>
+inline constexpr typename static_vector<T, N>::reference
+    static_vector<T, N>::operator[](size_type index) noexcept
+{
+    assert(index < this->d_size);
+    return this->elements()[index];
+}
+
+template <typename T, std::size_t N>
+inline constexpr typename static_vector<T, N>::const_reference
+    static_vector<T, N>::operator[](size_type index) const noexcept
+{
+    assert(index < this->d_size);
+    return this->elements()[index];
+}
+
+template <typename T, std::size_t N>
+inline constexpr typename static_vector<T, N>::reference static_vector<T, N>::at(size_type index)
+{
+    if (index >= this->d_size) { throw std::out_of_range{"Index out of range"}; }
+    return this->elements()[index];
+}
+
+template <typename T, std::size_t N>
+inline constexpr typename static_vector<T, N>::const_reference
+    static_vector<T, N>::at(size_type index) const
+{
+    if (index >= this->d_size) { throw std::out_of_range{"Index out of range"}; }
+    return this->elements()[index];
+}
+
+template <typename T, std::size_t N>
+inline constexpr typename static_vector<T, N>::reference static_vector<T, N>::front() noexcept
+{
+    return this->operator[](0u);
+}
+
+template <typename T, std::size_t N>
+inline constexpr typename static_vector<T, N>::const_reference static_vector<T, N>::front()
+    const noexcept
+{
+    return this->operator[](0u);
+}
+
+template <typename T, std::size_t N>
+inline constexpr typename static_vector<T, N>::reference static_vector<T, N>::back() noexcept
+{
+    return this->operator[](this->d_size - 1u);
+}
+
+template <typename T, std::size_t N>
+inline constexpr typename static_vector<T, N>::const_reference static_vector<T, N>::back()
+    const noexcept
+{
+    return this->operator[](this->d_size - 1u);
+}
+
+template <typename T, std::size_t N>
+inline constexpr typename static_vector<T, N>::pointer static_vector<T, N>::data() noexcept
+{
+    return this->elements();
+}
+
+template <typename T, std::size_t N>
+inline constexpr typename static_vector<T, N>::const_pointer static_vector<T, N>::data()
+    const noexcept
+{
+    return this->elements();
+}
+
+// Iterators
+template <typename T, std::size_t N>
+inline constexpr typename static_vector<T, N>::iterator static_vector<T, N>::begin() noexcept
+{
+    return this->elements();
+}
+
+template <typename T, std::size_t N>
+inline constexpr typename static_vector<T, N>::const_iterator static_vector<T, N>::begin()
+    const noexcept
+{
+    return this->cbegin();
+}
+
+template <typename T, std::size_t N>
+inline constexpr typename static_vector<T, N>::const_iterator static_vector<T, N>::cbegin()
+    const noexcept
+{
+    return this->elements();
+}
+
+template <typename T, std::size_t N>
+inline constexpr typename static_vector<T, N>::iterator static_vector<T, N>::end() noexcept
+{
+    return this->elements() + this->d_size;
+}
+
+template <typename T, std::size_t N>
+inline constexpr typename static_vector<T, N>::const_iterator static_vector<T, N>::end()
+    const noexcept
+{
+    return this->cend();
+}
+
+template <typename T, std::size_t N>
+inline constexpr typename static_vector<T, N>::const_iterator static_vector<T, N>::cend()
+    const noexcept
+{
+    return this->elements() + this->d_size;
+}
+
+template <typename T, std::size_t N>
+inline constexpr typename static_vector<T, N>::reverse_iterator static_vector<T, N>::rbegin()
+    noexcept
+{
+    return reverse_iterator{this->end()};
+}
+
+template <typename T, std::size_t N>
+inline constexpr typename static_vector<T, N>::const_reverse_iterator
+    static_vector<T, N>::rbegin() const noexcept
+{
+    return this->crbegin();
+}
+
+template <typename T, std::size_t N>
+inline constexpr typename static_vector<T, N>::const_reverse_iterator
+    static_vector<T, N>::crbegin() const noexcept
+{
+    return const_reverse_iterator{this->cend()};
+}
+
+template <typename T, std::size_t N>
+inline constexpr typename static_vector<T, N>::reverse_iterator static_vector<T, N>::rend()
+    noexcept
+{
+    return reverse_iterator{this->begin()};
+}
+
+template <typename T, std::size_t N>
+inline constexpr typename static_vector<T, N>::const_reverse_iterator
+    static_vector<T, N>::rend() const noexcept
+{
+    return this->crend();
+}
+
+template <typename T, std::size_t N>
+inline constexpr typename static_vector<T, N>::const_reverse_iterator
+    static_vector<T, N>::crend() const noexcept
+{
+    return const_reverse_iterator{this->cbegin()};
+}
+
+// Modifiers
+template <typename T, std::size_t N>
+inline constexpr void static_vector<T, N>::clear() noexcept
+{
+    while (this->d_size > 0u)
+    {
+        this->destroy_back();
+    }
+}
+
+template <typename T, std::size_t N>
+inline constexpr void static_vector<T, N>::push_back(const T& value)
+{
+    this->check_room(1u);
+    this->construct_back(value);
+}
+
+template <typename T, std::size_t N>
+inline constexpr void static_vector<T, N>::push_back(T&& value)
+{
+    this->check_room(1u);
+    this->construct_back(std::move(value));
+}
+
+template <typename T, std::size_t N>
+template <typename... Args>
+inline constexpr typename static_vector<T, N>::reference
+    static_vector<T, N>::emplace_back(Args&&... args)
+{
+    this->check_room(1u);
+    this->construct_back(std::forward<Args>(args)...);
+    return this->back();
+}
+
+template <typename T, std::size_t N>
+inline constexpr void static_vector<T, N>::pop_back() noexcept
+{
+    assert(!this->empty());
+    this->destroy_back();
+}
+
+template <typename T, std::size_t N>
+inline constexpr typename static_vector<T, N>::iterator static_vector<T, N>::insert(
+    const_iterator pos, const T& value)
+{
+    return this->emplace(pos, value);
+}
+
+template <typename T, std::size_t N>
+inline constexpr typename static_vector<T, N>::iterator static_vector<T, N>::insert(
+    const_iterator pos, T&& value)
+{
+    return this->emplace(pos, std::move(value));
+}
+
+template <typename T, std::size_t N>
+inline constexpr typename static_vector<T, N>::iterator static_vector<T, N>::insert(
+    const_iterator pos, size_type count, const T& value)
+{
+    this->check_room(count);
+    const auto index = static_cast<size_type>(pos - this->cbegin());
+    const size_type oldSize = this->d_size;
+
+    for (size_type i = 0u; i < count; ++i)
+    {
+        this->construct_back(value);
+    }
+    this->rotate_to_back(index, oldSize);
+    return this->begin() + index;
+}
+
+template <typename T, std::size_t N>
+template <typename InputIt, typename>
+inline typename static_vector<T, N>::iterator static_vector<T, N>::insert(
+    const_iterator pos, InputIt first, InputIt last)
+{
+    const auto index = static_cast<size_type>(pos - this->cbegin());
+    const size_type oldSize = this->d_size;
+
+    try {
+        for (; first != last; ++first)
+        {
+            this->check_room(1u);
+            this->construct_back(*first);
+        }
+    }
+    catch (...)
+    {
+        while (this->d_size > oldSize)
+        {
+            this->destroy_back();
+        }
+        throw;
+    }
+
+    this->rotate_to_back(index, oldSize);
+    return this->begin() + index;
+}
+
+template <typename T, std::size_t N>
+inline typename static_vector<T, N>::iterator static_vector<T, N>::insert(
+    const_iterator pos, std::initializer_list<T> ilist)
+{
+    return this->insert(pos, ilist.begin(), ilist.end());
+}
+
+template <typename T, std::size_t N>
+template <typename... Args>
+inline constexpr typename static_vector<T, N>::iterator static_vector<T, N>::emplace(
+    const_iterator pos, Args&&... args)
+{
+    const auto index = static_cast<size_type>(pos - this->cbegin());
+    this->check_room(1u);
+    this->construct_back(std::forward<Args>(args)...);
+    this->rotate_to_back(index, this->d_size - 1u);
+    return this->begin() + index;
+}
+
+template <typename T, std::size_t N>
+inline constexpr typename static_vector<T, N>::iterator static_vector<T, N>::erase(
+    const_iterator pos)
+{
+    return this->erase(pos, pos + 1);
+}
+
+template <typename T, std::size_t N>
+inline constexpr typename static_vector<T, N>::iterator static_vector<T, N>::erase(
+    const_iterator first, const_iterator last)
+{
+    const auto index = static_cast<size_type>(first - this->cbegin());
+    const auto count = static_cast<size_type>(last - first);
+
+    T* elements = this->elements();
+    for (size_type i = index; i + count < this->d_size; ++i)
+    {
+        elements[i] = std::move(elements[i + count]);
+    }
+    for (size_type i = 0u; i < count; ++i)
+    {
+        this->destroy_back();
+    }
+    return this->begin() + index;
+}
+
+template <typename T, std::size_t N>
+inline constexpr void static_vector<T, N>::resize(size_type count)
+{
+    if (count > N) { throw std::bad_alloc{}; }
+    while (this->d_size > count)
+    {
+        this->destroy_back();
+    }
+    while (this->d_size < count)
+    {
+        this->construct_back();
+    }
+}
+
+template <typename T, std::size_t N>
+inline constexpr void static_vector<T, N>::resize(size_type count, const T& value)
+{
+    if (count > N) { throw std::bad_alloc{}; }
+    while (this->d_size > count)
+    {
+        this->destroy_back();
+    }
+    while (this->d_size < count)
+    {
+        this->construct_back(value);
+    }
+}
+
+template <typename T, std::size_t N>
+inline constexpr void static_vector<T, N>::swap(static_vector& other)
+    noexcept(std::is_nothrow_move_constructible_v<T> &&
+        std::is_nothrow_swappable_v<T>)
+{
+    static_vector& longer = (this->d_size < other.d_size) ? other : *this;
+    static_vector& shorter = (this->d_size < other.d_size) ? *this : other;
+    const size_type common = shorter.d_size;
+
+    for (size_type i = 0u; i < common; ++i)
+    {
+        using std::swap;
+        swap(longer[i], shorter[i]);
+    }
+    for (size_type i = common; i < longer.d_size; ++i)
+    {
+        shorter.construct_back(std::move(longer[i]));
+    }
+    while (longer.d_size > common)
+    {
+        longer.destroy_back();
+    }
+}
+
+// Helpers
+template <typename T, std::size_t N>
+inline constexpr void static_vector<T, N>::check_room(size_type count) const
+{
+    if (count > N - this->d_size) { throw std::bad_alloc{}; }
+}
+
+template <typename T, std::size_t N>
+template <typename... Args>
+inline constexpr void static_vector<T, N>::construct_back(Args&&... args)
+    noexcept(std::is_nothrow_constructible_v<T, Args...>)
+{
+    assert(this->d_size < N);
+    if constexpr (TRIVIAL)
+    {
+        this->elements()[this->d_size] = T(std::forward<Args>(args)...);
+    }
+    else
+    {
+        ::new (static_cast<void*>(this->elements() + this->d_size))
+            T(std::forward<Args>(args)...);
+    }
+    ++this->d_size;
+}
+
+template <typename T, std::size_t N>
+inline constexpr void static_vector<T, N>::destroy_back() noexcept
+{
+    --this->d_size;
+    if constexpr (!TRIVIAL)
+    {
+        this->elements()[this->d_size].~T();
+    }
+}
+
+template <typename T, std::size_t N>
+inline constexpr void static_vector<T, N>::rotate_to_back(size_type first, size_type middle)
+{
+    // Three reversals, so that `T` need only be swappable and
+    // this remains usable in constant expressions.
+    auto reverse = [elements = this->elements()](size_type lo, size_type hi) {
+        while (lo + 1u < hi)
+        {
+            T tmp = std::move(elements[lo]);
+            elements[lo] = std::move(elements[hi - 1u]);
+            elements[hi - 1u] = std::move(tmp);
+            ++lo, --hi;
+        }
+    };
 
+    reverse(first, middle);
+    reverse(middle, this->d_size);
+    reverse(first, this->d_size);
+}
 
 } // close namespace tr::data_structures
 
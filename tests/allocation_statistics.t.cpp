@@ -0,0 +1,140 @@
+#include <allocation_statistics.hpp>
+#include <local_buffered_resource.hpp>
+#include <local_buffered_allocator.hpp>
+#include <inline_vector.hpp>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <vector>
+
+using namespace tr;
+
+TEST(AllocationStatistics, records_live_and_peak_bytes)
+{
+    data_structures::AllocationStatistics stats;
+
+    stats.record_allocation(100u);
+    stats.record_allocation(28u);
+    stats.record_deallocation(100u);
+    stats.record_allocation(1u);
+
+    using namespace ::testing;
+    EXPECT_THAT(stats.live_bytes(), Eq(29u));
+    EXPECT_THAT(stats.peak_bytes(), Eq(128u));
+    EXPECT_THAT(stats.num_allocations(), Eq(3u));
+    EXPECT_THAT(stats.num_deallocations(), Eq(1u));
+    EXPECT_THAT(stats.size_histogram()[0], Eq(1u));
+    EXPECT_THAT(stats.size_histogram()[4], Eq(1u));
+    EXPECT_THAT(stats.size_histogram()[6], Eq(1u));
+}
+
+TEST(StatisticsAllocator, tracks_a_std_vector)
+{
+    data_structures::AllocationStatistics stats;
+    {
+        std::vector<int, data_structures::StatisticsAllocator<int>> vec{
+            data_structures::StatisticsAllocator<int>{&stats}};
+        vec.reserve(10u);
+        vec.reserve(100u);
+
+        using namespace ::testing;
+        EXPECT_THAT(stats.live_bytes(), Eq(100u * sizeof(int)));
+        EXPECT_THAT(stats.num_allocations(), Eq(2u));
+    }
+
+    using namespace ::testing;
+    EXPECT_THAT(stats.live_bytes(), Eq(0u));
+    EXPECT_THAT(stats.peak_bytes(), Eq(110u * sizeof(int)));
+}
+
+TEST(StatisticsAllocator, covers_payload_and_metadata_of_an_inline_vector)
+{
+    using Alloc = data_structures::StatisticsAllocator<int>;
+
+    constexpr std::array<int, 3u> arr = {1, 2, 3};
+
+    data_structures::AllocationStatistics stats;
+    data_structures::inline_vector<int, Alloc> vec{Alloc{&stats}};
+    for (int i = 0; i < 10; ++i)
+    {
+        vec.push_back_range(arr);
+    }
+
+    const auto usage = vec.memory_usage();
+
+    using namespace ::testing;
+    EXPECT_THAT(usage.d_payloadBytes, Eq(30u * sizeof(int)));
+    EXPECT_THAT(usage.d_metadataBytes, Eq(10u * sizeof(data_structures::span<int>)));
+    EXPECT_THAT(usage.total(), Eq(stats.live_bytes()));
+}
+
+TEST(StatisticsAllocator, forwards_try_expand)
+{
+    using Resource = data_structures::LocalBufferedResource<1024u>;
+    using Alloc = data_structures::StatisticsAllocator<int,
+        data_structures::LocalBufferedAllocator<int, Resource>>;
+
+    static_assert(data_structures::has_try_expand_v<Alloc>);
+    static_assert(!data_structures::has_try_expand_v<data_structures::StatisticsAllocator<int>>);
+
+    Resource resource;
+    data_structures::AllocationStatistics stats;
+    Alloc alloc{&stats, &resource};
+
+    int* p = alloc.allocate(4u);
+
+    using namespace ::testing;
+    ASSERT_THAT(alloc.try_expand(p, 4u, 8u), Eq(true));
+    EXPECT_THAT(stats.live_bytes(), Eq(8u * sizeof(int)));
+    EXPECT_THAT(stats.num_allocations(), Eq(1u));
+    EXPECT_THAT(stats.num_expansions(), Eq(1u));
+
+    alloc.deallocate(p, 8u);
+    EXPECT_THAT(stats.live_bytes(), Eq(0u));
+}
+
+TEST(StatisticsResource, wraps_a_local_buffered_resource)
+{
+    data_structures::LocalBufferedResource<1024u> local;
+    data_structures::StatisticsResource resource{&local};
+
+    void* p1 = resource.allocate(64u);
+    void* p2 = resource.allocate(4096u);
+
+    using namespace ::testing;
+    EXPECT_THAT(local.owns(p1), Eq(true));
+    EXPECT_THAT(local.owns(p2), Eq(false));
+    EXPECT_THAT(resource.statistics().live_bytes(), Eq(64u + 4096u));
+
+    resource.deallocate(p1, 64u);
+    resource.deallocate(p2, 4096u);
+    EXPECT_THAT(resource.statistics().live_bytes(), Eq(0u));
+    EXPECT_THAT(resource.statistics().peak_bytes(), Eq(64u + 4096u));
+}
+
+TEST(StatisticsResource, forwards_try_expand)
+{
+    using Local = data_structures::LocalBufferedResource<1024u>;
+    using Resource = data_structures::StatisticsResource<Local>;
+
+    static_assert(data_structures::has_resource_try_expand_v<Resource>);
+    static_assert(!data_structures::has_resource_try_expand_v<
+        data_structures::StatisticsResource<>>);
+
+    Local local;
+    Resource resource{&local};
+
+    // A vector growing into free space after its buffer expands
+    // in place rather than reallocating.
+    data_structures::inline_vector<int, data_structures::LocalBufferedAllocator<int, Resource>>
+        vec{&resource};
+    vec.reserve(4u);
+    vec.reserve(16u);
+
+    using namespace ::testing;
+    EXPECT_THAT(resource.statistics().num_allocations(), Eq(1u));
+    EXPECT_THAT(resource.statistics().num_expansions(), Eq(1u));
+    EXPECT_THAT(resource.statistics().live_bytes(), Eq(16u * sizeof(int)));
+    EXPECT_THAT(local.bytes_used(), Eq(16u * sizeof(int)));
+}
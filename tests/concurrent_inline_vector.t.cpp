@@ -0,0 +1,164 @@
+#include <concurrent_inline_vector.hpp>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <array>
+#include <atomic>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace tr;
+
+namespace {
+
+template <typename T>
+std::vector<std::vector<T>> collect(const data_structures::concurrent_inline_vector<T>& vec)
+{
+    std::vector<std::vector<T>> ranges;
+    vec.for_each_range([&ranges](data_structures::span<const T> range) {
+        ranges.emplace_back(range.begin(), range.end());
+    });
+    return ranges;
+}
+
+} // close anonymous namespace
+
+TEST(ConcurrentInlineVector, default_constructed_is_empty)
+{
+    data_structures::concurrent_inline_vector<int> vec;
+
+    using namespace ::testing;
+    EXPECT_THAT(vec.empty(), Eq(true));
+    EXPECT_THAT(vec.num_ranges(), Eq(0u));
+    EXPECT_THAT(collect(vec), ElementsAre());
+}
+
+TEST(ConcurrentInlineVector, ranges_are_visited_in_order)
+{
+    const std::array<std::string, 2u> arr1 = {"a string long enough to be allocated", "b"};
+    const std::array<std::string, 1u> arr2 = {"c"};
+    data_structures::concurrent_inline_vector<std::string> vec;
+
+    using namespace ::testing;
+    EXPECT_THAT(vec.push_back_range(arr1), Eq(0u));
+    EXPECT_THAT(vec.push_back_range({}), Eq(1u));
+    EXPECT_THAT(vec.push_back_range(arr2), Eq(2u));
+
+    EXPECT_THAT(vec.num_ranges(), Eq(3u));
+    EXPECT_THAT(collect(vec), ElementsAre(ElementsAreArray(arr1), ElementsAre(),
+        ElementsAreArray(arr2)));
+}
+
+TEST(ConcurrentInlineVector, ranges_never_straddle_segments)
+{
+    std::vector<int> values(300u);
+    std::iota(values.begin(), values.end(), 0);
+
+    data_structures::concurrent_inline_vector<int> vec;
+    std::vector<std::vector<int>> expected;
+    for (std::size_t length : {50u, 50u, 300u, 10u, 100u})
+    {
+        vec.push_back_range({values.data(), length});
+        expected.emplace_back(values.begin(), values.begin() + length);
+    }
+
+    using namespace ::testing;
+    EXPECT_THAT(collect(vec), ElementsAreArray(expected));
+}
+
+TEST(ConcurrentInlineVector, memory_usage_counts_unused_segment_space_as_slack)
+{
+    std::vector<int> values(50u, 7);
+    data_structures::concurrent_inline_vector<int> vec;
+
+    using namespace ::testing;
+    EXPECT_THAT(vec.memory_usage().total(), Eq(0u));
+
+    // The second range doesn't fit in the rest of the first 64-element
+    // segment, so it skips to the second, 128-element one.
+    vec.push_back_range({values.data(), values.size()});
+    vec.push_back_range({values.data(), values.size()});
+
+    const auto usage = vec.memory_usage();
+    EXPECT_THAT(usage.d_payloadBytes, Eq(sizeof(int) * 100u));
+    EXPECT_THAT(usage.d_payloadSlackBytes, Eq(sizeof(int) * (64u + 128u - 100u)));
+    EXPECT_THAT(usage.d_metadataSlackBytes, Eq(31u * usage.d_metadataBytes));
+}
+
+TEST(ConcurrentInlineVector, long_ranges_skip_to_a_segment_which_holds_them)
+{
+    std::vector<int> values(1000u, 7);
+    data_structures::concurrent_inline_vector<int> vec;
+    vec.push_back_range({values.data(), values.size()});
+
+    // The segments before the 1024-element one are never allocated.
+    using namespace ::testing;
+    EXPECT_THAT(vec.memory_usage().d_payloadSlackBytes, Eq(sizeof(int) * 24u));
+    EXPECT_THAT(collect(vec), ElementsAre(ElementsAreArray(values)));
+}
+
+TEST(ConcurrentInlineVector, concurrent_writers_and_readers)
+{
+    constexpr int NUM_WRITERS = 4;
+    constexpr int RANGES_PER_WRITER = 2000;
+
+    data_structures::concurrent_inline_vector<int> vec;
+    std::atomic<bool> done{false};
+    std::atomic<int> torn{0};
+
+    std::thread reader([&] {
+        while (!done.load())
+        {
+            vec.for_each_range([&torn](data_structures::span<const int> range) {
+                // Every range is filled with its own length.
+                for (int value : range)
+                {
+                    if (value != static_cast<int>(range.length())) ++torn;
+                }
+            });
+        }
+    });
+
+    std::vector<std::thread> writers;
+    for (int writer = 0; writer < NUM_WRITERS; ++writer)
+    {
+        writers.emplace_back([&vec, writer] {
+            for (int i = 0; i < RANGES_PER_WRITER; ++i)
+            {
+                const std::vector<int> range((writer + i) % 7, (writer + i) % 7);
+                vec.push_back_range({range.data(), range.size()});
+            }
+        });
+    }
+    for (std::thread& writer : writers)
+    {
+        writer.join();
+    }
+    done.store(true);
+    reader.join();
+
+    std::size_t numRanges = 0u;
+    std::size_t numElements = 0u;
+    vec.for_each_range([&](data_structures::span<const int> range) {
+        ++numRanges;
+        numElements += range.length();
+    });
+
+    std::size_t expectedElements = 0u;
+    for (int writer = 0; writer < NUM_WRITERS; ++writer)
+    {
+        for (int i = 0; i < RANGES_PER_WRITER; ++i)
+        {
+            expectedElements += (writer + i) % 7;
+        }
+    }
+
+    using namespace ::testing;
+    EXPECT_THAT(torn.load(), Eq(0));
+    EXPECT_THAT(vec.num_ranges(), Eq(std::size_t{NUM_WRITERS * RANGES_PER_WRITER}));
+    EXPECT_THAT(numRanges, Eq(vec.num_ranges()));
+    EXPECT_THAT(numElements, Eq(expectedElements));
+}
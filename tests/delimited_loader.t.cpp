@@ -0,0 +1,120 @@
+#include <delimited_loader.hpp>
+#include <inline_vector.hpp>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace tr;
+
+namespace {
+
+class TemporaryFile {
+public:
+    explicit TemporaryFile(const std::string& contents)
+        : d_file(std::tmpfile())
+    {
+        std::fwrite(contents.data(), 1u, contents.size(), d_file);
+        std::fflush(d_file);
+        std::rewind(d_file);
+    }
+    ~TemporaryFile() { std::fclose(d_file); }
+
+    int fd() const { return fileno(d_file); }
+
+private:
+    std::FILE* d_file;
+};
+
+std::vector<std::string> to_strings(const data_structures::inline_vector<char>& ranges)
+{
+    std::vector<std::string> strings;
+    for (const auto& range : ranges)
+    {
+        strings.emplace_back(range.begin(), range.end());
+    }
+    return strings;
+}
+
+} // close anonymous namespace
+
+TEST(DelimitedLoader, loads_one_range_per_line)
+{
+    TemporaryFile file{"first\n\nthird line\nlast without newline"};
+    data_structures::inline_vector<char> ranges;
+
+    using namespace ::testing;
+    EXPECT_THAT(data_structures::load_delimited(file.fd(), ranges), Eq(4u));
+    EXPECT_THAT(to_strings(ranges), ElementsAre("first", "", "third line",
+        "last without newline"));
+}
+
+TEST(DelimitedLoader, records_can_cross_and_outgrow_chunks)
+{
+    std::string contents;
+    std::vector<std::string> expected;
+    for (int i = 0; i < 200; ++i)
+    {
+        expected.push_back(std::string(i % 37, static_cast<char>('a' + i % 26)));
+        contents += expected.back();
+        contents += '\0';
+    }
+
+    TemporaryFile file{contents};
+    data_structures::inline_vector<char> ranges;
+    data_structures::DelimitedLoadOptions options;
+    options.d_delimiter = '\0';
+    options.d_chunkBytes = 8u;
+
+    using namespace ::testing;
+    EXPECT_THAT(data_structures::load_delimited(file.fd(), ranges, options), Eq(200u));
+    EXPECT_THAT(to_strings(ranges), ElementsAreArray(expected));
+}
+
+TEST(DelimitedLoader, batches_bound_the_container_size)
+{
+    std::string contents;
+    for (int i = 0; i < 100; ++i)
+    {
+        contents += std::to_string(i) + '\n';
+    }
+
+    TemporaryFile file{contents};
+    data_structures::inline_vector<char> ranges;
+    data_structures::DelimitedLoadOptions options;
+    options.d_chunkBytes = 16u;
+    options.d_batchBytes = 20u;
+
+    std::vector<std::string> loaded;
+    std::size_t largestBatch = 0u;
+    const std::size_t numRecords = data_structures::load_delimited_batches(file.fd(), ranges,
+        [&](const data_structures::inline_vector<char>& batch) {
+            largestBatch = std::max(largestBatch, batch.size());
+            const std::vector<std::string> strings = to_strings(batch);
+            loaded.insert(loaded.end(), strings.begin(), strings.end());
+        }, options);
+
+    std::vector<std::string> expected;
+    for (int i = 0; i < 100; ++i)
+    {
+        expected.push_back(std::to_string(i));
+    }
+
+    using namespace ::testing;
+    EXPECT_THAT(numRecords, Eq(100u));
+    EXPECT_THAT(loaded, ElementsAreArray(expected));
+    EXPECT_THAT(largestBatch, Lt(22u));
+    EXPECT_THAT(ranges.num_ranges(), Eq(0u));
+}
+
+TEST(DelimitedLoader, missing_file_throws)
+{
+    data_structures::inline_vector<char> ranges;
+
+    using namespace ::testing;
+    EXPECT_THROW(data_structures::load_delimited("/nonexistent/file", ranges),
+        std::system_error);
+}
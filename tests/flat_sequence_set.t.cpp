@@ -0,0 +1,115 @@
+#include <flat_sequence_set.hpp>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <array>
+#include <string>
+#include <vector>
+
+using namespace tr;
+
+TEST(FlatSequenceSet, default_constructed_is_empty)
+{
+    data_structures::flat_sequence_set<int> set;
+
+    using namespace ::testing;
+    EXPECT_THAT(set.empty(), Eq(true));
+    EXPECT_THAT(set.num_ranges(), Eq(0u));
+    EXPECT_THAT(set.begin(), Eq(set.end()));
+}
+
+TEST(FlatSequenceSet, inserted_ranges_are_kept_sorted)
+{
+    constexpr std::array<int, 3u> arr1 = {2, 0, 1};
+    constexpr std::array<int, 2u> arr2 = {1, 5};
+    constexpr std::array<int, 4u> arr3 = {2, 0, 1, 0};
+    constexpr std::array<int, 1u> arr4 = {-7};
+    data_structures::flat_sequence_set<int> set;
+
+    set.insert_range(arr1);
+    set.insert_range(arr2);
+    set.insert_range(arr3);
+    set.insert_range(arr4);
+
+    using namespace ::testing;
+    ASSERT_THAT(set.num_ranges(), Eq(4u));
+    EXPECT_THAT(set, ElementsAre(ElementsAre(-7), ElementsAre(1, 5), ElementsAre(2, 0, 1),
+        ElementsAre(2, 0, 1, 0)));
+}
+
+TEST(FlatSequenceSet, constructing_from_container_sorts_it)
+{
+    constexpr std::array<char, 3u> arr1 = {'c', 'a', 't'};
+    constexpr std::array<char, 3u> arr2 = {'b', 'a', 't'};
+    constexpr std::array<char, 2u> arr3 = {'a', 't'};
+    data_structures::inline_vector<char> vec;
+
+    vec.push_back_range(arr1);
+    vec.push_back_range(arr2);
+    vec.push_back_range(arr3);
+
+    data_structures::flat_sequence_set<char> set{{}, vec};
+
+    using namespace ::testing;
+    ASSERT_THAT(set.num_ranges(), Eq(3u));
+    EXPECT_THAT(set, ElementsAre(ElementsAre('a', 't'), ElementsAre('b', 'a', 't'),
+        ElementsAre('c', 'a', 't')));
+}
+
+TEST(FlatSequenceSet, find_returns_end_for_missing_ranges)
+{
+    constexpr std::array<int, 2u> arr1 = {1, 5};
+    constexpr std::array<int, 3u> arr2 = {2, 0, 1};
+    constexpr std::array<int, 2u> missing = {2, 0};
+    data_structures::flat_sequence_set<int> set;
+
+    using namespace ::testing;
+    EXPECT_THAT(set.find(arr1), Eq(set.end()));
+
+    set.insert_range(arr1);
+    set.insert_range(arr2);
+
+    EXPECT_THAT(set.find(arr1), Eq(set.begin()));
+    EXPECT_THAT(set.find(arr2), Eq(set.begin() + 1));
+    EXPECT_THAT(set.find(missing), Eq(set.end()));
+}
+
+TEST(FlatSequenceSet, find_batch_matches_find)
+{
+    data_structures::flat_sequence_set<char> set;
+    std::vector<std::string> words;
+    for (int i = 0; i < 1000; i += 3)
+    {
+        words.push_back(std::to_string(i * 7919));
+        set.insert_range({words.back().data(), words.back().size()});
+    }
+
+    std::vector<std::string> lookups;
+    for (int i = 0; i < 1000; ++i)
+    {
+        lookups.push_back(std::to_string(i * 7919));
+    }
+    lookups.push_back("");
+    lookups.push_back("~");
+
+    std::vector<data_structures::span<const char>> keys;
+    std::vector<const data_structures::span<char>*> expected;
+    for (const std::string& lookup : lookups)
+    {
+        keys.emplace_back(lookup.data(), lookup.size());
+        expected.push_back(set.find(keys.back()));
+    }
+
+    std::vector<const data_structures::span<char>*> found(keys.size());
+    set.find_batch({keys.data(), keys.size()}, {found.data(), found.size()});
+
+    using namespace ::testing;
+    EXPECT_THAT(found, ElementsAreArray(expected));
+    EXPECT_THAT(std::count(found.begin(), found.end(), set.end()), Eq(1002 - 334));
+
+    data_structures::flat_sequence_set<char> empty;
+    empty.find_batch({keys.data(), 3u}, {found.data(), 3u});
+    EXPECT_THAT(found[0u], Eq(empty.end()));
+    EXPECT_THAT(found[2u], Eq(empty.end()));
+}
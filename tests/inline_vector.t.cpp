@@ -3,6 +3,13 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
+#include <array>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+
 using namespace tr;
 
 TEST(InlineVector, default_constructed_is_empty_with_no_capacity)
@@ -133,6 +140,104 @@ TEST(InlineVector, can_move_empty_vector)
     EXPECT_THAT(vec2.capacity(), Eq(0u));
 }
 
+TEST(InlineVector, assignment_keeps_a_polymorphic_allocator)
+{
+    using Vec = data_structures::inline_vector<int, std::pmr::polymorphic_allocator<int>>;
+    constexpr std::array<int, 3u> arr1 = {-1, 0, 1};
+    constexpr std::array<int, 2u> arr2 = {10, 20};
+
+    std::pmr::unsynchronized_pool_resource resource1;
+    std::pmr::unsynchronized_pool_resource resource2;
+    Vec vec1{&resource1};
+    vec1.push_back_range(arr1);
+    Vec vec2{&resource2};
+    vec2.push_back_range(arr2);
+    vec2.push_back_range(arr1);
+
+    using namespace ::testing;
+    vec1 = vec2;
+    EXPECT_THAT(vec1.get_allocator().resource(), Eq(&resource1));
+    EXPECT_THAT(vec1, ElementsAre(ElementsAreArray(arr2), ElementsAreArray(arr1)));
+    EXPECT_THAT(vec2, ElementsAre(ElementsAreArray(arr2), ElementsAreArray(arr1)));
+
+    // Moving between different resources copies the elements...
+    vec2.push_back_range(arr2);
+    const int* moved = vec2.begin()->data();
+    vec1 = std::move(vec2);
+    EXPECT_THAT(vec1.get_allocator().resource(), Eq(&resource1));
+    EXPECT_THAT(vec1.begin()->data(), Ne(moved));
+    EXPECT_THAT(vec1, ElementsAre(ElementsAreArray(arr2), ElementsAreArray(arr1),
+        ElementsAreArray(arr2)));
+
+    // ...but moving within one steals the buffer.
+    Vec vec3{&resource1};
+    vec3.push_back_range(arr1);
+    const int* stolen = vec1.begin()->data();
+    vec3 = std::move(vec1);
+    EXPECT_THAT(vec3.begin()->data(), Eq(stolen));
+    EXPECT_THAT(vec3.num_ranges(), Eq(3u));
+    EXPECT_THAT(vec1.num_ranges(), Eq(0u));
+    EXPECT_THAT(vec1.capacity(), Eq(0u));
+}
+
+// A stateful allocator which goes along with the container it is copied from.
+template <typename T>
+struct PropagatingAllocator : std::allocator<T> {
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using is_always_equal = std::false_type;
+
+    template <typename U>
+    struct rebind { using other = PropagatingAllocator<U>; };
+
+    explicit PropagatingAllocator(int id) noexcept : d_id(id) {}
+
+    template <typename U>
+    PropagatingAllocator(const PropagatingAllocator<U>& other) noexcept : d_id(other.d_id) {}
+
+    int d_id;
+};
+
+template <typename T, typename U>
+bool operator==(const PropagatingAllocator<T>& lhs, const PropagatingAllocator<U>& rhs) noexcept
+{
+    return lhs.d_id == rhs.d_id;
+}
+
+template <typename T, typename U>
+bool operator!=(const PropagatingAllocator<T>& lhs, const PropagatingAllocator<U>& rhs) noexcept
+{
+    return !(lhs == rhs);
+}
+
+TEST(InlineVector, assignment_propagates_an_allocator_which_asks_to)
+{
+    using Vec = data_structures::inline_vector<int, PropagatingAllocator<int>>;
+    constexpr std::array<int, 3u> arr1 = {-1, 0, 1};
+    constexpr std::array<int, 2u> arr2 = {10, 20};
+
+    Vec vec1{PropagatingAllocator<int>{1}};
+    vec1.push_back_range(arr1);
+    Vec vec2{PropagatingAllocator<int>{2}};
+    vec2.push_back_range(arr2);
+
+    using namespace ::testing;
+    vec1 = vec2;
+    EXPECT_THAT(vec1.get_allocator().d_id, Eq(2));
+    EXPECT_THAT(vec1, ElementsAre(ElementsAreArray(arr2)));
+
+    Vec vec3{PropagatingAllocator<int>{3}};
+    vec3.push_back_range(arr1);
+    const int* stolen = vec2.begin()->data();
+    vec3 = std::move(vec2);
+    EXPECT_THAT(vec3.get_allocator().d_id, Eq(2));
+    EXPECT_THAT(vec3.begin()->data(), Eq(stolen));
+    EXPECT_THAT(vec3, ElementsAre(ElementsAreArray(arr2)));
+    EXPECT_THAT(vec2.num_ranges(), Eq(0u));
+    static_assert(std::is_nothrow_move_assignable_v<Vec>);
+}
+
 TEST(InlineVector, max_size_forwarded_to_allocator)
 {
     data_structures::inline_vector<int> vec;
@@ -363,6 +468,24 @@ TEST(InlineVector, insert_range_in_middle)
     EXPECT_THAT(*it, ElementsAre(-2, 2));
 }
 
+TEST(InlineVector, insert_range_longer_than_the_ranges_after_it)
+{
+    const std::array<std::string, 2u> arr1 = {"a string long enough to be allocated", "b"};
+    const std::array<std::string, 1u> arr2 = {"c"};
+    const std::array<std::string, 3u> arr3 = {"d", "another string which is allocated", "f"};
+    data_structures::inline_vector<std::string> vec;
+
+    vec.push_back_range(arr1);
+    vec.push_back_range(arr2);
+    auto it = vec.insert_range(vec.begin() + 1u, arr3);
+
+    using namespace ::testing;
+    ASSERT_THAT(vec.size(), Eq(arr1.size() + arr2.size() + arr3.size()));
+    EXPECT_THAT(vec, ElementsAre(ElementsAreArray(arr1), ElementsAreArray(arr3),
+        ElementsAreArray(arr2)));
+    EXPECT_THAT(*it, ElementsAreArray(arr3));
+}
+
 TEST(InlineVector, insert_range_at_beginning)
 {
     constexpr std::array<int, 3u> arr1 = {-1, 0, 1};
@@ -384,3 +507,392 @@ TEST(InlineVector, insert_range_at_beginning)
         ElementsAre(10, 20, 30, 40, -50), ElementsAre(10000)));
     EXPECT_THAT(*it, ElementsAre(-2, 2));
 }
+
+TEST(InlineVector, memory_usage_breaks_down_payload_metadata_and_slack)
+{
+    constexpr std::array<int, 3u> arr1 = {-1, 0, 1};
+    constexpr std::array<int, 5u> arr2 = {10, 20, 30, 40, -50};
+    data_structures::inline_vector<int> vec;
+
+    vec.push_back_range(arr1);
+    vec.push_back_range(arr2);
+    const auto usage = vec.memory_usage();
+
+    using namespace ::testing;
+    EXPECT_THAT(usage.d_payloadBytes, Eq(8u * sizeof(int)));
+    EXPECT_THAT(usage.d_payloadSlackBytes, Eq((vec.capacity() - vec.size()) * sizeof(int)));
+    EXPECT_THAT(usage.d_metadataBytes, Eq(2u * sizeof(data_structures::span<int>)));
+    EXPECT_THAT(usage.total(), Ge(usage.d_payloadBytes + usage.d_metadataBytes));
+}
+
+TEST(InlineVector, static_block_policy_keeps_blocks_inside_the_container)
+{
+    using Vec = data_structures::inline_vector<int, std::allocator<int>,
+        data_structures::StaticBlockPolicy<4u>>;
+
+    constexpr std::array<int, 3u> arr1 = {1, 2, 3};
+    constexpr std::array<int, 2u> arr2 = {4, 5};
+
+    Vec vec;
+    vec.push_back_range(arr1);
+    vec.push_back_range(arr2);
+    vec.insert_range(vec.begin(), arr2);
+
+    const auto* first = reinterpret_cast<const std::byte*>(&vec);
+    const auto* blocks = reinterpret_cast<const std::byte*>(vec.begin());
+
+    using namespace ::testing;
+    EXPECT_THAT(blocks >= first && blocks < first + sizeof(Vec), Eq(true));
+    EXPECT_THAT(vec, ElementsAre(ElementsAre(4, 5), ElementsAre(1, 2, 3), ElementsAre(4, 5)));
+    EXPECT_THAT(vec.memory_usage().d_metadataSlackBytes, Eq(sizeof(data_structures::span<int>)));
+    EXPECT_THROW(vec.reserve_ranges(5u), std::bad_alloc);
+
+    Vec moved{std::move(vec)};
+    EXPECT_THAT(vec.num_ranges(), Eq(0u));
+    EXPECT_THAT(moved, ElementsAre(ElementsAre(4, 5), ElementsAre(1, 2, 3), ElementsAre(4, 5)));
+
+    moved.erase_range(moved.begin());
+    EXPECT_THAT(moved, ElementsAre(ElementsAre(1, 2, 3), ElementsAre(4, 5)));
+}
+
+TEST(InlineVector, static_block_policy_rejects_ranges_past_its_capacity)
+{
+    using Vec = data_structures::inline_vector<int, std::allocator<int>,
+        data_structures::StaticBlockPolicy<2u>>;
+
+    constexpr std::array<int, 3u> arr1 = {1, 2, 3};
+    constexpr std::array<int, 2u> arr2 = {4, 5};
+
+    Vec vec;
+    vec.push_back_range(arr1);
+    vec.push_back_range(arr2);
+
+    using namespace ::testing;
+    EXPECT_THROW(vec.push_back_range(arr1), std::length_error);
+    EXPECT_THROW(vec.push_back_range(arr1.begin(), arr1.end()), std::length_error);
+    EXPECT_THROW(vec.insert_range(vec.begin(), arr2), std::length_error);
+    EXPECT_THAT(vec.size(), Eq(5u));
+    EXPECT_THAT(vec, ElementsAre(ElementsAre(1, 2, 3), ElementsAre(4, 5)));
+}
+
+TEST(InlineVector, growth_policy_controls_factor_step_and_rounding)
+{
+    using Capped = data_structures::GeometricGrowthPolicy<2u, 1u, 4u>;
+    using Rounded = data_structures::GeometricGrowthPolicy<3u, 2u, 0u, true>;
+
+    using namespace ::testing;
+    EXPECT_THAT(data_structures::GeometricGrowthPolicy<>::next_capacity<int>(3u, 4u), Eq(7u));
+    EXPECT_THAT(data_structures::GeometricGrowthPolicy<>::next_capacity<int>(3u, 10u), Eq(10u));
+    EXPECT_THAT(Capped::next_capacity<int>(3u, 4u), Eq(7u));
+    EXPECT_THAT(Capped::next_capacity<int>(7u, 8u), Eq(11u));
+    EXPECT_THAT(Rounded::next_capacity<int>(2u, 3u), Eq(4u));
+    EXPECT_THAT(Rounded::next_capacity<int>(1000u, 1001u), Eq(2048u));
+
+    constexpr std::array<int, 1u> arr = {1};
+    data_structures::inline_vector<int, std::allocator<int>,
+        data_structures::VectorBlockPolicy, Capped> vec;
+    std::vector<std::size_t> capacities;
+    for (int i = 0; i < 8; ++i)
+    {
+        vec.push_back_range(arr);
+        capacities.push_back(vec.capacity());
+    }
+
+    EXPECT_THAT(capacities, ElementsAre(1u, 3u, 3u, 7u, 7u, 7u, 7u, 11u));
+}
+
+TEST(InlineVector, shrink_to_fit_releases_unused_capacity)
+{
+    constexpr std::array<int, 3u> arr1 = {1, 2, 3};
+    constexpr std::array<int, 2u> arr2 = {4, 5};
+    data_structures::inline_vector<int> vec;
+    vec.reserve(100u);
+    vec.reserve_ranges(10u);
+    vec.push_back_range(arr1);
+    vec.push_back_range(arr2);
+
+    vec.shrink_to_fit();
+
+    using namespace ::testing;
+    EXPECT_THAT(vec.capacity(), Eq(5u));
+    EXPECT_THAT(vec.memory_usage().d_payloadSlackBytes, Eq(0u));
+    EXPECT_THAT(vec.memory_usage().d_metadataSlackBytes, Eq(0u));
+    EXPECT_THAT(vec, ElementsAre(ElementsAre(1, 2, 3), ElementsAre(4, 5)));
+
+    vec.clear();
+    vec.shrink_to_fit();
+    EXPECT_THAT(vec.capacity(), Eq(0u));
+    EXPECT_THAT(vec.memory_usage().total(), Eq(0u));
+
+    vec.push_back_range(arr2);
+    EXPECT_THAT(vec, ElementsAre(ElementsAre(4, 5)));
+}
+
+template <typename Vec>
+std::vector<int> flatten(const Vec& vec)
+{
+    std::vector<int> values;
+    for (const auto& range : vec)
+    {
+        values.insert(values.end(), range.begin(), range.end());
+    }
+    return values;
+}
+
+TEST(InlineVector, incremental_growth_relocates_a_few_ranges_per_push)
+{
+    using Vec = data_structures::inline_vector<int, std::allocator<int>,
+        data_structures::VectorBlockPolicy, data_structures::IncrementalGrowthPolicy<4u>>;
+
+    Vec vec;
+    vec.reserve(16u);
+    std::vector<int> expected;
+    for (int i = 0; i < 16; ++i)
+    {
+        const std::array<int, 1u> arr = {i};
+        vec.push_back_range(arr);
+        expected.push_back(i);
+    }
+    const int* last = vec[15u].data();
+
+    const std::array<int, 1u> arr = {16};
+    vec.push_back_range(arr);
+    expected.push_back(16);
+
+    using namespace ::testing;
+    EXPECT_THAT(vec.capacity(), Eq(33u));
+    EXPECT_THAT(vec[4u].data(), Ne(vec[3u].data() + 1));
+    EXPECT_THAT(vec[15u].data(), Eq(last));
+    EXPECT_THAT(vec.memory_usage().d_payloadSlackBytes, Eq(sizeof(int) * (33u + 16u - 17u)));
+    EXPECT_THAT(vec, Each(SizeIs(1u)));
+    EXPECT_THAT(flatten(vec), ElementsAreArray(expected));
+
+    for (int i = 17; i < 20; ++i)
+    {
+        const std::array<int, 1u> next = {i};
+        vec.push_back_range(next);
+        expected.push_back(i);
+    }
+
+    EXPECT_THAT(vec[15u].data(), Eq(vec[0u].data() + 15));
+    EXPECT_THAT(vec.memory_usage().d_payloadSlackBytes, Eq(sizeof(int) * (33u - 20u)));
+    EXPECT_THAT(vec, Each(SizeIs(1u)));
+    EXPECT_THAT(flatten(vec), ElementsAreArray(expected));
+}
+
+TEST(InlineVector, incremental_growth_can_be_interrupted)
+{
+    using Vec = data_structures::inline_vector<std::string, std::allocator<std::string>,
+        data_structures::VectorBlockPolicy, data_structures::IncrementalGrowthPolicy<2u>>;
+
+    const std::array<std::string, 2u> arr = {"a long string which is allocated", "b"};
+    const auto make_relocating = [&arr] {
+        Vec vec;
+        vec.reserve(8u);
+        for (int i = 0; i < 5; ++i)
+        {
+            vec.push_back_range(arr);
+        }
+        return vec;
+    };
+
+    Vec vec = make_relocating();
+    Vec copy{vec};
+    Vec moved{std::move(vec)};
+
+    using namespace ::testing;
+    EXPECT_THAT(copy, Each(ElementsAreArray(arr)));
+    EXPECT_THAT(moved, Each(ElementsAreArray(arr)));
+
+    moved.pop_back_range();
+    moved.pop_back_range();
+    moved.pop_back_range();
+    moved.pop_back_range();
+    EXPECT_THAT(moved.num_ranges(), Eq(1u));
+    EXPECT_THAT(moved.memory_usage().d_payloadSlackBytes,
+        Eq(sizeof(std::string) * (moved.capacity() - 2u)));
+
+    copy.erase_range(copy.begin());
+    EXPECT_THAT(copy.num_ranges(), Eq(4u));
+    EXPECT_THAT(copy, Each(ElementsAreArray(arr)));
+
+    Vec cleared = make_relocating();
+    cleared.clear();
+    EXPECT_THAT(cleared.memory_usage().d_payloadSlackBytes,
+        Eq(sizeof(std::string) * cleared.capacity()));
+}
+
+// Forwards to the heap until it is told to fail.
+struct FailingResource : std::pmr::memory_resource {
+    bool d_fail = false;
+
+    void* do_allocate(std::size_t numBytes, std::size_t alignment) override
+    {
+        if (this->d_fail) throw std::bad_alloc{};
+        return std::pmr::new_delete_resource()->allocate(numBytes, alignment);
+    }
+
+    void do_deallocate(void* position, std::size_t numBytes, std::size_t alignment) override
+    {
+        std::pmr::new_delete_resource()->deallocate(position, numBytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+TEST(InlineVector, incremental_growth_survives_a_failed_allocation)
+{
+    using Vec = data_structures::inline_vector<int, std::pmr::polymorphic_allocator<int>,
+        data_structures::VectorBlockPolicy, data_structures::IncrementalGrowthPolicy<2u>>;
+
+    FailingResource resource;
+    Vec vec{&resource};
+    vec.reserve(8u);
+    vec.reserve_ranges(16u);
+    std::vector<int> expected;
+    for (int i = 0; i < 8; ++i)
+    {
+        const std::array<int, 1u> arr = {i};
+        vec.push_back_range(arr);
+        expected.push_back(i);
+    }
+
+    const std::array<int, 1u> arr = {8};
+    resource.d_fail = true;
+
+    using namespace ::testing;
+    EXPECT_THROW(vec.push_back_range(arr), std::bad_alloc);
+    EXPECT_THAT(vec.capacity(), Eq(8u));
+    EXPECT_THAT(flatten(vec), ElementsAreArray(expected));
+
+    resource.d_fail = false;
+    for (int i = 8; i < 12; ++i)
+    {
+        const std::array<int, 1u> next = {i};
+        vec.push_back_range(next);
+        expected.push_back(i);
+    }
+    EXPECT_THAT(flatten(vec), ElementsAreArray(expected));
+}
+
+TEST(InlineVector, sort_ranges_lays_the_elements_out_in_order)
+{
+    const std::array<std::string, 2u> arr1 = {"b", "a string long enough to be allocated"};
+    const std::array<std::string, 1u> arr2 = {"a"};
+    const std::array<std::string, 3u> arr3 = {"c", "d", "e"};
+    data_structures::inline_vector<std::string> vec;
+    vec.push_back_range(arr1);
+    vec.push_back_range(arr2);
+    vec.push_back_range(arr3);
+    const std::size_t capacity = vec.capacity();
+
+    vec.sort_ranges([](const auto& lhs, const auto& rhs) { return lhs[0u] < rhs[0u]; });
+
+    using namespace ::testing;
+    EXPECT_THAT(vec, ElementsAre(ElementsAreArray(arr2), ElementsAreArray(arr1),
+        ElementsAreArray(arr3)));
+    EXPECT_THAT(vec[1u].data(), Eq(vec[0u].data() + 1));
+    EXPECT_THAT(vec[2u].data(), Eq(vec[1u].data() + 2));
+    EXPECT_THAT(vec.capacity(), Eq(capacity));
+    EXPECT_THAT(vec.size(), Eq(6u));
+}
+
+TEST(InlineVector, stable_sort_ranges_keeps_equal_ranges_in_order)
+{
+    data_structures::inline_vector<int> vec;
+    for (int i = 0; i < 10; ++i)
+    {
+        const std::array<int, 2u> arr = {i % 3, i};
+        vec.push_back_range(arr);
+    }
+
+    vec.stable_sort_ranges([](const auto& lhs, const auto& rhs) { return lhs[0u] < rhs[0u]; });
+
+    using namespace ::testing;
+    EXPECT_THAT(flatten(vec), ElementsAre(0, 0, 0, 3, 0, 6, 0, 9, 1, 1, 1, 4, 1, 7,
+        2, 2, 2, 5, 2, 8));
+}
+
+TEST(InlineVector, permute_ranges_gathers_by_index)
+{
+    using Vec = data_structures::inline_vector<int, std::allocator<int>,
+        data_structures::StaticBlockPolicy<4u>>;
+
+    constexpr std::array<int, 3u> arr1 = {1, 2, 3};
+    constexpr std::array<int, 1u> arr2 = {4};
+    constexpr std::array<int, 2u> arr3 = {5, 6};
+    Vec vec;
+    vec.push_back_range(arr1);
+    vec.push_back_range({});
+    vec.push_back_range(arr2);
+    vec.push_back_range(arr3);
+
+    const std::array<std::size_t, 4u> permutation = {3u, 0u, 1u, 2u};
+    vec.permute_ranges(permutation);
+
+    using namespace ::testing;
+    EXPECT_THAT(vec, ElementsAre(ElementsAreArray(arr3), ElementsAreArray(arr1), ElementsAre(),
+        ElementsAreArray(arr2)));
+    EXPECT_THAT(flatten(vec), ElementsAre(5, 6, 1, 2, 3, 4));
+
+    const std::array<std::size_t, 4u> repeated = {0u, 0u, 1u, 2u};
+    const std::array<std::size_t, 3u> tooShort = {0u, 1u, 2u};
+    EXPECT_THROW(vec.permute_ranges(repeated), std::invalid_argument);
+    EXPECT_THROW(vec.permute_ranges(tooShort), std::invalid_argument);
+    EXPECT_THAT(flatten(vec), ElementsAre(5, 6, 1, 2, 3, 4));
+}
+
+// Copies, and so relocates, normally until `s_copiesLeft` runs out.
+struct ThrowingCopy {
+    static inline int s_copiesLeft = -1;
+
+    ThrowingCopy(int value) : d_value(value) {}
+
+    ThrowingCopy(const ThrowingCopy& other) : d_value(other.d_value)
+    {
+        if (s_copiesLeft == 0) throw std::runtime_error{"copy failed"};
+        --s_copiesLeft;
+    }
+
+    ThrowingCopy& operator=(const ThrowingCopy&) = default;
+
+    int d_value;
+};
+
+TEST(InlineVector, failed_copies_leave_a_polymorphic_vector_intact)
+{
+    using Vec = data_structures::pmr::inline_vector<ThrowingCopy>;
+
+    const auto values = [](const Vec& vec) {
+        std::vector<int> result;
+        for (const auto& range : vec)
+        {
+            for (const ThrowingCopy& value : range) result.push_back(value.d_value);
+        }
+        return result;
+    };
+
+    const std::array<ThrowingCopy, 2u> arr1 = {3, 4};
+    const std::array<ThrowingCopy, 2u> arr2 = {1, 2};
+
+    Vec vec;
+    vec.push_back_range(arr1);
+    vec.push_back_range(arr2);
+
+    using namespace ::testing;
+    ThrowingCopy::s_copiesLeft = 1;
+    EXPECT_THROW(vec.push_back_range(arr2), std::runtime_error);
+    EXPECT_THAT(vec.num_ranges(), Eq(2u));
+
+    ThrowingCopy::s_copiesLeft = 3;
+    EXPECT_THROW(vec.sort_ranges([](const auto& lhs, const auto& rhs) {
+        return lhs[0].d_value < rhs[0].d_value;
+    }), std::runtime_error);
+    ThrowingCopy::s_copiesLeft = -1;
+
+    // The blocks are already sorted, but still see the old elements.
+    EXPECT_THAT(values(vec), ElementsAre(1, 2, 3, 4));
+}
@@ -0,0 +1,308 @@
+#include <local_buffered_resource.hpp>
+#include <local_buffered_allocator.hpp>
+#include <inline_vector.hpp>
+#include <flat_sequence_set.hpp>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+using namespace tr;
+
+TEST(LocalBufferedResource, default_constructed_has_nothing_in_use)
+{
+    data_structures::LocalBufferedResource<1024u> resource;
+
+    using namespace ::testing;
+    EXPECT_THAT(resource.bytes_used(), Eq(0u));
+    EXPECT_THAT(resource.upstream_resource(), Eq(std::pmr::new_delete_resource()));
+}
+
+TEST(LocalBufferedResource, allocations_are_distinct_and_aligned)
+{
+    data_structures::LocalBufferedResource<1024u> resource;
+
+    void* p1 = resource.allocate(10u, 8u);
+    void* p2 = resource.allocate(40u, 16u);
+    void* p3 = resource.allocate(1u, 1u);
+
+    using namespace ::testing;
+    EXPECT_THAT(p1, Ne(p2));
+    EXPECT_THAT(p2, Ne(p3));
+    EXPECT_THAT(reinterpret_cast<std::uintptr_t>(p1) % 8u, Eq(0u));
+    EXPECT_THAT(reinterpret_cast<std::uintptr_t>(p2) % 16u, Eq(0u));
+    EXPECT_THAT(static_cast<std::byte*>(p2), Ge(static_cast<std::byte*>(p1) + 10));
+    EXPECT_THAT(static_cast<std::byte*>(p3), Ge(static_cast<std::byte*>(p2) + 40));
+}
+
+TEST(LocalBufferedResource, honours_over_alignment)
+{
+    data_structures::LocalBufferedResource<4096u, 16u> resource;
+
+    void* p1 = resource.allocate(1u, 16u);
+    void* p2 = resource.allocate(100u, 256u);
+    void* p3 = resource.allocate(8u, 1024u);
+
+    using namespace ::testing;
+    EXPECT_THAT(reinterpret_cast<std::uintptr_t>(p1) % 16u, Eq(0u));
+    EXPECT_THAT(reinterpret_cast<std::uintptr_t>(p2) % 256u, Eq(0u));
+    EXPECT_THAT(reinterpret_cast<std::uintptr_t>(p3) % 1024u, Eq(0u));
+}
+
+TEST(LocalBufferedResource, throws_when_exhausted_without_upstream)
+{
+    data_structures::LocalBufferedResource<256u, 16u> resource{std::pmr::null_memory_resource()};
+
+    void* p = resource.allocate(256u);
+
+    using namespace ::testing;
+    EXPECT_THAT(resource.bytes_used(), Eq(256u));
+    EXPECT_THROW((void)resource.allocate(1u), std::bad_alloc);
+    resource.deallocate(p, 256u);
+    EXPECT_THAT(resource.bytes_used(), Eq(0u));
+    EXPECT_THROW((void)resource.allocate(257u), std::bad_alloc);
+}
+
+TEST(LocalBufferedResource, spills_to_upstream_when_exhausted)
+{
+    data_structures::LocalBufferedResource<256u, 16u> resource;
+
+    void* local = resource.allocate(200u);
+    void* big = resource.allocate(4096u, 64u);
+    void* small = resource.allocate(64u);
+
+    using namespace ::testing;
+    EXPECT_THAT(resource.owns(local), Eq(true));
+    EXPECT_THAT(resource.owns(big), Eq(false));
+    EXPECT_THAT(resource.owns(small), Eq(false));
+    EXPECT_THAT(reinterpret_cast<std::uintptr_t>(big) % 64u, Eq(0u));
+    EXPECT_THAT(resource.bytes_used(), Eq(208u));
+
+    resource.deallocate(big, 4096u, 64u);
+    resource.deallocate(small, 64u);
+    resource.deallocate(local, 200u);
+    EXPECT_THAT(resource.bytes_used(), Eq(0u));
+}
+
+TEST(LocalBufferedResource, deallocated_neighbours_are_coalesced)
+{
+    data_structures::LocalBufferedResource<256u, 16u> resource{std::pmr::null_memory_resource()};
+
+    void* p1 = resource.allocate(64u);
+    void* p2 = resource.allocate(64u);
+    void* p3 = resource.allocate(64u);
+    void* p4 = resource.allocate(64u);
+
+    resource.deallocate(p2, 64u);
+    resource.deallocate(p3, 64u);
+
+    // Only the coalesced middle region is large enough
+    void* p5 = resource.allocate(128u);
+
+    using namespace ::testing;
+    EXPECT_THAT(p5, Eq(p2));
+    EXPECT_THROW((void)resource.allocate(16u), std::bad_alloc);
+
+    resource.deallocate(p1, 64u);
+    resource.deallocate(p4, 64u);
+    resource.deallocate(p5, 128u);
+    EXPECT_THAT(resource.bytes_used(), Eq(0u));
+}
+
+TEST(LocalBufferedResource, spans_multiple_bitmap_words)
+{
+    // 16-byte chunks, so 200 chunks spread over four bitmap words
+    data_structures::LocalBufferedResource<3200u, 16u> resource{std::pmr::null_memory_resource()};
+
+    std::vector<void*> ptrs;
+    for (int i = 0; i < 200; ++i)
+    {
+        ptrs.push_back(resource.allocate(16u));
+    }
+
+    using namespace ::testing;
+    EXPECT_THROW((void)resource.allocate(16u), std::bad_alloc);
+
+    // Free a run which straddles the boundary between the first two words
+    for (int i = 60; i < 70; ++i)
+    {
+        resource.deallocate(ptrs[i], 16u);
+    }
+
+    EXPECT_THAT(resource.allocate(160u), Eq(ptrs[60]));
+}
+
+TEST(LocalBufferedResource, free_runs_are_found_by_length_wherever_they_are)
+{
+    // 16-byte chunks, so 4480 chunks over 70 bitmap words
+    data_structures::LocalBufferedResource<71680u, 16u> resource{std::pmr::null_memory_resource()};
+
+    std::vector<void*> ptrs;
+    for (int i = 0; i < 4480; ++i)
+    {
+        ptrs.push_back(resource.allocate(16u));
+    }
+
+    using namespace ::testing;
+    EXPECT_THROW((void)resource.allocate(16u), std::bad_alloc);
+
+    // Holes of one, three and 41 chunks, the longest first
+    const auto free_chunks = [&](int first, int count) {
+        for (int i = first; i < first + count; ++i)
+        {
+            resource.deallocate(ptrs[i], 16u);
+        }
+    };
+    free_chunks(100, 41);
+    free_chunks(2000, 1);
+    free_chunks(4200, 3);
+
+    // 41 chunks falls part way through a size class, but the head of
+    // its own class is still long enough.
+    EXPECT_THAT(resource.allocate(16u), Eq(ptrs[2000]));
+    EXPECT_THAT(resource.allocate(48u), Eq(ptrs[4200]));
+    EXPECT_THAT(resource.allocate(41u * 16u), Eq(ptrs[100]));
+    EXPECT_THROW((void)resource.allocate(16u), std::bad_alloc);
+
+    // Runs of the same length are reused most recently freed first.
+    resource.deallocate(ptrs[4479], 16u);
+    resource.deallocate(ptrs[7], 16u);
+    EXPECT_THAT(resource.allocate(16u), Eq(ptrs[7]));
+    EXPECT_THAT(resource.allocate(16u), Eq(ptrs[4479]));
+    EXPECT_THAT(resource.bytes_used(), Eq(71680u));
+}
+
+TEST(LocalBufferedResource, over_aligned_requests_give_back_their_padding)
+{
+    data_structures::LocalBufferedResource<4096u, 16u> resource{std::pmr::null_memory_resource()};
+
+    void* p1 = resource.allocate(16u);
+    void* p2 = resource.allocate(100u, 256u);
+    void* p3 = resource.allocate(16u);
+
+    using namespace ::testing;
+    EXPECT_THAT(reinterpret_cast<std::uintptr_t>(p2) % 256u, Eq(0u));
+    EXPECT_THAT(resource.bytes_used(), Eq(16u + 112u + 16u));
+
+    resource.deallocate(p2, 100u, 256u);
+    resource.deallocate(p1, 16u);
+    resource.deallocate(p3, 16u);
+    EXPECT_THAT(resource.bytes_used(), Eq(0u));
+
+    // Everything has merged back into a single run.
+    void* all = resource.allocate(4096u);
+    EXPECT_THAT(resource.owns(all), Eq(true));
+    resource.deallocate(all, 4096u);
+}
+
+TEST(LocalBufferedResource, backs_an_inline_vector)
+{
+    using Resource = data_structures::LocalBufferedResource<4096u>;
+    using Alloc = data_structures::LocalBufferedAllocator<int, Resource>;
+
+    constexpr std::array<int, 3u> arr1 = {-1, 0, 1};
+    constexpr std::array<int, 5u> arr2 = {10, 20, 30, 40, -50};
+
+    Resource resource;
+    data_structures::inline_vector<int, Alloc> vec{Alloc{&resource}};
+
+    vec.push_back_range(arr1);
+    vec.push_back_range(arr2);
+
+    using namespace ::testing;
+    EXPECT_THAT(resource.bytes_used(), Gt(0u));
+    EXPECT_THAT(vec, ElementsAre(ElementsAre(-1, 0, 1), ElementsAre(10, 20, 30, 40, -50)));
+}
+
+TEST(LocalBufferedResource, try_expand_grows_into_free_chunks)
+{
+    data_structures::LocalBufferedResource<1024u, 16u> resource;
+
+    void* p = resource.allocate(32u, 16u);
+    void* q = resource.allocate(32u, 16u);
+    resource.deallocate(q, 32u, 16u);
+
+    using namespace ::testing;
+    ASSERT_THAT(resource.try_expand(p, 32u, 64u), Eq(true));
+    EXPECT_THAT(resource.bytes_used(), Eq(64u));
+
+    // The chunks after `p` are now taken, so the next allocation
+    // lands after them.
+    q = resource.allocate(16u, 16u);
+    EXPECT_THAT(q, Eq(static_cast<std::byte*>(p) + 64));
+    EXPECT_THAT(resource.try_expand(p, 64u, 80u), Eq(false));
+    EXPECT_THAT(resource.try_expand(p, 64u, 48u), Eq(true));
+    EXPECT_THAT(resource.try_expand(p, 64u, 2048u), Eq(false));
+
+    int upstream = 0;
+    EXPECT_THAT(resource.try_expand(&upstream, sizeof(int), 2u * sizeof(int)), Eq(false));
+}
+
+TEST(LocalBufferedResource, is_a_pmr_memory_resource)
+{
+    data_structures::LocalBufferedResource<1024u> resource;
+    std::pmr::memory_resource* base = &resource;
+
+    void* p = base->allocate(32u, 16u);
+
+    using namespace ::testing;
+    EXPECT_THAT(resource.owns(p), Eq(true));
+    EXPECT_THAT(base->is_equal(resource), Eq(true));
+    EXPECT_THAT(base->is_equal(*std::pmr::new_delete_resource()), Eq(false));
+    base->deallocate(p, 32u, 16u);
+    EXPECT_THAT(resource.bytes_used(), Eq(0u));
+}
+
+TEST(LocalBufferedResource, backs_payload_and_metadata_of_pmr_containers)
+{
+    constexpr std::array<int, 3u> arr1 = {-1, 0, 1};
+    constexpr std::array<int, 5u> arr2 = {10, 20, 30, 40, -50};
+
+    data_structures::LocalBufferedResource<4096u> resource{std::pmr::null_memory_resource()};
+    {
+        data_structures::pmr::inline_vector<int> vec{&resource};
+        data_structures::pmr::flat_sequence_set<int> set{&resource};
+
+        vec.push_back_range(arr2);
+        vec.push_back_range(arr1);
+        set.insert_range(arr2);
+        set.insert_range(arr1);
+
+        using namespace ::testing;
+        EXPECT_THAT(vec, ElementsAre(ElementsAre(10, 20, 30, 40, -50), ElementsAre(-1, 0, 1)));
+        EXPECT_THAT(set, ElementsAre(ElementsAre(-1, 0, 1), ElementsAre(10, 20, 30, 40, -50)));
+        EXPECT_THAT(vec.get_allocator().resource(), Eq(&resource));
+        EXPECT_THAT(resource.bytes_used(), Gt(0u));
+    }
+
+    using namespace ::testing;
+    EXPECT_THAT(resource.bytes_used(), Eq(0u));
+}
+
+TEST(LocalBufferedResource, pmr_inline_vector_supports_uses_allocator_construction)
+{
+    constexpr std::array<int, 3u> arr = {1, 2, 3};
+
+    data_structures::LocalBufferedResource<4096u> resource{std::pmr::null_memory_resource()};
+    {
+        data_structures::pmr::inline_vector<int> source;
+        source.push_back_range(arr);
+
+        std::pmr::vector<data_structures::pmr::inline_vector<int>> outer{&resource};
+        outer.reserve(2u);
+        outer.push_back(source);
+        outer.push_back(std::move(source));
+
+        using namespace ::testing;
+        EXPECT_THAT(outer[0].get_allocator().resource(), Eq(&resource));
+        EXPECT_THAT(outer[1].get_allocator().resource(), Eq(&resource));
+        EXPECT_THAT(outer[0], ElementsAre(ElementsAre(1, 2, 3)));
+        EXPECT_THAT(outer[1], ElementsAre(ElementsAre(1, 2, 3)));
+    }
+
+    using namespace ::testing;
+    EXPECT_THAT(resource.bytes_used(), Eq(0u));
+}
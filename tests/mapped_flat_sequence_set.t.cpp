@@ -0,0 +1,141 @@
+#include <mapped_flat_sequence_set.hpp>
+#include <flat_sequence_set.hpp>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <array>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+using namespace tr;
+
+namespace {
+
+std::string temporary_path(const char* name)
+{
+    return ::testing::TempDir() + "mapped_flat_sequence_set_" + name;
+}
+
+} // close anonymous namespace
+
+TEST(MappedFlatSequenceSet, maps_what_was_written)
+{
+    constexpr std::array<int, 3u> arr1 = {2, 0, 1};
+    constexpr std::array<int, 2u> arr2 = {1, 5};
+    constexpr std::array<int, 1u> arr3 = {-7};
+    data_structures::flat_sequence_set<int> set;
+    set.insert_range(arr1);
+    set.insert_range(arr2);
+    set.insert_range({});
+    set.insert_range(arr3);
+
+    const std::string path = temporary_path("written");
+    data_structures::write_mapped_flat_sequence_set(path.c_str(), set);
+    const data_structures::mapped_flat_sequence_set<int> mapped{path.c_str()};
+
+    using namespace ::testing;
+    ASSERT_THAT(mapped.num_ranges(), Eq(4u));
+    EXPECT_THAT(mapped.size(), Eq(6u));
+    EXPECT_THAT(mapped, ElementsAre(ElementsAre(), ElementsAre(-7), ElementsAre(1, 5),
+        ElementsAre(2, 0, 1)));
+    EXPECT_THAT(mapped.back(), ElementsAreArray(arr1));
+    EXPECT_THAT(mapped.find(arr2) - mapped.begin(), Eq(2));
+    EXPECT_THAT(mapped.find(data_structures::span<const int>{arr2.data(), 1u}),
+        Eq(mapped.end()));
+    EXPECT_THROW((void)mapped.at(4u), std::out_of_range);
+
+    std::remove(path.c_str());
+}
+
+TEST(MappedFlatSequenceSet, find_batch_matches_find)
+{
+    data_structures::flat_sequence_set<char> set;
+    for (int i = 0; i < 1000; i += 3)
+    {
+        const std::string word = std::to_string(i * 7919);
+        set.insert_range({word.data(), word.size()});
+    }
+
+    const std::string path = temporary_path("batch");
+    data_structures::write_mapped_flat_sequence_set(path.c_str(), set);
+    data_structures::mapped_flat_sequence_set<char> mapped{path.c_str()};
+
+    std::vector<std::string> lookups;
+    for (int i = 0; i < 1000; ++i)
+    {
+        lookups.push_back(std::to_string(i * 7919));
+    }
+
+    using Iterator = data_structures::mapped_flat_sequence_set<char>::const_iterator;
+    std::vector<data_structures::span<const char>> keys;
+    std::vector<Iterator> expected;
+    for (const std::string& lookup : lookups)
+    {
+        keys.emplace_back(lookup.data(), lookup.size());
+        expected.push_back(mapped.find(keys.back()));
+    }
+
+    std::vector<Iterator> found(keys.size());
+    mapped.find_batch({keys.data(), keys.size()}, {found.data(), found.size()});
+
+    using namespace ::testing;
+    EXPECT_THAT(found, ElementsAreArray(expected));
+    EXPECT_THAT(std::count(found.begin(), found.end(), mapped.end()), Eq(1000 - 334));
+
+    data_structures::mapped_flat_sequence_set<char> moved{std::move(mapped)};
+    EXPECT_THAT(mapped.num_ranges(), Eq(0u));
+    EXPECT_THAT(moved.num_ranges(), Eq(334u));
+
+    std::remove(path.c_str());
+}
+
+TEST(MappedFlatSequenceSet, rejects_other_files)
+{
+    data_structures::flat_sequence_set<char> set;
+    const std::string path = temporary_path("rejects");
+    data_structures::write_mapped_flat_sequence_set(path.c_str(), set);
+
+    using namespace ::testing;
+    EXPECT_THAT(data_structures::mapped_flat_sequence_set<char>{path.c_str()}.empty(), Eq(true));
+    EXPECT_THROW(data_structures::mapped_flat_sequence_set<int>{path.c_str()},
+        std::runtime_error);
+    EXPECT_THROW(data_structures::mapped_flat_sequence_set<char>{"/nonexistent/file"},
+        std::system_error);
+
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    std::fputs("not a mapped set, but long enough to hold a header ..............", file);
+    std::fclose(file);
+    EXPECT_THROW(data_structures::mapped_flat_sequence_set<char>{path.c_str()},
+        std::runtime_error);
+
+    std::remove(path.c_str());
+}
+
+TEST(MappedFlatSequenceSet, rewriting_leaves_existing_mappings_whole)
+{
+    constexpr std::array<int, 2u> arr1 = {1, 2};
+    constexpr std::array<int, 3u> arr2 = {3, 4, 5};
+    data_structures::flat_sequence_set<int> before;
+    before.insert_range(arr1);
+    data_structures::flat_sequence_set<int> after;
+    after.insert_range(arr2);
+    after.insert_range(arr1);
+
+    const std::string path = temporary_path("rewritten");
+    data_structures::write_mapped_flat_sequence_set(path.c_str(), before);
+    const data_structures::mapped_flat_sequence_set<int> old{path.c_str()};
+
+    data_structures::write_mapped_flat_sequence_set(path.c_str(), after);
+    const data_structures::mapped_flat_sequence_set<int> rewritten{path.c_str()};
+
+    using namespace ::testing;
+    EXPECT_THAT(old, ElementsAre(ElementsAreArray(arr1)));
+    EXPECT_THAT(rewritten, ElementsAre(ElementsAreArray(arr1), ElementsAreArray(arr2)));
+    EXPECT_THAT(std::fopen((path + ".tmp").c_str(), "rb"), IsNull());
+
+    std::remove(path.c_str());
+}
@@ -0,0 +1,112 @@
+#include <mapped_memory_resource.hpp>
+#include <local_buffered_allocator.hpp>
+#include <inline_vector.hpp>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <cstdint>
+#include <cstring>
+
+using namespace tr;
+
+namespace {
+
+constexpr std::size_t MiB = 1024u * 1024u;
+
+} // close unnamed namespace
+
+TEST(MappedMemoryResource, small_requests_go_upstream)
+{
+    data_structures::MappedMemoryResource resource{64u * MiB, 1u * MiB};
+
+    void* p = resource.allocate(100u);
+
+    using namespace ::testing;
+    EXPECT_THAT(resource.try_expand(p, 100u, 200u), Eq(false));
+    resource.deallocate(p, 100u);
+}
+
+TEST(MappedMemoryResource, large_requests_are_committed_in_huge_pages)
+{
+    data_structures::MappedMemoryResource resource{64u * MiB, 1u * MiB};
+
+    auto* p = static_cast<char*>(resource.allocate(3u * MiB, 64u));
+    std::memset(p, 0x5a, 3u * MiB);
+
+    using namespace ::testing;
+    EXPECT_THAT(reinterpret_cast<std::uintptr_t>(p) % (2u * MiB), Eq(0u));
+    EXPECT_THAT(resource.committed_bytes(p), Eq(4u * MiB));
+    resource.deallocate(p, 3u * MiB, 64u);
+}
+
+TEST(MappedMemoryResource, try_expand_commits_within_the_reservation)
+{
+    data_structures::MappedMemoryResource resource{16u * MiB, 1u * MiB};
+
+    auto* p = static_cast<char*>(resource.allocate(2u * MiB));
+    p[0] = 'a';
+
+    using namespace ::testing;
+    ASSERT_THAT(resource.try_expand(p, 2u * MiB, 9u * MiB), Eq(true));
+    EXPECT_THAT(resource.committed_bytes(p), Eq(10u * MiB));
+
+    // Go through a fresh pointer, as the compiler believes `p` only
+    // points at the originally requested number of bytes.
+    char* volatile expanded = p;
+    expanded[9u * MiB - 1u] = 'z';
+    EXPECT_THAT(expanded[0], Eq('a'));
+    resource.deallocate(p, 9u * MiB);
+}
+
+TEST(MappedMemoryResource, try_expand_past_the_reservation_needs_adjacent_space)
+{
+    data_structures::MappedMemoryResource resource{16u * MiB, 1u * MiB};
+
+    auto* p = static_cast<char*>(resource.allocate(2u * MiB));
+    p[0] = 'a';
+
+    // Whether the address space after the mapping is free is up to
+    // the kernel, but either way the allocation must stay intact.
+    using namespace ::testing;
+    if (resource.try_expand(p, 2u * MiB, 17u * MiB))
+    {
+        EXPECT_THAT(resource.committed_bytes(p), Ge(17u * MiB));
+
+        char* volatile expanded = p;
+        expanded[17u * MiB - 1u] = 'z';
+        EXPECT_THAT(expanded[17u * MiB - 1u], Eq('z'));
+    }
+    else
+    {
+        EXPECT_THAT(resource.committed_bytes(p), Eq(2u * MiB));
+    }
+
+    EXPECT_THAT(p[0], Eq('a'));
+    resource.deallocate(p, 2u * MiB);
+}
+
+TEST(MappedMemoryResource, inline_vector_grows_without_relocating)
+{
+    using Alloc = data_structures::LocalBufferedAllocator<char,
+        data_structures::MappedMemoryResource>;
+
+    constexpr std::array<char, 5u> arr = {'h', 'e', 'l', 'l', 'o'};
+
+    data_structures::MappedMemoryResource resource{64u * MiB, 1u * MiB};
+    data_structures::inline_vector<char, Alloc> vec{Alloc{&resource}};
+
+    vec.reserve(1u * MiB);
+    vec.push_back_range(arr);
+    const char* first = vec.front().data();
+
+    while (vec.size() < 8u * MiB)
+    {
+        vec.push_back_range(arr);
+    }
+
+    using namespace ::testing;
+    EXPECT_THAT(vec.front().data(), Eq(first));
+    EXPECT_THAT(vec.front(), ElementsAre('h', 'e', 'l', 'l', 'o'));
+    EXPECT_THAT(vec.back(), ElementsAre('h', 'e', 'l', 'l', 'o'));
+}
@@ -0,0 +1,129 @@
+#include <monotonic_arena_resource.hpp>
+#include <local_buffered_allocator.hpp>
+#include <inline_vector.hpp>
+#include <flat_sequence_set.hpp>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <cstdint>
+
+using namespace tr;
+
+TEST(MonotonicArenaResource, allocations_are_sequential_and_aligned)
+{
+    data_structures::MonotonicArenaResource arena{4096u};
+
+    auto* p1 = static_cast<std::byte*>(arena.allocate(3u, 1u));
+    auto* p2 = static_cast<std::byte*>(arena.allocate(8u, 8u));
+    auto* p3 = static_cast<std::byte*>(arena.allocate(16u, 64u));
+
+    using namespace ::testing;
+    EXPECT_THAT(p2, Ge(p1 + 3));
+    EXPECT_THAT(p2, Lt(p1 + 3 + 8));
+    EXPECT_THAT(reinterpret_cast<std::uintptr_t>(p2) % 8u, Eq(0u));
+    EXPECT_THAT(reinterpret_cast<std::uintptr_t>(p3) % 64u, Eq(0u));
+    EXPECT_THAT(arena.bytes_reserved(), Eq(4096u));
+}
+
+TEST(MonotonicArenaResource, chunks_grow_geometrically)
+{
+    data_structures::MonotonicArenaResource arena{256u};
+
+    (void)arena.allocate(200u);
+    const auto first = arena.bytes_reserved();
+    (void)arena.allocate(200u);
+    const auto second = arena.bytes_reserved();
+    (void)arena.allocate(400u);
+    const auto third = arena.bytes_reserved();
+
+    using namespace ::testing;
+    EXPECT_THAT(first, Eq(256u));
+    EXPECT_THAT(second, Eq(256u + 512u));
+    EXPECT_THAT(third, Eq(256u + 512u + 1024u));
+}
+
+TEST(MonotonicArenaResource, oversized_requests_get_their_own_chunk)
+{
+    data_structures::MonotonicArenaResource arena{256u};
+
+    void* p = arena.allocate(10000u, 128u);
+
+    using namespace ::testing;
+    EXPECT_THAT(reinterpret_cast<std::uintptr_t>(p) % 128u, Eq(0u));
+    EXPECT_THAT(arena.bytes_reserved(), Ge(10000u));
+}
+
+TEST(MonotonicArenaResource, try_expand_grows_the_last_allocation)
+{
+    data_structures::MonotonicArenaResource arena{4096u};
+
+    auto* p1 = static_cast<std::byte*>(arena.allocate(64u, 8u));
+
+    using namespace ::testing;
+    ASSERT_THAT(arena.try_expand(p1, 64u, 128u), Eq(true));
+
+    auto* p2 = static_cast<std::byte*>(arena.allocate(8u, 8u));
+    EXPECT_THAT(p2, Eq(p1 + 128));
+    EXPECT_THAT(arena.try_expand(p1, 128u, 256u), Eq(false));
+    EXPECT_THAT(arena.try_expand(p2, 8u, 8192u), Eq(false));
+    EXPECT_THAT(arena.try_expand(p2, 8u, 16u), Eq(true));
+}
+
+TEST(MonotonicArenaResource, release_returns_everything_upstream)
+{
+    data_structures::MonotonicArenaResource arena{256u};
+
+    for (int i = 0; i < 100; ++i)
+    {
+        (void)arena.allocate(64u);
+    }
+    arena.release();
+
+    using namespace ::testing;
+    EXPECT_THAT(arena.bytes_reserved(), Eq(0u));
+
+    (void)arena.allocate(64u);
+    EXPECT_THAT(arena.bytes_reserved(), Eq(256u));
+}
+
+TEST(MonotonicArenaResource, allocators_advertise_monotonic)
+{
+    using Alloc = data_structures::LocalBufferedAllocator<int, data_structures::MonotonicArenaResource>;
+
+    using namespace ::testing;
+    EXPECT_THAT(data_structures::is_monotonic_v<Alloc>, Eq(true));
+    EXPECT_THAT(data_structures::is_monotonic_v<std::allocator<int>>, Eq(false));
+}
+
+TEST(MonotonicArenaResource, backs_per_request_containers)
+{
+    using Alloc = data_structures::LocalBufferedAllocator<int, data_structures::MonotonicArenaResource>;
+
+    constexpr std::array<int, 3u> arr1 = {-1, 0, 1};
+    constexpr std::array<int, 5u> arr2 = {10, 20, 30, 40, -50};
+
+    data_structures::MonotonicArenaResource arena;
+    {
+        data_structures::inline_vector<int, Alloc> vec{Alloc{&arena}};
+        data_structures::pmr::flat_sequence_set<int> set{&arena};
+
+        for (int i = 0; i < 10; ++i)
+        {
+            vec.push_back_range(arr1);
+            vec.push_back_range(arr2);
+        }
+        set.insert_range(arr2);
+        set.insert_range(arr1);
+
+        using namespace ::testing;
+        EXPECT_THAT(vec.num_ranges(), Eq(20u));
+        EXPECT_THAT(vec.back(), ElementsAre(10, 20, 30, 40, -50));
+        EXPECT_THAT(set, ElementsAre(ElementsAre(-1, 0, 1), ElementsAre(10, 20, 30, 40, -50)));
+    }
+
+    arena.release();
+
+    using namespace ::testing;
+    EXPECT_THAT(arena.bytes_reserved(), Eq(0u));
+}
@@ -0,0 +1,173 @@
+#include <parallel_ranges.hpp>
+#include <inline_vector.hpp>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <array>
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+using namespace tr;
+
+namespace {
+
+data_structures::inline_vector<int> make_ranges(const std::vector<std::size_t>& lengths)
+{
+    data_structures::inline_vector<int> ranges;
+    int next = 0;
+    for (std::size_t length : lengths)
+    {
+        std::vector<int> range(length);
+        std::iota(range.begin(), range.end(), next);
+        next += static_cast<int>(length);
+        ranges.push_back_range(range.begin(), range.end());
+    }
+    return ranges;
+}
+
+} // close anonymous namespace
+
+TEST(ParallelRanges, partition_balances_elements_rather_than_ranges)
+{
+    std::vector<std::size_t> skewed(100u, 1u);
+    skewed[0u] = 100u;
+
+    using namespace ::testing;
+    EXPECT_THAT(data_structures::balanced_partition(make_ranges({10u, 10u, 10u, 10u}), 2u),
+        ElementsAre(0u, 2u, 4u));
+    EXPECT_THAT(data_structures::balanced_partition(make_ranges(skewed), 2u),
+        ElementsAre(0u, 25u, 100u));
+    EXPECT_THAT(data_structures::balanced_partition(make_ranges({1000u, 1u}), 8u),
+        ElementsAre(0u, 1u, 2u));
+    EXPECT_THAT(data_structures::balanced_partition(make_ranges({}), 4u), ElementsAre(0u));
+}
+
+TEST(ParallelRanges, for_each_range_visits_every_range_once)
+{
+    data_structures::inline_vector<int> ranges = make_ranges({500u, 1u, 0u, 3u, 200u, 7u});
+    data_structures::ThreadPoolExecutor executor{3u};
+
+    data_structures::parallel_for_each_range(ranges, [](data_structures::span<int> range) {
+        for (int& value : range) value *= 2;
+    }, executor);
+
+    std::vector<int> values;
+    for (const auto& range : ranges)
+    {
+        values.insert(values.end(), range.begin(), range.end());
+    }
+    std::vector<int> expected(values.size());
+    std::iota(expected.begin(), expected.end(), 0);
+    std::transform(expected.begin(), expected.end(), expected.begin(),
+        [](int value) { return value * 2; });
+
+    using namespace ::testing;
+    EXPECT_THAT(values, ElementsAreArray(expected));
+}
+
+TEST(ParallelRanges, transform_ranges_writes_matching_output_ranges)
+{
+    const data_structures::inline_vector<int> input = make_ranges({3u, 0u, 1000u, 2u});
+    data_structures::inline_vector<long> output;
+    for (const auto& range : input)
+    {
+        const std::vector<long> zeros(range.length());
+        output.push_back_range(zeros.begin(), zeros.end());
+    }
+
+    data_structures::parallel_transform_ranges(input, output,
+        [](data_structures::span<int> in, data_structures::span<long> out) {
+            std::transform(in.begin(), in.end(), out.begin(),
+                [](int value) { return static_cast<long>(value) * value; });
+        });
+
+    using namespace ::testing;
+    ASSERT_THAT(output.num_ranges(), Eq(4u));
+    EXPECT_THAT(output[0u], ElementsAre(0, 1, 4));
+    EXPECT_THAT(output[1u], ElementsAre());
+    EXPECT_THAT(output[2u][999u], Eq(1002L * 1002L));
+    EXPECT_THAT(output[3u], ElementsAre(1003L * 1003L, 1004L * 1004L));
+}
+
+TEST(ParallelRanges, thread_pool_rethrows_and_stays_usable)
+{
+    data_structures::ThreadPoolExecutor executor{2u};
+
+    using namespace ::testing;
+    EXPECT_THROW(executor.bulk_execute(16u, [](std::size_t task) {
+        if (task == 7u) throw std::runtime_error{"task failed"};
+    }), std::runtime_error);
+
+    std::atomic<std::size_t> sum{0u};
+    executor.bulk_execute(100u, [&sum](std::size_t task) { sum += task; });
+    EXPECT_THAT(sum.load(), Eq(4950u));
+    EXPECT_THAT(executor.concurrency(), Eq(3u));
+}
+
+TEST(ParallelRanges, thread_pool_runs_nested_calls_inline)
+{
+    data_structures::ThreadPoolExecutor executor{2u};
+
+    // Every outer task, whichever thread runs it, submits an inner batch
+    // to the same pool, and a parallel algorithm nests inside as well.
+    std::atomic<std::size_t> sum{0u};
+    data_structures::inline_vector<int> ranges = make_ranges({3u, 0u, 5u});
+    executor.bulk_execute(8u, [&](std::size_t outer) {
+        executor.bulk_execute(4u, [&](std::size_t inner) { sum += outer * 4u + inner; });
+    });
+    data_structures::parallel_for_each_range(ranges, [&](auto) {
+        data_structures::parallel_for_each_range(ranges, [&sum](auto range) {
+            sum += range.size();
+        }, executor);
+    }, executor);
+
+    using namespace ::testing;
+    EXPECT_THAT(sum.load(), Eq(496u + 3u * 8u));
+    EXPECT_THROW(executor.bulk_execute(2u, [&executor](std::size_t) {
+        executor.bulk_execute(2u, [](std::size_t) { throw std::runtime_error{"inner"}; });
+    }), std::runtime_error);
+}
+
+TEST(ParallelRanges, sort_ranges_is_stable)
+{
+    data_structures::inline_vector<int> ranges;
+    std::vector<std::pair<int, int>> expected;
+    for (int i = 0; i < 1000; ++i)
+    {
+        const std::array<int, 2u> range = {(i * 7919) % 13, i};
+        ranges.push_back_range(range);
+        expected.emplace_back(range[0u], range[1u]);
+    }
+    std::stable_sort(expected.begin(), expected.end(),
+        [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+
+    data_structures::ThreadPoolExecutor executor{3u};
+    data_structures::parallel_sort_ranges(ranges,
+        [](data_structures::span<int> lhs, data_structures::span<int> rhs) {
+            return lhs[0u] < rhs[0u];
+        }, executor);
+
+    std::vector<std::pair<int, int>> sorted;
+    for (const auto& range : ranges)
+    {
+        sorted.emplace_back(range[0u], range[1u]);
+    }
+
+    using namespace ::testing;
+    EXPECT_THAT(sorted, ElementsAreArray(expected));
+    EXPECT_THAT(ranges[999u].data(), Eq(ranges[0u].data() + 1998));
+}
+
+TEST(ParallelRanges, sequential_executor_runs_in_order)
+{
+    data_structures::SequentialExecutor executor;
+    std::vector<std::size_t> order;
+    executor.bulk_execute(4u, [&order](std::size_t task) { order.push_back(task); });
+
+    using namespace ::testing;
+    EXPECT_THAT(order, ElementsAre(0u, 1u, 2u, 3u));
+}
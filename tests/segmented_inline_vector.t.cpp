@@ -0,0 +1,108 @@
+#include <segmented_inline_vector.hpp>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <array>
+#include <numeric>
+#include <string>
+#include <vector>
+
+using namespace tr;
+
+TEST(SegmentedInlineVector, default_constructed_is_empty_with_no_capacity)
+{
+    data_structures::segmented_inline_vector<int> vec;
+
+    using namespace ::testing;
+    EXPECT_THAT(vec.empty(), Eq(true));
+    EXPECT_THAT(vec.size(), Eq(0u));
+    EXPECT_THAT(vec.capacity(), Eq(0u));
+    EXPECT_THAT(vec.begin(), Eq(vec.end()));
+}
+
+TEST(SegmentedInlineVector, spans_stay_valid_as_the_container_grows)
+{
+    constexpr std::array<int, 3u> arr = {1, 2, 3};
+    data_structures::segmented_inline_vector<int> vec;
+    vec.push_back_range(arr);
+    const data_structures::span<int> first = vec.front();
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        vec.push_back_range(arr);
+    }
+
+    using namespace ::testing;
+    EXPECT_THAT(vec.num_ranges(), Eq(1001u));
+    EXPECT_THAT(vec.size(), Eq(3003u));
+    EXPECT_THAT(vec.front().data(), Eq(first.data()));
+    EXPECT_THAT(first, ElementsAre(1, 2, 3));
+    EXPECT_THAT(vec, Each(ElementsAre(1, 2, 3)));
+}
+
+TEST(SegmentedInlineVector, ranges_never_straddle_segments)
+{
+    std::vector<int> values(300u);
+    std::iota(values.begin(), values.end(), 0);
+
+    data_structures::segmented_inline_vector<int> vec;
+    vec.push_back_range({values.data(), 60u});
+    vec.push_back_range({values.data(), 60u});
+
+    using namespace ::testing;
+    EXPECT_THAT(vec.capacity(), Eq(64u + 128u));
+    EXPECT_THAT(vec.memory_usage().d_payloadSlackBytes, Eq(sizeof(int) * (192u - 120u)));
+    EXPECT_THAT(vec[1u].data(), Ne(vec[0u].data() + 60));
+
+    // Too long for the third segment, so that one is skipped.
+    vec.push_back_range({values.data(), 300u});
+    EXPECT_THAT(vec.capacity(), Eq(64u + 128u + 512u));
+    EXPECT_THAT(vec[2u], ElementsAreArray(values));
+}
+
+TEST(SegmentedInlineVector, erase_leaves_other_ranges_in_place)
+{
+    const std::array<std::string, 2u> arr1 = {"a string long enough to be allocated", "b"};
+    const std::array<std::string, 1u> arr2 = {"c"};
+    data_structures::segmented_inline_vector<std::string> vec;
+    vec.push_back_range(arr1);
+    vec.push_back_range(arr2);
+    vec.push_back_range(arr1);
+    const std::string* last = vec.back().data();
+
+    vec.erase_range(vec.begin() + 1);
+
+    using namespace ::testing;
+    EXPECT_THAT(vec, ElementsAre(ElementsAreArray(arr1), ElementsAreArray(arr1)));
+    EXPECT_THAT(vec.back().data(), Eq(last));
+    EXPECT_THAT(vec.size(), Eq(4u));
+
+    // The space at the back is reused, but not the hole.
+    vec.pop_back_range();
+    vec.push_back_range(arr2);
+    EXPECT_THAT(vec.back().data(), Eq(last));
+    EXPECT_THAT(vec, ElementsAre(ElementsAreArray(arr1), ElementsAreArray(arr2)));
+}
+
+TEST(SegmentedInlineVector, can_copy_and_move)
+{
+    const std::array<std::string, 2u> arr = {"a string long enough to be allocated", "b"};
+    data_structures::segmented_inline_vector<std::string> vec;
+    vec.push_back_range(arr);
+    vec.push_back_range(arr);
+
+    data_structures::segmented_inline_vector<std::string> copy{vec};
+    data_structures::segmented_inline_vector<std::string> moved{std::move(vec)};
+
+    using namespace ::testing;
+    EXPECT_THAT(vec.empty(), Eq(true));
+    EXPECT_THAT(vec.capacity(), Eq(0u));
+    EXPECT_THAT(copy, ElementsAre(ElementsAreArray(arr), ElementsAreArray(arr)));
+    EXPECT_THAT(moved, ElementsAre(ElementsAreArray(arr), ElementsAreArray(arr)));
+
+    copy.clear();
+    EXPECT_THAT(copy.capacity(), Eq(64u));
+    copy = moved;
+    EXPECT_THAT(copy, ElementsAre(ElementsAreArray(arr), ElementsAreArray(arr)));
+}
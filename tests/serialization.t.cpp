@@ -0,0 +1,204 @@
+#include <serialization.hpp>
+#include <flat_sequence_set.hpp>
+#include <inline_vector.hpp>
+#include <static_vector.hpp>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+using namespace tr;
+
+namespace {
+
+// Write the whole of `container` out, `bufferSize` bytes at a time.
+template <typename Container>
+std::vector<std::byte> write_frame(const Container& container, std::size_t bufferSize)
+{
+    data_structures::FrameWriter writer{container};
+    std::vector<std::byte> frame;
+    std::vector<std::byte> buffer(bufferSize);
+    while (!writer.done())
+    {
+        const std::size_t numWritten = writer.write({buffer.data(), buffer.size()});
+        frame.insert(frame.end(), buffer.begin(), buffer.begin() + numWritten);
+    }
+    return frame;
+}
+
+// Read `frame` into `container`, `bufferSize` bytes at a time,
+// returning how many bytes were used.
+template <typename Container>
+std::size_t read_frame(const std::vector<std::byte>& frame, Container& container,
+    std::size_t bufferSize,
+    std::size_t maxElements = std::numeric_limits<std::size_t>::max())
+{
+    data_structures::FrameReader reader{container, maxElements};
+    std::size_t numRead = 0u;
+    while (!reader.done() && numRead < frame.size())
+    {
+        const std::size_t count = std::min(bufferSize, frame.size() - numRead);
+        numRead += reader.read({frame.data() + numRead, count});
+    }
+    return numRead;
+}
+
+// Append `value` to `frame` as a varint.
+void append_varint(std::vector<std::byte>& frame, std::uint64_t value)
+{
+    do
+    {
+        const auto low = static_cast<unsigned char>(value & 0x7Fu);
+        value >>= 7u;
+        frame.push_back(std::byte{static_cast<unsigned char>(low | (value ? 0x80u : 0u))});
+    } while (value);
+}
+
+} // close anonymous namespace
+
+TEST(Serialization, inline_vector_round_trips_through_any_buffer_size)
+{
+    constexpr std::array<int, 3u> arr1 = {1, -2, 3};
+    constexpr std::array<int, 1u> arr2 = {1 << 30};
+    std::vector<int> longRange(300u, 7);
+    data_structures::inline_vector<int> vec;
+    vec.push_back_range({});
+    vec.push_back_range(arr1);
+    vec.push_back_range({longRange.data(), longRange.size()});
+    vec.push_back_range({});
+    vec.push_back_range(arr2);
+
+    const std::vector<std::byte> frame = write_frame(vec, 4096u);
+
+    using namespace ::testing;
+    // Magic, element size, 5 ranges, 304 elements (two bytes), five lengths
+    // (one of them two bytes), the payload and the checksum.
+    EXPECT_THAT(frame.size(), Eq(4u + 1u + 1u + 2u + 6u + 304u * sizeof(int) + 4u));
+
+    for (std::size_t bufferSize : {1u, 3u, 7u, 4096u})
+    {
+        EXPECT_THAT(write_frame(vec, bufferSize), ElementsAreArray(frame));
+
+        data_structures::inline_vector<int> read;
+        read.push_back_range(arr1);
+        EXPECT_THAT(read_frame(frame, read, bufferSize), Eq(frame.size()));
+        EXPECT_THAT(read, ElementsAre(ElementsAre(), ElementsAreArray(arr1),
+            ElementsAreArray(longRange), ElementsAre(), ElementsAreArray(arr2)));
+        EXPECT_THAT(read.capacity(), Eq(304u));
+    }
+}
+
+TEST(Serialization, reading_stops_at_the_end_of_the_frame)
+{
+    data_structures::inline_vector<char> empty;
+    std::vector<std::byte> frames = write_frame(empty, 16u);
+    const std::size_t firstSize = frames.size();
+
+    constexpr std::array<char, 2u> arr = {'h', 'i'};
+    data_structures::inline_vector<char> vec;
+    vec.push_back_range(arr);
+    const std::vector<std::byte> second = write_frame(vec, 16u);
+    frames.insert(frames.end(), second.begin(), second.end());
+
+    data_structures::inline_vector<char> read;
+    data_structures::FrameReader reader{read};
+
+    using namespace ::testing;
+    EXPECT_THAT(reader.read({frames.data(), frames.size()}), Eq(firstSize));
+    EXPECT_THAT(reader.done(), Eq(true));
+    EXPECT_THAT(read.num_ranges(), Eq(0u));
+
+    data_structures::FrameReader nextReader{read};
+    EXPECT_THAT(nextReader.read({frames.data() + firstSize, frames.size() - firstSize}),
+        Eq(second.size()));
+    EXPECT_THAT(read, ElementsAre(ElementsAre('h', 'i')));
+}
+
+TEST(Serialization, flat_sequence_set_and_static_vector_round_trip)
+{
+    constexpr std::array<char, 3u> arr1 = {'c', 'a', 't'};
+    constexpr std::array<char, 3u> arr2 = {'b', 'a', 't'};
+    data_structures::flat_sequence_set<char> set;
+    set.insert_range(arr1);
+    set.insert_range(arr2);
+
+    data_structures::flat_sequence_set<char> readSet;
+    read_frame(write_frame(set, 5u), readSet, 5u);
+
+    const data_structures::static_vector<long, 8u> vec = {4, 5, 6};
+    data_structures::static_vector<long, 8u> readVec = {1};
+    read_frame(write_frame(vec, 5u), readVec, 5u);
+
+    using namespace ::testing;
+    EXPECT_THAT(readSet, ElementsAre(ElementsAreArray(arr2), ElementsAreArray(arr1)));
+    EXPECT_THAT(readVec, ElementsAre(4, 5, 6));
+
+    data_structures::static_vector<long, 2u> tooSmall;
+    EXPECT_THROW(read_frame(write_frame(vec, 64u), tooSmall, 64u), std::runtime_error);
+}
+
+TEST(Serialization, malformed_frames_are_rejected)
+{
+    constexpr std::array<char, 3u> arr1 = {'c', 'a', 't'};
+    constexpr std::array<char, 3u> arr2 = {'b', 'a', 't'};
+    data_structures::inline_vector<char> vec;
+    vec.push_back_range(arr1);
+    vec.push_back_range(arr2);
+    const std::vector<std::byte> frame = write_frame(vec, 64u);
+
+    std::vector<std::byte> corrupted = frame;
+    corrupted[corrupted.size() - 6u] ^= std::byte{1u};
+    std::vector<std::byte> badMagic = frame;
+    badMagic[0u] = std::byte{0u};
+
+    data_structures::inline_vector<char> read;
+    data_structures::inline_vector<int> wrongType;
+    data_structures::flat_sequence_set<char> set;
+
+    using namespace ::testing;
+    EXPECT_THROW(read_frame(corrupted, read, 64u), std::runtime_error);
+    EXPECT_THROW(read_frame(badMagic, read, 64u), std::runtime_error);
+    EXPECT_THROW(read_frame(frame, wrongType, 64u), std::runtime_error);
+    EXPECT_THROW(read_frame(frame, set, 64u), std::runtime_error);
+}
+
+TEST(Serialization, header_counts_are_checked_before_they_are_trusted)
+{
+    constexpr std::array<char, 3u> arr = {'c', 'a', 't'};
+    data_structures::inline_vector<char> vec;
+    vec.push_back_range(arr);
+    const std::vector<std::byte> frame = write_frame(vec, 64u);
+
+    // The magic and element size, followed by `numRanges`, `numElements`
+    // and `lengths`, with no payload.
+    const auto header = [&frame](std::uint64_t numRanges, std::uint64_t numElements,
+        std::initializer_list<std::uint64_t> lengths)
+    {
+        std::vector<std::byte> corrupt(frame.begin(), frame.begin() + 5);
+        append_varint(corrupt, numRanges);
+        append_varint(corrupt, numElements);
+        for (std::uint64_t length : lengths)
+        {
+            append_varint(corrupt, length);
+        }
+        return corrupt;
+    };
+    constexpr std::uint64_t LARGE_COUNT = std::uint64_t{1u} << 63u;
+
+    data_structures::inline_vector<char> read;
+    using namespace ::testing;
+    EXPECT_THROW(read_frame(header(LARGE_COUNT, 1u, {}), read, 64u), std::runtime_error);
+    EXPECT_THROW(read_frame(header(1u, LARGE_COUNT, {}), read, 64u), std::runtime_error);
+    EXPECT_THROW(read_frame(header(3u, 2u, {LARGE_COUNT, LARGE_COUNT, 2u}), read, 64u),
+        std::runtime_error);
+    EXPECT_THROW(read_frame(frame, read, 64u, 2u), std::runtime_error);
+    EXPECT_THAT(read_frame(frame, read, 64u, 3u), Eq(frame.size()));
+    EXPECT_THAT(read, ElementsAre(ElementsAreArray(arr)));
+}
@@ -0,0 +1,116 @@
+#include <small_inline_vector.hpp>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <array>
+#include <functional>
+#include <string>
+#include <type_traits>
+
+using namespace tr;
+
+namespace {
+
+template <typename Container, typename T>
+bool is_within(const Container& cont, const T* p)
+{
+    const auto* first = reinterpret_cast<const std::byte*>(&cont);
+    const auto* position = reinterpret_cast<const std::byte*>(p);
+    return std::less_equal<>{}(first, position)
+        && std::less<>{}(position, first + sizeof(Container));
+}
+
+} // close unnamed namespace
+
+TEST(SmallInlineVector, small_contents_stay_inside_the_object)
+{
+    constexpr std::array<int, 3u> arr1 = {1, 2, 3};
+    constexpr std::array<int, 2u> arr2 = {4, 5};
+
+    data_structures::small_inline_vector<int, 16u, 4u> vec;
+    vec.push_back_range(arr1);
+    vec.push_back_range(arr2);
+
+    using namespace ::testing;
+    EXPECT_THAT(vec.is_inline(), Eq(true));
+    EXPECT_THAT(vec.capacity(), Eq(16u));
+    EXPECT_THAT(is_within(vec, vec.front().data()), Eq(true));
+    EXPECT_THAT(is_within(vec, vec.begin()), Eq(true));
+    EXPECT_THAT(vec, ElementsAre(ElementsAre(1, 2, 3), ElementsAre(4, 5)));
+}
+
+TEST(SmallInlineVector, too_many_elements_move_the_payload_to_the_heap)
+{
+    constexpr std::array<int, 3u> arr = {1, 2, 3};
+
+    data_structures::small_inline_vector<int, 8u, 8u> vec;
+    for (int i = 0; i < 3; ++i)
+    {
+        vec.push_back_range(arr);
+    }
+
+    using namespace ::testing;
+    EXPECT_THAT(vec.is_inline(), Eq(false));
+    EXPECT_THAT(is_within(vec, vec.front().data()), Eq(false));
+    EXPECT_THAT(is_within(vec, vec.begin()), Eq(true));
+    EXPECT_THAT(vec, Each(ElementsAre(1, 2, 3)));
+}
+
+TEST(SmallInlineVector, too_many_ranges_move_the_blocks_to_the_heap)
+{
+    constexpr std::array<int, 1u> arr = {7};
+
+    data_structures::small_inline_vector<int, 8u, 2u> vec;
+    for (int i = 0; i < 3; ++i)
+    {
+        vec.push_back_range(arr);
+    }
+
+    using namespace ::testing;
+    EXPECT_THAT(vec.is_inline(), Eq(false));
+    EXPECT_THAT(is_within(vec, vec.front().data()), Eq(true));
+    EXPECT_THAT(is_within(vec, vec.begin()), Eq(false));
+    EXPECT_THAT(vec, ElementsAre(ElementsAre(7), ElementsAre(7), ElementsAre(7)));
+}
+
+TEST(SmallInlineVector, copies_and_moves_use_their_own_storage)
+{
+    const std::array<std::string, 2u> arr = {"hello", "world"};
+
+    data_structures::small_inline_vector<std::string, 4u, 2u> vec;
+    vec.push_back_range(arr);
+
+    auto copy = vec;
+    auto moved = std::move(vec);
+
+    using namespace ::testing;
+    EXPECT_THAT(copy.is_inline(), Eq(true));
+    EXPECT_THAT(is_within(copy, copy.front().data()), Eq(true));
+    EXPECT_THAT(copy, ElementsAre(ElementsAre("hello", "world")));
+    EXPECT_THAT(is_within(moved, moved.front().data()), Eq(true));
+    EXPECT_THAT(moved, ElementsAre(ElementsAre("hello", "world")));
+    EXPECT_THAT(vec.empty(), Eq(true));
+
+    copy = moved;
+    EXPECT_THAT(copy, ElementsAre(ElementsAre("hello", "world")));
+}
+
+TEST(SmallInlineVector, moves_from_the_heap_are_element_wise)
+{
+    const std::array<std::string, 3u> arr = {"a", "b", "c"};
+
+    data_structures::small_inline_vector<std::string, 2u, 1u> vec;
+    vec.push_back_range(arr);
+    vec.push_back_range(arr);
+    const std::string* heapPayload = vec.front().data();
+
+    auto moved = std::move(vec);
+
+    using namespace ::testing;
+    EXPECT_THAT(moved.is_inline(), Eq(false));
+    EXPECT_THAT(moved.front().data(), Ne(heapPayload));
+    EXPECT_THAT(moved, Each(ElementsAreArray(arr)));
+    EXPECT_THAT(vec.empty(), Eq(true));
+    static_assert(!std::is_nothrow_move_constructible_v<decltype(moved)>);
+}
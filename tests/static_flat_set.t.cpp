@@ -0,0 +1,94 @@
+#include <static_flat_set.hpp>
+#include <static_flat_map.hpp>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <set>
+#include <string>
+#include <type_traits>
+
+using namespace tr;
+
+namespace {
+
+template <typename Key>
+void expect_lower_bounds_match_std()
+{
+    std::set<Key> reference;
+    data_structures::static_flat_set<Key, 64u> set;
+
+    // Include the extremes, which only sort correctly if unsigned
+    // keys are compared as unsigned.
+    const Key extremes[] = {std::numeric_limits<Key>::min(), std::numeric_limits<Key>::max()};
+    for (Key key : extremes)
+    {
+        reference.insert(key);
+        set.insert(key);
+    }
+    for (int i = 0; i < 40; ++i)
+    {
+        const auto key = static_cast<Key>(i * 37 % 101 - 50);
+        reference.insert(key);
+        set.insert(key);
+    }
+
+    using namespace ::testing;
+    ASSERT_THAT(set, ElementsAreArray(reference));
+    for (int i = -60; i < 60; ++i)
+    {
+        const auto key = static_cast<Key>(i);
+        const auto expected = std::distance(reference.begin(), reference.lower_bound(key));
+        EXPECT_THAT(set.lower_bound(key) - set.begin(), Eq(expected)) << i;
+        EXPECT_THAT(set.contains(key), Eq(reference.count(key) == 1u)) << i;
+    }
+}
+
+} // close unnamed namespace
+
+TEST(StaticFlatSet, lower_bound_matches_std_set)
+{
+    expect_lower_bounds_match_std<std::int32_t>();
+    expect_lower_bounds_match_std<std::uint32_t>();
+    expect_lower_bounds_match_std<std::int64_t>();
+    expect_lower_bounds_match_std<std::uint64_t>();
+    expect_lower_bounds_match_std<std::int16_t>();
+}
+
+TEST(StaticFlatSet, keeps_keys_sorted_and_unique)
+{
+    data_structures::static_flat_set<std::string, 8u> set = {"pear", "apple", "fig", "apple"};
+
+    using namespace ::testing;
+    EXPECT_THAT(set, ElementsAre("apple", "fig", "pear"));
+    EXPECT_THAT(set.insert("fig").second, Eq(false));
+    EXPECT_THAT(*set.insert("kiwi").first, Eq("kiwi"));
+    EXPECT_THAT(set.erase("apple"), Eq(1u));
+    EXPECT_THAT(set.erase("apple"), Eq(0u));
+    EXPECT_THAT(set, ElementsAre("fig", "kiwi", "pear"));
+    EXPECT_THAT(set.find("plum"), Eq(set.end()));
+}
+
+TEST(StaticFlatMap, keys_and_values_are_stored_apart)
+{
+    data_structures::static_flat_map<std::uint32_t, std::string, 16u> map = {
+        {30u, "thirty"}, {10u, "ten"}, {20u, "twenty"}};
+
+    static_assert(std::is_trivially_copyable_v<data_structures::static_vector<std::uint32_t, 16u>>);
+
+    using namespace ::testing;
+    EXPECT_THAT(map.keys(), ElementsAre(10u, 20u, 30u));
+    EXPECT_THAT(map.values(), ElementsAre("ten", "twenty", "thirty"));
+    EXPECT_THAT(map.find(20u), Pointee(Eq("twenty")));
+    EXPECT_THAT(map.find(25u), IsNull());
+    EXPECT_THROW((void)map.at(25u), std::out_of_range);
+
+    map[25u] = "twenty-five";
+    EXPECT_THAT(map.insert(10u, "TEN").second, Eq(false));
+    EXPECT_THAT(map.insert_or_assign(10u, "TEN").second, Eq(false));
+    EXPECT_THAT(map.erase(30u), Eq(1u));
+    EXPECT_THAT(map.keys(), ElementsAre(10u, 20u, 25u));
+    EXPECT_THAT(map.values(), ElementsAre("TEN", "twenty", "twenty-five"));
+}
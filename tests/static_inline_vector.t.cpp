@@ -0,0 +1,83 @@
+#include <static_inline_vector.hpp>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <array>
+#include <type_traits>
+
+using namespace tr;
+
+TEST(StaticInlineVector, never_throws)
+{
+    using Vec = data_structures::static_inline_vector<int, 8u, 2u>;
+
+    static_assert(std::is_nothrow_copy_constructible_v<Vec>);
+    static_assert(std::is_nothrow_move_assignable_v<Vec>);
+    static_assert(noexcept(std::declval<Vec&>().push_back_range(
+        std::declval<data_structures::span<const int>>())));
+}
+
+TEST(StaticInlineVector, try_push_back_range_reports_overflow)
+{
+    constexpr std::array<int, 3u> arr = {1, 2, 3};
+
+    data_structures::static_inline_vector<int, 8u, 4u> vec;
+
+    using namespace ::testing;
+    EXPECT_THAT(vec.try_push_back_range(arr), Eq(true));
+    EXPECT_THAT(vec.try_push_back_range(arr.cbegin(), arr.cend()), Eq(true));
+    EXPECT_THAT(vec.try_push_back_range(arr), Eq(false));
+    EXPECT_THAT(vec.size(), Eq(6u));
+    EXPECT_THAT(vec, ElementsAre(ElementsAre(1, 2, 3), ElementsAre(1, 2, 3)));
+
+    data_structures::static_inline_vector<int, 8u, 2u> fewRanges;
+    fewRanges.push_back_range(arr.cbegin(), arr.cbegin() + 1);
+    fewRanges.push_back_range(arr.cbegin(), arr.cbegin() + 1);
+    EXPECT_THAT(fewRanges.try_push_back_range(arr.cbegin(), arr.cbegin() + 1), Eq(false));
+}
+
+TEST(StaticInlineVector, can_insert_and_erase_ranges)
+{
+    constexpr std::array<int, 3u> arr1 = {1, 2, 3};
+    constexpr std::array<int, 2u> arr2 = {4, 5};
+    constexpr std::array<int, 1u> arr3 = {6};
+
+    data_structures::static_inline_vector<int, 16u, 4u> vec;
+    vec.push_back_range(arr1);
+    vec.push_back_range(arr3);
+
+    using namespace ::testing;
+    auto it = vec.insert_range(vec.begin() + 1, arr2);
+    EXPECT_THAT(*it, ElementsAre(4, 5));
+    EXPECT_THAT(vec, ElementsAre(ElementsAre(1, 2, 3), ElementsAre(4, 5), ElementsAre(6)));
+
+    EXPECT_THAT(vec.try_insert_range(vec.begin(), arr3), Eq(true));
+    EXPECT_THAT(vec.try_insert_range(vec.end(), arr3), Eq(false));
+    EXPECT_THAT(vec, ElementsAre(ElementsAre(6), ElementsAre(1, 2, 3), ElementsAre(4, 5),
+        ElementsAre(6)));
+
+    it = vec.erase_range(vec.begin() + 1, vec.begin() + 3);
+    EXPECT_THAT(*it, ElementsAre(6));
+    EXPECT_THAT(vec.size(), Eq(2u));
+    EXPECT_THAT(vec, ElementsAre(ElementsAre(6), ElementsAre(6)));
+
+    vec.pop_back_range();
+    EXPECT_THAT(vec, ElementsAre(ElementsAre(6)));
+}
+
+TEST(StaticInlineVector, copies_point_into_their_own_storage)
+{
+    constexpr std::array<int, 2u> arr = {7, 8};
+
+    data_structures::static_inline_vector<int, 4u, 2u> vec;
+    vec.push_back_range(arr);
+
+    auto copy = vec;
+    vec.clear();
+
+    using namespace ::testing;
+    EXPECT_THAT(copy.front().data(), Ne(vec.begin()->data()));
+    EXPECT_THAT(copy, ElementsAre(ElementsAre(7, 8)));
+    EXPECT_THAT(copy.memory_usage().d_payloadBytes, Eq(2u * sizeof(int)));
+}
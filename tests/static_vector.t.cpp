@@ -0,0 +1,153 @@
+#include <static_vector.hpp>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <string>
+#include <type_traits>
+
+using namespace tr;
+
+namespace {
+
+constexpr data_structures::static_vector<int, 8u> make_squares()
+{
+    data_structures::static_vector<int, 8u> vec;
+    for (int i = 4; i > 0; --i)
+    {
+        vec.insert(vec.begin(), i * i);
+    }
+    vec.erase(vec.begin() + 1);
+    vec.resize(5u, 100);
+    return vec;
+}
+
+} // close unnamed namespace
+
+TEST(StaticVector, trivial_types_give_a_trivial_container)
+{
+    using Vec = data_structures::static_vector<int, 8u>;
+
+    static_assert(std::is_trivially_copyable_v<Vec>);
+    static_assert(std::is_trivially_destructible_v<Vec>);
+    static_assert(!std::is_trivially_copyable_v<data_structures::static_vector<std::string, 8u>>);
+    static_assert(sizeof(data_structures::static_vector<std::uint8_t, 15u>) == 16u);
+
+    constexpr Vec squares = make_squares();
+    static_assert(squares.size() == 5u);
+    static_assert(squares[0] == 1 && squares[1] == 9 && squares[4] == 100);
+
+    using namespace ::testing;
+    EXPECT_THAT(squares, ElementsAre(1, 9, 16, 100, 100));
+}
+
+TEST(StaticVector, can_push_emplace_and_pop)
+{
+    data_structures::static_vector<std::string, 4u> vec;
+
+    vec.push_back("hello");
+    std::string world = "world";
+    vec.push_back(std::move(world));
+    auto& back = vec.emplace_back(3u, 'x');
+
+    using namespace ::testing;
+    EXPECT_THAT(back, Eq("xxx"));
+    EXPECT_THAT(vec, ElementsAre("hello", "world", "xxx"));
+
+    vec.pop_back();
+    EXPECT_THAT(vec, ElementsAre("hello", "world"));
+    EXPECT_THROW((void)vec.at(2u), std::out_of_range);
+}
+
+TEST(StaticVector, can_insert_and_erase)
+{
+    const std::array<std::string, 2u> arr = {"b", "c"};
+
+    data_structures::static_vector<std::string, 8u> vec = {"a", "d"};
+
+    using namespace ::testing;
+    auto it = vec.insert(vec.begin() + 1, arr.begin(), arr.end());
+    EXPECT_THAT(*it, Eq("b"));
+    EXPECT_THAT(vec, ElementsAre("a", "b", "c", "d"));
+
+    it = vec.insert(vec.end(), 2u, "e");
+    EXPECT_THAT(it, Eq(vec.begin() + 4));
+    it = vec.emplace(vec.begin(), "_");
+    EXPECT_THAT(vec, ElementsAre("_", "a", "b", "c", "d", "e", "e"));
+
+    it = vec.erase(vec.begin() + 1, vec.begin() + 3);
+    EXPECT_THAT(*it, Eq("c"));
+    EXPECT_THAT(vec, ElementsAre("_", "c", "d", "e", "e"));
+
+    vec.resize(2u);
+    EXPECT_THAT(vec, ElementsAre("_", "c"));
+}
+
+TEST(StaticVector, growing_past_capacity_throws_and_leaves_it_unchanged)
+{
+    const std::array<std::string, 2u> arr = {"d", "e"};
+
+    data_structures::static_vector<std::string, 3u> vec = {"a", "b", "c"};
+
+    using namespace ::testing;
+    EXPECT_THROW(vec.push_back("d"), std::bad_alloc);
+    EXPECT_THROW(vec.emplace_back(1u, 'd'), std::bad_alloc);
+    EXPECT_THROW(vec.emplace(vec.begin(), "d"), std::bad_alloc);
+    EXPECT_THROW(vec.insert(vec.begin(), 1u, "d"), std::bad_alloc);
+    EXPECT_THROW(vec.resize(4u), std::bad_alloc);
+    EXPECT_THAT(vec, ElementsAre("a", "b", "c"));
+
+    vec.pop_back();
+    EXPECT_THROW(vec.insert(vec.begin(), arr.begin(), arr.end()), std::bad_alloc);
+    EXPECT_THAT(vec, ElementsAre("a", "b"));
+}
+
+TEST(StaticVector, copies_moves_and_swaps_own_their_elements)
+{
+    data_structures::static_vector<std::shared_ptr<int>, 4u> vec;
+    vec.push_back(std::make_shared<int>(1));
+    vec.push_back(std::make_shared<int>(2));
+
+    auto copy = vec;
+    data_structures::static_vector<std::shared_ptr<int>, 8u> wider{vec};
+
+    using namespace ::testing;
+    EXPECT_THAT(vec[0].use_count(), Eq(3));
+
+    data_structures::static_vector<std::shared_ptr<int>, 4u> other;
+    other.push_back(std::make_shared<int>(3));
+    swap(copy, other);
+    EXPECT_THAT(copy.size(), Eq(1u));
+    EXPECT_THAT(*copy[0], Eq(3));
+    EXPECT_THAT(other.size(), Eq(2u));
+
+    auto moved = std::move(other);
+    moved = vec;
+    EXPECT_THAT(*moved[1], Eq(2));
+    EXPECT_THAT(vec == moved, Eq(true));
+
+    wider.clear();
+    EXPECT_THAT(vec[0].use_count(), Eq(2));
+}
+
+TEST(StaticVector, memory_usage_counts_unused_capacity_as_slack)
+{
+    constexpr data_structures::static_vector<int, 8u> squares = make_squares();
+    static_assert(squares.memory_usage().d_payloadBytes == 5u * sizeof(int));
+    static_assert(squares.memory_usage().d_payloadSlackBytes == 3u * sizeof(int));
+
+    data_structures::static_vector<std::string, 4u> vec;
+    vec.emplace_back("hello");
+
+    using namespace ::testing;
+    const auto usage = vec.memory_usage();
+    EXPECT_THAT(usage.d_payloadBytes, Eq(sizeof(std::string)));
+    EXPECT_THAT(usage.d_payloadSlackBytes, Eq(3u * sizeof(std::string)));
+    EXPECT_THAT(usage.d_metadataBytes, Eq(0u));
+    EXPECT_THAT(usage.d_metadataSlackBytes, Eq(0u));
+    EXPECT_THAT(usage.total(), Eq(4u * sizeof(std::string)));
+}
@@ -0,0 +1,178 @@
+#include <thread_caching_pool_resource.hpp>
+#include <local_buffered_allocator.hpp>
+#include <inline_vector.hpp>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <atomic>
+#include <cstdint>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace tr;
+
+TEST(ThreadCachingPoolResource, blocks_are_aligned_to_their_size_class)
+{
+    data_structures::ThreadCachingPoolResource pool;
+
+    void* p1 = pool.allocate(24u, 8u);
+    void* p2 = pool.allocate(100u, 64u);
+    void* p3 = pool.allocate(1u, 1u);
+
+    using namespace ::testing;
+    EXPECT_THAT(reinterpret_cast<std::uintptr_t>(p1) % 32u, Eq(0u));
+    EXPECT_THAT(reinterpret_cast<std::uintptr_t>(p2) % 128u, Eq(0u));
+    EXPECT_THAT(p3, Ne(p1));
+
+    pool.deallocate(p1, 24u, 8u);
+    pool.deallocate(p2, 100u, 64u);
+    pool.deallocate(p3, 1u, 1u);
+}
+
+TEST(ThreadCachingPoolResource, locally_freed_blocks_are_reused)
+{
+    data_structures::ThreadCachingPoolResource pool;
+
+    void* p1 = pool.allocate(48u);
+    pool.deallocate(p1, 48u);
+    void* p2 = pool.allocate(64u);
+
+    using namespace ::testing;
+    EXPECT_THAT(p2, Eq(p1));
+    pool.deallocate(p2, 64u);
+}
+
+TEST(ThreadCachingPoolResource, large_requests_bypass_the_pool)
+{
+    data_structures::ThreadCachingPoolResource pool;
+
+    void* p = pool.allocate(1u << 20u, 16u);
+
+    using namespace ::testing;
+    EXPECT_THAT(p, Ne(nullptr));
+    pool.deallocate(p, 1u << 20u, 16u);
+}
+
+TEST(ThreadCachingPoolResource, try_expand_stays_within_the_size_class)
+{
+    data_structures::ThreadCachingPoolResource pool;
+
+    void* p = pool.allocate(40u);
+
+    using namespace ::testing;
+    EXPECT_THAT(pool.try_expand(p, 40u, 64u), Eq(true));
+    EXPECT_THAT(pool.try_expand(p, 64u, 65u), Eq(false));
+
+    // Freed with its new size, the block goes back to the same class.
+    pool.deallocate(p, 64u);
+    EXPECT_THAT(pool.allocate(50u), Eq(p));
+    pool.deallocate(p, 50u);
+}
+
+TEST(ThreadCachingPoolResource, try_expand_refuses_blocks_from_upstream)
+{
+    data_structures::ThreadCachingPoolResource pool;
+
+    // Over-aligned requests go upstream at their exact size.
+    void* p = pool.allocate(100u, 16u * 1024u);
+
+    using namespace ::testing;
+    EXPECT_THAT(pool.try_expand(p, 100u, 128u), Eq(false));
+    EXPECT_THAT(pool.try_expand(p, 100u, 100u), Eq(false));
+    pool.deallocate(p, 100u, 16u * 1024u);
+}
+
+TEST(ThreadCachingPoolResource, remotely_freed_blocks_return_to_their_owner)
+{
+    data_structures::ThreadCachingPoolResource pool;
+
+    std::vector<void*> blocks;
+    for (int i = 0; i < 100; ++i)
+    {
+        blocks.push_back(pool.allocate(32u));
+    }
+
+    std::thread worker([&pool, &blocks] {
+        for (void* block : blocks)
+        {
+            pool.deallocate(block, 32u);
+        }
+    });
+    worker.join();
+
+    std::set<void*> original(blocks.begin(), blocks.end());
+    std::vector<void*> recycled;
+    for (int i = 0; i < 100; ++i)
+    {
+        recycled.push_back(pool.allocate(32u));
+    }
+
+    using namespace ::testing;
+    for (void* block : recycled)
+    {
+        EXPECT_THAT(original.count(block), Eq(1u));
+        pool.deallocate(block, 32u);
+    }
+}
+
+TEST(ThreadCachingPoolResource, cross_thread_producer_consumer)
+{
+    constexpr int NUM_PRODUCERS = 4;
+    constexpr int NUM_BLOCKS = 20000;
+
+    data_structures::ThreadCachingPoolResource pool;
+    std::vector<std::vector<std::uint64_t*>> produced(NUM_PRODUCERS);
+
+    std::vector<std::thread> producers;
+    for (int i = 0; i < NUM_PRODUCERS; ++i)
+    {
+        producers.emplace_back([&pool, &produced, i] {
+            for (int j = 0; j < NUM_BLOCKS; ++j)
+            {
+                auto* block = static_cast<std::uint64_t*>(pool.allocate(8u * (1u + j % 32u)));
+                *block = static_cast<std::uint64_t>(i) * NUM_BLOCKS + j;
+                produced[i].push_back(block);
+            }
+        });
+    }
+    for (auto& producer : producers) producer.join();
+
+    std::atomic<bool> allIntact{true};
+    std::vector<std::thread> consumers;
+    for (int i = 0; i < NUM_PRODUCERS; ++i)
+    {
+        consumers.emplace_back([&pool, &produced, &allIntact, i] {
+            for (int j = 0; j < NUM_BLOCKS; ++j)
+            {
+                auto* block = produced[i][j];
+                if (*block != static_cast<std::uint64_t>(i) * NUM_BLOCKS + j) allIntact = false;
+                pool.deallocate(block, 8u * (1u + j % 32u));
+            }
+        });
+    }
+    for (auto& consumer : consumers) consumer.join();
+
+    using namespace ::testing;
+    EXPECT_THAT(allIntact.load(), Eq(true));
+}
+
+TEST(ThreadCachingPoolResource, backs_an_inline_vector)
+{
+    using Alloc = data_structures::LocalBufferedAllocator<int,
+        data_structures::ThreadCachingPoolResource>;
+
+    constexpr std::array<int, 3u> arr = {1, 2, 3};
+
+    data_structures::ThreadCachingPoolResource pool;
+    data_structures::inline_vector<int, Alloc> vec{Alloc{&pool}};
+    for (int i = 0; i < 1000; ++i)
+    {
+        vec.push_back_range(arr);
+    }
+
+    using namespace ::testing;
+    EXPECT_THAT(vec.num_ranges(), Eq(1000u));
+    EXPECT_THAT(vec.back(), ElementsAre(1, 2, 3));
+}
@@ -0,0 +1,410 @@
+#ifndef THREAD_CACHING_POOL_RESOURCE_HPP
+#define THREAD_CACHING_POOL_RESOURCE_HPP
+
+#include <utility.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory_resource>
+#include <new>
+#include <unordered_map>
+
+namespace tr::data_structures {
+
+class ThreadCachingPoolResource : public std::pmr::memory_resource {
+    // A thread-safe pooling memory resource for workloads where
+    // memory is allocated on one thread and freed on another.
+    //
+    // Requests up to `MAX_BLOCK_SIZE` bytes are rounded up to a
+    // power-of-two size class and served from a cache owned by the
+    // calling thread, without any locking. Each cache carves its
+    // blocks out of `PAGE_SIZE`-aligned pages, and the header at the
+    // start of every page records the owning cache and size class.
+    //
+    // A block freed by its owning thread goes straight back on that
+    // thread's free list. A block freed by any other thread is pushed
+    // onto the owner's lock-free remote-free stack (many producers,
+    // one consumer), which the owner drains when its free list for a
+    // size class runs dry. Every `TRIM_INTERVAL` local frees the owner
+    // also trims its cache, returning pages with no live blocks to
+    // the upstream resource.
+    //
+    // Larger requests go directly to the upstream resource. Caches
+    // belonging to threads which have exited are only reclaimed when
+    // the resource itself is destroyed.
+
+public: // Types
+    using size_type = std::size_t;
+
+public: // Construction
+    explicit ThreadCachingPoolResource(
+        std::pmr::memory_resource* upstream = std::pmr::new_delete_resource()) noexcept;
+    ThreadCachingPoolResource(const ThreadCachingPoolResource&) = delete;
+    ~ThreadCachingPoolResource() override;
+
+public: // Assignment
+    ThreadCachingPoolResource& operator=(const ThreadCachingPoolResource&) = delete;
+
+public: // Allocation
+    // Attempt to grow the allocation at `position` from `oldBytes` to
+    // `newBytes` without moving it, which succeeds if it was carved
+    // from one of the calling thread's pages and the block it was
+    // given is already large enough. Blocks from other threads' caches
+    // or from upstream are never grown.
+    [[nodiscard]] bool try_expand(void* position, size_type oldBytes, size_type newBytes) noexcept;
+
+public: // Modifiers
+    // Collect the blocks other threads have freed back to the calling
+    // thread's cache, and release its completely unused pages.
+    void trim() noexcept;
+
+public: // Capacity
+    [[nodiscard]] size_type max_size() const noexcept;
+
+public: // Accessors
+    [[nodiscard]] std::pmr::memory_resource* upstream_resource() const noexcept;
+
+private: // memory_resource interface
+    void* do_allocate(size_type numBytes, size_type alignment) override;
+    void do_deallocate(void* position, size_type numBytes, size_type alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+private: // Helper variables
+    static constexpr size_type PAGE_SIZE = 64u * 1024u;
+    static constexpr size_type MIN_BLOCK_SIZE = 16u;
+    static constexpr size_type MAX_BLOCK_SIZE = 8u * 1024u;
+    static constexpr size_type NUM_SIZE_CLASSES = 10u;
+    static constexpr size_type TRIM_INTERVAL = 4096u;
+
+    static_assert((MIN_BLOCK_SIZE << (NUM_SIZE_CLASSES - 1u)) == MAX_BLOCK_SIZE);
+
+private: // Private Types
+    struct ThreadCache;
+
+    struct FreeBlock {
+        FreeBlock*  d_next;
+    };
+
+    struct PageHeader {
+        ThreadCache*    d_owner;
+        PageHeader*     d_next;
+        size_type       d_sizeClass;
+        size_type       d_live;     // Blocks carved from this page and not
+                                    // yet back on the owner's free list
+    };
+
+    struct ThreadCache {
+        FreeBlock*                  d_freeLists[NUM_SIZE_CLASSES] = {};
+        PageHeader*                 d_carvePages[NUM_SIZE_CLASSES] = {};
+        std::byte*                  d_carveBegin[NUM_SIZE_CLASSES] = {};
+        std::byte*                  d_carveEnd[NUM_SIZE_CLASSES] = {};
+        PageHeader*                 d_pages = nullptr;
+        std::atomic<FreeBlock*>     d_remoteFrees{nullptr};
+        size_type                   d_freesSinceTrim = 0u;
+        ThreadCache*                d_next = nullptr;
+    };
+
+private: // Helpers
+    [[nodiscard]] static size_type size_class(size_type numBytes, size_type alignment) noexcept;
+    [[nodiscard]] static PageHeader* page_of(void* position) noexcept;
+    [[nodiscard]] static std::uint64_t next_id() noexcept;
+
+    // Return the calling thread's cache for this resource, creating
+    // it if `create` is set, or `nullptr` if there is none.
+    [[nodiscard]] ThreadCache* find_cache(bool create);
+
+    void allocate_page(ThreadCache& cache, size_type sizeClass);
+    void drain_remote_frees(ThreadCache& cache) noexcept;
+    void trim(ThreadCache& cache) noexcept;
+
+private: // Members
+    std::uint64_t               d_id;
+    std::atomic<ThreadCache*>   d_caches;
+    std::pmr::memory_resource*  d_upstream;
+};
+
+// =================================================================
+// INLINE DEFINITIONS
+// =================================================================
+// Construction
+inline ThreadCachingPoolResource::ThreadCachingPoolResource(
+    std::pmr::memory_resource* upstream) noexcept
+    : d_id(next_id())
+    , d_caches(nullptr)
+    , d_upstream(upstream)
+{
+    assert(upstream);
+}
+
+inline ThreadCachingPoolResource::~ThreadCachingPoolResource()
+{
+    ThreadCache* cache = this->d_caches.load(std::memory_order_acquire);
+    while (cache)
+    {
+        while (cache->d_pages)
+        {
+            PageHeader* page = cache->d_pages;
+            cache->d_pages = page->d_next;
+            this->d_upstream->deallocate(page, PAGE_SIZE, PAGE_SIZE);
+        }
+
+        ThreadCache* next = cache->d_next;
+        delete cache;
+        cache = next;
+    }
+}
+
+// Allocation
+inline bool ThreadCachingPoolResource::try_expand(void* position, size_type oldBytes,
+    size_type newBytes) noexcept
+{
+    // Only the calling thread's own page list can be walked safely, and
+    // only a page found there has a header to read: an upstream block
+    // (such as an over-aligned one) has none, whatever its size.
+    const ThreadCache* cache = this->find_cache(false);
+    if (!position || !cache || oldBytes > MAX_BLOCK_SIZE) return false;
+
+    const PageHeader* page = page_of(position);
+    for (const PageHeader* owned = cache->d_pages; owned; owned = owned->d_next)
+    {
+        if (owned == page)
+        {
+            return newBytes <= (MIN_BLOCK_SIZE << page->d_sizeClass);
+        }
+    }
+    return false;
+}
+
+// Modifiers
+inline void ThreadCachingPoolResource::trim() noexcept
+{
+    if (ThreadCache* cache = this->find_cache(false))
+    {
+        this->trim(*cache);
+    }
+}
+
+// Capacity
+inline ThreadCachingPoolResource::size_type ThreadCachingPoolResource::max_size() const noexcept
+{
+    return std::numeric_limits<size_type>::max();
+}
+
+// Accessors
+inline std::pmr::memory_resource* ThreadCachingPoolResource::upstream_resource() const noexcept
+{
+    return this->d_upstream;
+}
+
+// memory_resource interface
+inline void* ThreadCachingPoolResource::do_allocate(size_type numBytes, size_type alignment)
+{
+    const size_type sizeClass = size_class(numBytes, alignment);
+    if (sizeClass == NUM_SIZE_CLASSES)
+    {
+        return this->d_upstream->allocate(numBytes, alignment);
+    }
+
+    ThreadCache& cache = *this->find_cache(true);
+    FreeBlock*& freeList = cache.d_freeLists[sizeClass];
+
+    if (!freeList && cache.d_remoteFrees.load(std::memory_order_relaxed))
+    {
+        this->drain_remote_frees(cache);
+    }
+
+    if (FreeBlock* block = freeList)
+    {
+        freeList = block->d_next;
+        ++page_of(block)->d_live;
+        return block;
+    }
+
+    const size_type blockSize = MIN_BLOCK_SIZE << sizeClass;
+    if (static_cast<size_type>(cache.d_carveEnd[sizeClass] - cache.d_carveBegin[sizeClass])
+        < blockSize)
+    {
+        this->allocate_page(cache, sizeClass);
+    }
+
+    void* position = cache.d_carveBegin[sizeClass];
+    cache.d_carveBegin[sizeClass] += blockSize;
+    ++cache.d_carvePages[sizeClass]->d_live;
+    return position;
+}
+
+inline void ThreadCachingPoolResource::do_deallocate(void* position, size_type numBytes,
+    size_type alignment)
+{
+    const size_type sizeClass = size_class(numBytes, alignment);
+    if (sizeClass == NUM_SIZE_CLASSES)
+    {
+        this->d_upstream->deallocate(position, numBytes, alignment);
+        return;
+    }
+
+    PageHeader* page = page_of(position);
+    ThreadCache* owner = page->d_owner;
+    FreeBlock* block = ::new (position) FreeBlock{nullptr};
+    assert(page->d_sizeClass == sizeClass);
+
+    if (owner != this->find_cache(false))
+    {
+        block->d_next = owner->d_remoteFrees.load(std::memory_order_relaxed);
+        while (!owner->d_remoteFrees.compare_exchange_weak(block->d_next, block,
+            std::memory_order_release, std::memory_order_relaxed))
+        {}
+        return;
+    }
+
+    block->d_next = owner->d_freeLists[sizeClass];
+    owner->d_freeLists[sizeClass] = block;
+    --page->d_live;
+
+    if (++owner->d_freesSinceTrim == TRIM_INTERVAL)
+    {
+        this->trim(*owner);
+    }
+}
+
+inline bool ThreadCachingPoolResource::do_is_equal(
+    const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
+
+// Helpers
+inline ThreadCachingPoolResource::size_type ThreadCachingPoolResource::size_class(
+    size_type numBytes, size_type alignment) noexcept
+{
+    const size_type required = std::max(numBytes, alignment);
+    if (required > MAX_BLOCK_SIZE) return NUM_SIZE_CLASSES;
+
+    size_type sizeClass = 0u;
+    while ((MIN_BLOCK_SIZE << sizeClass) < required) ++sizeClass;
+    return sizeClass;
+}
+
+inline ThreadCachingPoolResource::PageHeader* ThreadCachingPoolResource::page_of(
+    void* position) noexcept
+{
+    return reinterpret_cast<PageHeader*>(
+        reinterpret_cast<std::uintptr_t>(position) & ~std::uintptr_t{PAGE_SIZE - 1u});
+}
+
+inline std::uint64_t ThreadCachingPoolResource::next_id() noexcept
+{
+    static std::atomic<std::uint64_t> s_nextId{1u};
+    return s_nextId.fetch_add(1u, std::memory_order_relaxed);
+}
+
+inline ThreadCachingPoolResource::ThreadCache* ThreadCachingPoolResource::find_cache(bool create)
+{
+    // Resources are identified by a never-reused id rather than their
+    // address, so entries left behind by destroyed resources are inert.
+    thread_local std::uint64_t t_lastId = 0u;
+    thread_local ThreadCache* t_lastCache = nullptr;
+    thread_local std::unordered_map<std::uint64_t, ThreadCache*> t_caches;
+
+    if (t_lastId == this->d_id) return t_lastCache;
+
+    ThreadCache* cache = nullptr;
+    if (auto it = t_caches.find(this->d_id); it != t_caches.end())
+    {
+        cache = it->second;
+    }
+    else if (create)
+    {
+        cache = new ThreadCache;
+        cache->d_next = this->d_caches.load(std::memory_order_relaxed);
+        while (!this->d_caches.compare_exchange_weak(cache->d_next, cache,
+            std::memory_order_release, std::memory_order_relaxed))
+        {}
+        t_caches.emplace(this->d_id, cache);
+    }
+    else
+    {
+        return nullptr;
+    }
+
+    t_lastId = this->d_id;
+    t_lastCache = cache;
+    return cache;
+}
+
+inline void ThreadCachingPoolResource::allocate_page(ThreadCache& cache, size_type sizeClass)
+{
+    void* memory = this->d_upstream->allocate(PAGE_SIZE, PAGE_SIZE);
+    PageHeader* page = ::new (memory) PageHeader{&cache, cache.d_pages, sizeClass, 0u};
+    cache.d_pages = page;
+
+    // Blocks start at the first multiple of the block size after the
+    // header, so every block is aligned to its own size.
+    const size_type blockSize = MIN_BLOCK_SIZE << sizeClass;
+    const size_type offset = ((sizeof(PageHeader) + blockSize - 1u) / blockSize) * blockSize;
+
+    cache.d_carvePages[sizeClass] = page;
+    cache.d_carveBegin[sizeClass] = static_cast<std::byte*>(memory) + offset;
+    cache.d_carveEnd[sizeClass] = static_cast<std::byte*>(memory) + PAGE_SIZE;
+}
+
+inline void ThreadCachingPoolResource::drain_remote_frees(ThreadCache& cache) noexcept
+{
+    FreeBlock* block = cache.d_remoteFrees.exchange(nullptr, std::memory_order_acquire);
+    while (block)
+    {
+        FreeBlock* next = block->d_next;
+        PageHeader* page = page_of(block);
+
+        block->d_next = cache.d_freeLists[page->d_sizeClass];
+        cache.d_freeLists[page->d_sizeClass] = block;
+        --page->d_live;
+
+        block = next;
+    }
+}
+
+inline void ThreadCachingPoolResource::trim(ThreadCache& cache) noexcept
+{
+    this->drain_remote_frees(cache);
+    cache.d_freesSinceTrim = 0u;
+
+    const auto releasable = [&cache](PageHeader* page) noexcept {
+        return page->d_live == 0u && page != cache.d_carvePages[page->d_sizeClass];
+    };
+
+    // Unthread the free blocks which live on releasable pages...
+    for (FreeBlock*& freeList : cache.d_freeLists)
+    {
+        FreeBlock** link = &freeList;
+        while (*link)
+        {
+            if (releasable(page_of(*link))) { *link = (*link)->d_next; }
+            else                            { link = &(*link)->d_next; }
+        }
+    }
+
+    // ...and then hand the pages themselves back upstream.
+    PageHeader** link = &cache.d_pages;
+    while (*link)
+    {
+        PageHeader* page = *link;
+        if (releasable(page))
+        {
+            *link = page->d_next;
+            this->d_upstream->deallocate(page, PAGE_SIZE, PAGE_SIZE);
+        }
+        else
+        {
+            link = &page->d_next;
+        }
+    }
+}
+
+} // close namespace tr::data_structures
+
+#endif // THREAD_CACHING_POOL_RESOURCE_HPP
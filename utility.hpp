@@ -2,6 +2,8 @@
 #define UTILITY_HPP
 
 #include <utility>
+#include <cstddef>
+#include <cstdint>
 #include <iterator>
 #include <memory>
 #include <new>
@@ -60,6 +62,40 @@ using at_least_input_iterator_t = typename at_least_input_iterator<Iterator>::ty
 template <typename Iterator>
 inline constexpr bool at_least_input_iterator_v = at_least_input_iterator<Iterator>::value;
 
+// Check to see if an allocator (or memory resource) is monotonic, i.e.
+// its `deallocate` does nothing and memory is reclaimed all at once.
+// Types opt in by declaring `static constexpr bool is_monotonic = true`.
+template <typename Alloc, typename = void>
+struct is_monotonic : std::false_type {};
+
+template <typename Alloc>
+struct is_monotonic<Alloc, std::enable_if_t<Alloc::is_monotonic>> : std::true_type {};
+
+template <typename Alloc>
+inline constexpr bool is_monotonic_v = is_monotonic<Alloc>::value;
+
+// Check to see if an allocator can grow an existing allocation in
+// place, through a `bool try_expand(pointer p, size_type old_n, size_type new_n)`
+// member which returns whether `p` now has room for `new_n` objects.
+template <typename Alloc>
+using try_expand_t = decltype(std::declval<Alloc&>().try_expand(
+    std::declval<typename std::allocator_traits<Alloc>::pointer>(),
+    std::declval<typename std::allocator_traits<Alloc>::size_type>(),
+    std::declval<typename std::allocator_traits<Alloc>::size_type>()));
+
+template <typename Alloc>
+inline constexpr bool has_try_expand_v = is_detected_v<try_expand_t, Alloc>;
+
+// The same check for memory resources (and the `Buffer` of a
+// `LocalBufferedAllocator`), which work in bytes rather than objects:
+// `bool try_expand(void* p, std::size_t old_bytes, std::size_t new_bytes)`.
+template <typename Resource>
+using resource_try_expand_t = decltype(std::declval<Resource&>().try_expand(
+    std::declval<void*>(), std::declval<std::size_t>(), std::declval<std::size_t>()));
+
+template <typename Resource>
+inline constexpr bool has_resource_try_expand_v = is_detected_v<resource_try_expand_t, Resource>;
+
 // Version of uninitialized_copy which takes into account the allocator
 // `construct` function:
 template <typename InputIt, typename FwdIt, typename Allocator>
@@ -87,6 +123,7 @@ inline void safe_uninitialized_copy(InputIt first, InputIt last,
                 std::allocator_traits<Allocator>::destroy(alloc, std::addressof(*output));
                 ++output;
             }
+            throw;
         }
     }
 }
@@ -137,6 +174,49 @@ constexpr auto back_range_inserter(Container& container) noexcept
     return { container };
 }
 
+// Bit manipulation helpers. These forward to the compiler intrinsics
+// which lower to a single `tzcnt`/`lzcnt` (or equivalent) instruction.
+// The result of either function for `0` is undefined.
+inline int count_trailing_zeros(std::uint64_t word) noexcept
+{
+    return __builtin_ctzll(word);
+}
+
+inline int count_leading_zeros(std::uint64_t word) noexcept
+{
+    return __builtin_clzll(word);
+}
+
+// Hint that the memory at `address` will be read soon, so that the
+// cache miss can overlap with other work. This never faults.
+inline void prefetch(const void* address) noexcept
+{
+    __builtin_prefetch(address);
+}
+
+// The smallest unsigned integer type which can hold `N`.
+template <std::size_t N>
+using smallest_unsigned_t =
+    std::conditional_t<(N <= UINT8_MAX), std::uint8_t,
+    std::conditional_t<(N <= UINT16_MAX), std::uint16_t,
+    std::conditional_t<(N <= UINT32_MAX), std::uint32_t, std::uint64_t>>>;
+
+// Breakdown of the memory held by a container, in bytes. Payload
+// is the memory holding the elements themselves and metadata is any
+// bookkeeping alongside them (such as the blocks of an `inline_vector`).
+// The slack figures are memory which has been reserved but is unused.
+struct MemoryUsage {
+    std::size_t d_payloadBytes;
+    std::size_t d_payloadSlackBytes;
+    std::size_t d_metadataBytes;
+    std::size_t d_metadataSlackBytes;
+
+    constexpr std::size_t total() const noexcept
+    {
+        return d_payloadBytes + d_payloadSlackBytes + d_metadataBytes + d_metadataSlackBytes;
+    }
+};
+
 } // close namespace tr::data_structures
 
 #endif // UTILITY_HPP
\ No newline at end of file